@@ -12,6 +12,7 @@ public:
 	ApplicationObject(TargetWindow& window) : app(window), debugWindow(app.renderSystem)
 	{
 		app.initialize(window);
+		app.simulate = [this](float timeSinceLastFrame) { app.physicsMgr.update(timeSinceLastFrame); };
 
 		freeCamera.bind(window);
 		camera.setPosition(XMFLOAT3(0, 0, -14.f));
@@ -30,8 +31,6 @@ public:
 	{
 		app.beginRendering([this](float timeSinceLastFrame)
 			{
-				app.physicsMgr.update(timeSinceLastFrame);
-
 				InputHandler::consumeInput(*this);
 
 				freeCamera.update(timeSinceLastFrame);
@@ -41,6 +40,11 @@ public:
 					app.resources.materials.reloadChangedShaders();
 					debugWindow.state.reloadShaders = false;
 				}
+				if (debugWindow.state.dumpCompositorGraph)
+				{
+					app.compositor->dumpGraph("compositor.dot");
+					debugWindow.state.dumpCompositorGraph = false;
+				}
 				if (debugWindow.state.DlssMode != (int)app.renderSystem.upscale.dlss.selectedMode())
 				{
 					if (!app.renderSystem.upscale.dlss.selectMode((UpscaleMode)debugWindow.state.DlssMode))
@@ -0,0 +1,465 @@
+#include "Scene/RenderObject.h"
+#include "Scene/RenderQueue.h"
+#include "Scene/FrameParameters.h"
+#include "Scene/Camera.h"
+#include "RenderCore/CascadedShadowMaps.h"
+#include "RenderCore/RecordingGraphicsCommands.h"
+#include "Resources/Material/Material.h"
+#include "Resources/Shader/ShaderConstantsProvider.h"
+#include "Utils/CpuProfiler.h"
+#include "Utils/FrameArena.h"
+#include <dxgi1_4.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Headless run of cpu side frame work on synthetic scenes, no window is created and nothing is submitted to gpu.
+// Graphics device only backs material objects, draw commands are recorded into memory. WARP device is used without gpu
+
+static ComPtr<ID3D12Device> CreateDevice()
+{
+	ComPtr<ID3D12Device> device;
+	if (SUCCEEDED(D3D12CreateDevice(nullptr, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&device))))
+		return device;
+
+	// headless machines without gpu driver
+	ComPtr<IDXGIFactory4> factory;
+	ComPtr<IDXGIAdapter> warpAdapter;
+	if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&factory))) || FAILED(factory->EnumWarpAdapter(IID_PPV_ARGS(&warpAdapter))))
+		return nullptr;
+
+	if (FAILED(D3D12CreateDevice(warpAdapter.Get(), D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&device))))
+		return nullptr;
+
+	printf("Using WARP device\n");
+	return device;
+}
+
+struct BenchmarkConfig
+{
+	std::vector<UINT> entityCounts = { 10000, 100000, 1000000 };
+	UINT frames = 300;
+	UINT seed = 1;
+	float dynamicRatio = 0.1f;
+	float churnRatio = 0.001f;
+	std::string csv;
+};
+
+enum Stage
+{
+	StageChurn,
+	StageTransform,
+	StageCulling,
+	StageCascades,
+	StageCascadeCulling,
+	StageQueueBuild,
+	StageRenderObjects,
+	StageFrame,
+	StagesCount
+};
+
+static const char* StageNames[StagesCount] = { "Churn", "Transform", "Culling", "Cascades", "CascadeCulling", "QueueBuild", "RenderObjects", "Frame" };
+
+enum class CameraPath
+{
+	Orbit,
+	Flythrough,
+};
+
+static const char* GetPathName(CameraPath path)
+{
+	return path == CameraPath::Orbit ? "orbit" : "flythrough";
+}
+
+const float SceneExtent = 2000.f;
+
+// Material without loaded shaders, binds record null pipeline state but per object constants are filled as usual
+class BenchmarkMaterial : public MaterialInstance
+{
+public:
+
+	BenchmarkMaterial(MaterialBase& base, const MaterialRef& ref) : MaterialInstance(base, ref)
+	{
+		resources = std::make_shared<ResourcesInfo>();
+		// world matrix and few parameters
+		resources->rootBuffer.defaultData.resize(24);
+		resources->objectAutoParams.push_back({ ResourcesInfo::AutoParam::WORLD_MATRIX, 0 });
+
+		assigned = std::make_unique<AssignedMaterial>(*this, nullptr);
+		assigned->origin = this;
+	}
+
+	std::unique_ptr<AssignedMaterial> assigned;
+};
+
+struct BenchmarkMaterials
+{
+	static constexpr UINT BasesCount = 8;
+	static constexpr UINT InstancesPerBase = 16;
+
+	BenchmarkMaterials(ID3D12Device& device) : refs(BasesCount)
+	{
+		for (auto& ref : refs)
+		{
+			auto& base = bases.emplace_back(std::make_unique<MaterialBase>(device, ref));
+
+			for (UINT i = 0; i < InstancesPerBase; i++)
+				instances.emplace_back(std::make_unique<BenchmarkMaterial>(*base, ref));
+		}
+	}
+
+	// referenced by materials, not resized
+	std::vector<MaterialRef> refs;
+	std::vector<std::unique_ptr<MaterialBase>> bases;
+	std::vector<std::unique_ptr<BenchmarkMaterial>> instances;
+};
+
+class SyntheticScene
+{
+public:
+
+	SyntheticScene(UINT count, UINT seed, BenchmarkMaterials& m) : random(seed), materials(m)
+	{
+		objects.reserve(count);
+		for (UINT i = 0; i < count; i++)
+			spawn();
+	}
+
+	void spawn()
+	{
+		std::uniform_real_distribution<float> position(-SceneExtent, SceneExtent);
+		std::uniform_real_distribution<float> size(0.5f, 10.f);
+		std::uniform_int_distribution<int> flags(0, 15);
+		std::uniform_int_distribution<size_t> material(0, materials.instances.size() - 1);
+		std::uniform_int_distribution<UINT> triangles(12, 5000);
+
+		auto& obj = objects.emplace_back(std::make_unique<RenderEntity>(storage, 0));
+		obj->material = materials.instances[material(random)].get();
+		obj->geometry.indexCount = triangles(random) * 3;
+		obj->geometry.instanceCount = 1;
+
+		auto extent = size(random);
+		obj->setBoundingBox(BoundingBox({}, { extent, extent, extent }));
+
+		ObjectTransformation transformation;
+		transformation.position = { position(random), std::abs(position(random)) * 0.05f, position(random) };
+		transformation.orientation = Quaternion::CreateFromYawPitchRoll(position(random), 0, 0);
+		obj->setTransformation(transformation, true);
+
+		// some objects skip shadows or far cascades
+		auto f = flags(random);
+		if (f == 0)
+			obj->setFlag(RenderObjectFlag::NoShadow);
+		else if (f < 4)
+			obj->setFlag(RenderObjectFlag::OnlyFirstCascade);
+
+		storage.publishId(obj->getId());
+	}
+
+	// replaces random objects, keeps count
+	void churn(UINT count)
+	{
+		for (UINT i = 0; i < count && !objects.empty(); i++)
+		{
+			std::uniform_int_distribution<size_t> pick(0, objects.size() - 1);
+			auto idx = pick(random);
+			std::swap(objects[idx], objects.back());
+			objects.pop_back();
+		}
+
+		for (UINT i = 0; i < count; i++)
+			spawn();
+	}
+
+	void moveDynamic(UINT frame, float ratio)
+	{
+		const size_t dynamicCount = size_t(objects.size() * ratio);
+		const float offset = std::sin(frame * 0.05f) * 0.5f;
+
+		for (size_t i = 0; i < dynamicCount; i++)
+		{
+			auto& obj = objects[i];
+			auto pos = obj->getPosition();
+			pos.y += offset;
+			obj->setPosition(pos);
+		}
+
+		storage.updateTransformation();
+	}
+
+	RenderObjectsStorage storage;
+	std::vector<std::unique_ptr<RenderEntity>> objects;
+
+private:
+
+	std::mt19937 random;
+	BenchmarkMaterials& materials;
+};
+
+static void updateCameraPath(Camera& camera, CameraPath path, UINT frame, UINT frames)
+{
+	const float t = frame / float(frames);
+
+	if (path == CameraPath::Orbit)
+	{
+		const float angle = t * XM_2PI;
+		Vector3 position(std::cos(angle) * SceneExtent * 0.5f, 150.f, std::sin(angle) * SceneExtent * 0.5f);
+		camera.setPosition(position);
+		camera.lookAt({ 0, 0, 0 });
+	}
+	else
+	{
+		// low pass through the scene looking ahead and slightly down
+		Vector3 position(-SceneExtent + t * SceneExtent * 2, 30.f, std::sin(t * XM_2PI) * SceneExtent * 0.25f);
+		camera.setPosition(position);
+		camera.lookAt(position + Vector3(1, -0.2f, std::cos(t * XM_2PI) * 0.25f));
+	}
+
+	camera.updateMatrix();
+}
+
+struct StageTimings
+{
+	std::vector<double> samples[StagesCount];
+
+	void add(Stage stage, uint64_t start, uint64_t end)
+	{
+		samples[stage].push_back((end - start) / 1e6);
+	}
+};
+
+struct StageReport
+{
+	double average{};
+	double p50{};
+	double p95{};
+	double p99{};
+	double max{};
+};
+
+static StageReport createReport(std::vector<double> samples)
+{
+	StageReport report;
+	if (samples.empty())
+		return report;
+
+	std::sort(samples.begin(), samples.end());
+
+	auto percentile = [&](double p)
+		{
+			return samples[std::min(samples.size() - 1, size_t(p * (samples.size() - 1) + 0.5))];
+		};
+
+	for (auto s : samples)
+		report.average += s;
+	report.average /= samples.size();
+
+	report.p50 = percentile(0.5);
+	report.p95 = percentile(0.95);
+	report.p99 = percentile(0.99);
+	report.max = samples.back();
+
+	return report;
+}
+
+struct SceneCounters
+{
+	uint64_t visible{};
+	uint64_t draws{};
+	UINT mismatchedFrames{};
+};
+
+static StageTimings runScene(const BenchmarkConfig& config, BenchmarkMaterials& materials, UINT entities, CameraPath path, SceneCounters& counters)
+{
+	SyntheticScene scene(entities, config.seed, materials);
+
+	Camera camera;
+	camera.setPerspectiveCamera(70, 16 / 9.f, 1.f, 10000.f);
+
+	Camera lightCamera;
+	const XMVECTORF32 lightEye = { 0.3f * 1000.f, 0.8f * 1000.f, 0.2f * 1000.f, 0.f };
+	lightCamera.lookTo(lightEye, g_XMZero);
+
+	ShadowMapCascade cascadeInfo;
+	Camera cascadeCameras[4];
+	Vector2 nearFarClip{};
+
+	RenderObjectsVisibilityData visibility;
+	RenderObjectsVisibilityData cascadeVisibility[4];
+	std::vector<UINT> filteredIds[4];
+
+	FrameParameters params;
+	RenderQueue queue;
+	RecordingGraphicsCommands commands;
+
+	StageTimings timings;
+	const UINT churnCount = UINT(entities * config.churnRatio);
+
+	for (UINT frame = 0; frame < config.frames; frame++)
+	{
+		auto frameStart = CpuProfiler::Now();
+
+		auto start = CpuProfiler::Now();
+		scene.churn(churnCount);
+		auto end = CpuProfiler::Now();
+		timings.add(StageChurn, start, end);
+
+		start = end;
+		scene.moveDynamic(frame, config.dynamicRatio);
+		end = CpuProfiler::Now();
+		timings.add(StageTransform, start, end);
+
+		updateCameraPath(camera, path, frame, config.frames);
+
+		start = CpuProfiler::Now();
+		scene.storage.updateVisibility(camera, visibility);
+		end = CpuProfiler::Now();
+		timings.add(StageCulling, start, end);
+
+		start = end;
+		cascadeInfo.update(lightCamera, camera, 1000.f, nearFarClip, 1024);
+		for (int i = 0; i < 4; i++)
+		{
+			cascadeCameras[i].lookTo(lightEye, g_XMZero);
+			cascadeCameras[i].setOrthographicProjection(cascadeInfo.matShadowProj[i]);
+		}
+		end = CpuProfiler::Now();
+		timings.add(StageCascades, start, end);
+
+		start = end;
+		for (int i = 0; i < 4; i++)
+		{
+			scene.storage.createFilteredIds(uint8_t(RenderObjectFlag::NoCascade0 << i), filteredIds[i]);
+			scene.storage.updateVisibility(cascadeCameras[i], filteredIds[i], cascadeVisibility[i]);
+		}
+		end = CpuProfiler::Now();
+		timings.add(StageCascadeCulling, start, end);
+
+		// full rebuild as when queue is created, churned entities would be updated one by one otherwise
+		start = end;
+		queue.reset();
+		scene.storage.iterateObjectRanges([&](std::span<RenderObject* const> objects)
+			{
+				queue.addObjects(objects, 0, [](RenderEntity* entity) { return static_cast<BenchmarkMaterial*>(entity->material)->assigned.get(); });
+			});
+		end = CpuProfiler::Now();
+		timings.add(StageQueueBuild, start, end);
+
+		start = end;
+		FrameArena::NextFrame();
+		params.frameIndex = frame % FrameCount;
+		params.frameCounter = frame;
+		commands.clear();
+		ShaderConstantsProvider constants(params, visibility, camera, XMUINT2(1920, 1080));
+		queue.renderObjects(constants, commands);
+		end = CpuProfiler::Now();
+		timings.add(StageRenderObjects, start, end);
+
+		timings.add(StageFrame, frameStart, end);
+
+		// every entity is queued with single instance, so each visible one has to record exactly one draw
+		uint64_t visible = 0;
+		for (auto& obj : scene.objects)
+			visible += obj->isVisible(visibility.visibility);
+		if (commands.drawsCount() != visible || commands.count(RecordingGraphicsCommands::Type::DrawIndexedInstanced) != visible)
+			counters.mismatchedFrames++;
+
+		counters.visible += visible;
+		counters.draws += commands.drawsCount();
+	}
+
+	return timings;
+}
+
+static bool parseArgs(int argc, char** argv, BenchmarkConfig& config)
+{
+	std::vector<UINT> counts;
+
+	for (int i = 1; i < argc; i++)
+	{
+		auto next = [&]() { return i + 1 < argc ? argv[++i] : ""; };
+
+		if (!strcmp(argv[i], "-frames"))
+			config.frames = std::max(1, atoi(next()));
+		else if (!strcmp(argv[i], "-seed"))
+			config.seed = atoi(next());
+		else if (!strcmp(argv[i], "-dynamic"))
+			config.dynamicRatio = float(atof(next()));
+		else if (!strcmp(argv[i], "-churn"))
+			config.churnRatio = float(atof(next()));
+		else if (!strcmp(argv[i], "-csv"))
+			config.csv = next();
+		else if (atoi(argv[i]) > 0)
+			counts.push_back(atoi(argv[i]));
+		else
+			return false;
+	}
+
+	if (!counts.empty())
+		config.entityCounts = counts;
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkConfig config;
+	if (!parseArgs(argc, argv, config))
+	{
+		printf("Usage: AaBenchmark [entities...] [-frames N] [-seed N] [-dynamic ratio] [-churn ratio] [-csv file]\n");
+		return 1;
+	}
+
+	std::ofstream csv;
+	if (!config.csv.empty())
+	{
+		csv.open(config.csv);
+		csv << "Entities,Path,Stage,AvgMs,P50Ms,P95Ms,P99Ms,MaxMs\n";
+	}
+
+	ComPtr<ID3D12Device> device = CreateDevice();
+	if (!device)
+	{
+		printf("Failed to create D3D12 device\n");
+		return 1;
+	}
+	BenchmarkMaterials materials(*device.Get());
+
+	printf("%u frames, seed %u, %.1f%% dynamic, %.2f%% churn per frame\n", config.frames, config.seed, config.dynamicRatio * 100, config.churnRatio * 100);
+
+	bool failed = false;
+
+	for (auto entities : config.entityCounts)
+	{
+		for (auto path : { CameraPath::Orbit, CameraPath::Flythrough })
+		{
+			SceneCounters counters;
+			auto timings = runScene(config, materials, entities, path, counters);
+
+			printf("\n%u entities, %s camera, %.0f visible and %.0f draws on average\n", entities, GetPathName(path), counters.visible / double(config.frames), counters.draws / double(config.frames));
+			if (counters.mismatchedFrames)
+			{
+				printf("Recorded draws differ from visible entities in %u frames\n", counters.mismatchedFrames);
+				failed = true;
+			}
+
+			printf("%-16s %10s %10s %10s %10s %10s\n", "Stage", "avg ms", "p50 ms", "p95 ms", "p99 ms", "max ms");
+
+			for (int i = 0; i < StagesCount; i++)
+			{
+				auto r = createReport(timings.samples[i]);
+				printf("%-16s %10.3f %10.3f %10.3f %10.3f %10.3f\n", StageNames[i], r.average, r.p50, r.p95, r.p99, r.max);
+
+				if (csv.is_open())
+					csv << entities << ',' << GetPathName(path) << ',' << StageNames[i] << ',' << r.average << ',' << r.p50 << ',' << r.p95 << ',' << r.p99 << ',' << r.max << '\n';
+			}
+		}
+	}
+
+	return failed ? 1 : 0;
+}
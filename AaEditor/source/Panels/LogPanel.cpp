@@ -4,7 +4,7 @@
 
 void LogPanel::draw()
 {
-	const auto& history = Logger::getHistory();
+	const auto history = Logger::getHistory();
 
 	for (int i = (int)history.size() - 1; i >= 0; i--)
 	{
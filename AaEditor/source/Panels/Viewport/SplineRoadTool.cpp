@@ -4,6 +4,7 @@
 #include "ViewportPanel.h"
 #include "App/Directories.h"
 #include "Resources/Model/BinaryModelSerialization.h"
+#include "Resources/Model/MeshletBuilder.h"
 #include "Scene/Camera.h"
 #include "Scene/RenderEntity.h"
 #include "Utils/Logger.h"
@@ -162,6 +163,8 @@ namespace
 		return { node.attribute("x").as_float(fallback.x), node.attribute("y").as_float(fallback.y), node.attribute("z").as_float(fallback.z) };
 	}
 
+	constexpr const char* RoadMaterialName = "General";
+
 	void addLayoutElement(ModelInfo& info, DXGI_FORMAT format, const char* semantic)
 	{
 		VertexLayoutElement element{};
@@ -511,7 +514,7 @@ void SplineRoadTool::buildPreview()
 	batch.Begin();
 
 	SplineConstructionCreateParams params;
-	params.materialName = "General";
+	params.materialName = RoadMaterialName;
 	params.createMeshPhysics = previewPhysics;
 	construction->regenerate(app.renderSystem, app.resources, app.renderWorld, &app.physicsMgr, batch, params);
 
@@ -763,12 +766,6 @@ bool SplineRoadTool::saveCurrentMeshModel(const std::string& path) const
 	if (!construction || construction->mesh.empty())
 		return false;
 
-	if (construction->mesh.vertices.size() > (std::numeric_limits<uint16_t>::max)())
-	{
-		Logger::logError("Cannot save spline model with more than 65535 vertices");
-		return false;
-	}
-
 	std::filesystem::create_directories(std::filesystem::path(path).parent_path());
 
 	ModelInfo info;
@@ -782,24 +779,32 @@ bool SplineRoadTool::saveCurrentMeshModel(const std::string& path) const
 	info.vertexData.assign(vertexData, vertexData + construction->mesh.vertices.size() * sizeof(SplineSweepVertex));
 
 	info.indexCount = static_cast<uint32_t>(construction->mesh.indices.size());
-	info.indices.reserve(construction->mesh.indices.size());
-	for (uint32_t index : construction->mesh.indices)
+	info.indices = construction->mesh.indices;
+
+	ModelSubmesh submesh{ 0, info.indexCount };
+	strcpy_s(submesh.material, RoadMaterialName);
+	info.submeshes.push_back(submesh);
+
+	if (construction->mesh.hasBounds)
 	{
-		if (index > (std::numeric_limits<uint16_t>::max)())
-		{
-			Logger::logError("Cannot save spline model with index larger than 65535");
-			return false;
-		}
-		info.indices.push_back(static_cast<uint16_t>(index));
+		const BoundingBoxVolume& bounds = construction->mesh.bounds;
+		info.bounds = ModelBounds{ { bounds.min.x, bounds.min.y, bounds.min.z }, { bounds.max.x, bounds.max.y, bounds.max.z } };
 	}
 
+	const auto& vertices = construction->mesh.vertices;
+	info.meshlets = MeshletBuilder::build(info.indices, &vertices.front().position.x, sizeof(SplineSweepVertex), vertices.size());
+
+	info.compress = true;
+
 	if (!BinaryModelSerialization::SaveModel(path, info))
 	{
 		Logger::logError("Failed to save spline model " + path);
 		return false;
 	}
 
-	Logger::log("Saved spline model " + path);
+	const auto& optimization = construction->mesh.optimization;
+	Logger::log(std::format("Saved spline model {} ({} meshlets, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f})", path, info.meshlets.meshlets.size(),
+		optimization.before.acmr, optimization.after.acmr, optimization.before.atvr, optimization.after.atvr));
 	return true;
 }
 
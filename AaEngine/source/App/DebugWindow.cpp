@@ -5,10 +5,17 @@
 #include "RenderCore/RenderSystem.h"
 #include "Scene/RenderWorld.h"
 #include "Resources/Material/MaterialResources.h"
+#include "Resources/Model/ModelResources.h"
+#include "Resources/DescriptorManager.h"
+#include "Resources/Textures/TextureStreaming.h"
 #include "FrameCompositor/Tasks/DebugOverlayTask.h"
 #include "Utils/SystemUtils.h"
+#include "Utils/CpuProfiler.h"
+#include "Utils/RenderStats.h"
+#include "Resources/Shader/RootSignatureCache.h"
 
 imgui::DebugWindow* instance{};
+static RenderSystem* renderSystem{};
 
 bool ImguiUsesInput()
 {
@@ -108,6 +115,7 @@ namespace imgui
 		ImGui_ImplDX12_Init(&init_info);
 
 		instance = this;
+		renderSystem = &renderer;
 	}
 
 	DebugWindow::~DebugWindow()
@@ -119,6 +127,7 @@ namespace imgui
 		srvDescHeap->Release();
 
 		instance = nullptr;
+		renderSystem = nullptr;
 	}
 
 	void DebugWindow::draw(ID3D12GraphicsCommandList* commandList, MaterialResources& materials)
@@ -167,6 +176,109 @@ namespace imgui
 // 			ImGui::SliderFloat("sideConeDistance", &state.sideConeRatioDistance.y, 0.0f, 5.f);
 		}
 
+		if (ImGui::CollapsingHeader("Compositor"))
+		{
+			if (ImGui::Button("Dump passes graph"))
+				state.dumpCompositorGraph = true;
+		}
+
+		if (ImGui::CollapsingHeader("GPU timings"))
+		{
+			auto& gpuProfiler = renderSystem->core.gpuProfiler;
+			ImGui::Checkbox("Enabled", &gpuProfiler.enabled);
+
+			if (ImGui::BeginTable("GpuTimings", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+			{
+				ImGui::TableSetupColumn("Scope");
+				ImGui::TableSetupColumn("Avg ms");
+				ImGui::TableSetupColumn("Min ms");
+				ImGui::TableSetupColumn("Max ms");
+				ImGui::TableHeadersRow();
+
+				for (auto& s : gpuProfiler.queries.getStats())
+				{
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(s.name.c_str());
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", s.averageMs);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", s.minMs);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", s.maxMs);
+				}
+				ImGui::EndTable();
+			}
+		}
+
+		if (ImGui::CollapsingHeader("Profiler"))
+		{
+			auto& profiler = CpuProfiler::Get();
+
+			if (!profiler.isCapturing())
+			{
+				if (ImGui::Button("Start cpu capture"))
+					profiler.beginCapture();
+			}
+			else if (ImGui::Button("Stop and save cpu_trace.json"))
+			{
+				profiler.endCapture();
+				profiler.exportChromeTrace("cpu_trace.json");
+			}
+		}
+
+		if (ImGui::CollapsingHeader("Render stats"))
+		{
+			auto& stats = RenderStats::Get();
+
+			for (int i = 0; i < int(RenderStat::Count); i++)
+				ImGui::Text("%s: %llu", RenderStats::GetName(RenderStat(i)), stats.get(RenderStat(i)));
+
+			if (!stats.isWritingCsv())
+			{
+				if (ImGui::Button("Start render_stats.csv"))
+					stats.beginCsv("render_stats.csv");
+			}
+			else if (ImGui::Button("Stop render_stats.csv"))
+				stats.endCsv();
+		}
+
+		if (ImGui::CollapsingHeader("Root signatures"))
+		{
+			auto stats = RootSignatureCache::Get().getStats();
+			ImGui::Text("Unique %u / requested %u", stats.unique, stats.requests);
+			ImGui::Text("Max DWORDs %u, near limit %u", stats.maxDwords, stats.nearLimit);
+
+			if (ImGui::Button("Log report"))
+				RootSignatureCache::Get().logReport();
+		}
+
+		if (ImGui::CollapsingHeader("Descriptors"))
+		{
+			auto stats = DescriptorManager::get().getStats();
+			ImGui::Text("Used %u / %u, allocated range %u", stats.used, stats.capacity, stats.allocatedRange);
+			ImGui::Text("Free holes %u, pending %u, largest free range %u", stats.free, stats.pendingFree, stats.largestFreeRange);
+
+			if (ImGui::Button("Log descriptors report"))
+				DescriptorManager::get().logReport();
+		}
+
+		if (ImGui::CollapsingHeader("Models"))
+		{
+			auto& models = ModelResources::Get();
+			ImGui::Text("Resident %uMB / budget %uMB", UINT(models.getResidentBytes() / (1024 * 1024)), UINT(models.getMemoryBudget() / (1024 * 1024)));
+
+			for (auto& group : models.getResidency())
+				ImGui::Text("%s: %u models (%u used), %.1fMB", group.name.c_str(), group.models, group.referenced, group.residentBytes / (1024.0f * 1024.0f));
+		}
+
+		if (ImGui::CollapsingHeader("Texture streaming"))
+		{
+			auto stats = TextureStreaming::Get().getStats();
+			ImGui::Text("Resident %uMB / budget %uMB", UINT(stats.residentBytes / (1024 * 1024)), UINT(stats.memoryBudget / (1024 * 1024)));
+			ImGui::Text("%u textures, %u full, %u loading", stats.textures, stats.fullyResident, stats.loading);
+		}
+
 		if (ImGui::CollapsingHeader("SSAO"))
 		{
 			ImGui::SliderFloat("Accentuation", &state.ssao.Accentuation, 0.0f, 1.f);
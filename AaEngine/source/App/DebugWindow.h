@@ -11,6 +11,7 @@ namespace imgui
 	struct DebugState
 	{
 		bool reloadShaders = false;
+		bool dumpCompositorGraph = false;
 
 		bool stopUpdatingVoxel = false;
 		Vector2 middleConeRatioDistance = { 1.05f, 1.5f };
@@ -223,7 +223,7 @@ void EntityPicker::update(ID3D12GraphicsCommandList* commandList, RenderProvider
 			auto renderables = renderWorld.getRenderables(order);
 
 			RenderObjectsVisibilityData visibilityData;
-			visibilityData.visibility.resize(renderables->objectsData.objects.size(), false);
+			visibilityData.visibility.resize(renderables->getSlotsCount(), false);
 			renderables->updateVisibility(camera, visibilityData);
 
 			renderables->iterateObjects([this, &idQueue, &visibilityData, &provider](RenderObject& obj)
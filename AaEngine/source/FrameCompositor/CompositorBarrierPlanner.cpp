@@ -0,0 +1,92 @@
+#include "FrameCompositor/CompositorBarrierPlanner.h"
+#include <algorithm>
+
+bool CompositorBarrierPlanner::IsReadState(States state)
+{
+	return state && (state & ~ReadStates) == 0;
+}
+
+CompositorBarrierPlanner::Plan CompositorBarrierPlanner::Build(const std::vector<Use>& uses, const std::vector<uint32_t>& passCommandLists)
+{
+	Plan plan;
+	plan.passes.resize(passCommandLists.size());
+
+	uint32_t resourcesCount = 0;
+	for (auto& u : uses)
+		resourcesCount = std::max(resourcesCount, u.resource + 1);
+
+	std::vector<std::vector<uint32_t>> resourceUses(resourcesCount);
+	for (uint32_t i = 0; i < uses.size(); i++)
+		resourceUses[uses[i].resource].push_back(i);
+
+	for (auto& usage : resourceUses)
+	{
+		if (usage.empty())
+			continue;
+
+		// state at frame start is where last use left it
+		auto current = uses[usage.front()].previousState;
+
+		for (size_t i = 0; i < usage.size(); i++)
+		{
+			const auto useIdx = usage[i];
+			auto& use = uses[useIdx];
+			const Use* next = (i + 1 < usage.size()) ? &uses[usage[i + 1]] : nullptr;
+
+			if (use.planned && current != use.state)
+			{
+				// already readable in needed state, skip as long as next transition is also ours
+				bool redundantRead = IsReadState(current) && IsReadState(use.state) && (current & use.state) == use.state;
+
+				if (redundantRead && next && next->planned && !use.postState)
+				{
+					plan.droppedTransitions++;
+				}
+				else
+				{
+					const Use* prev = i > 0 ? &uses[usage[i - 1]] : nullptr;
+					const auto commandList = passCommandLists[use.pass];
+
+					// resource is idle between passes recorded into same command list
+					bool split = prev && use.pass > prev->pass + 1 && commandList != NoCommandList && passCommandLists[prev->pass] == commandList;
+
+					if (split)
+					{
+						plan.passes[prev->pass].after.push_back({ useIdx, current, use.state, Split::Begin });
+						plan.passes[use.pass].before.push_back({ useIdx, current, use.state, Split::End });
+						plan.splitTransitions++;
+					}
+					else
+						plan.passes[use.pass].before.push_back({ useIdx, current, use.state });
+
+					plan.transitions++;
+					current = use.state;
+				}
+			}
+			else if (!use.planned)
+			{
+				current = use.state;
+			}
+
+			if (use.postState)
+			{
+				if (current != use.postState)
+				{
+					plan.passes[use.pass].after.push_back({ useIdx, current, use.postState });
+					plan.transitions++;
+				}
+				current = use.postState;
+			}
+			else if (!use.planned && next)
+			{
+				// pass leaves resource where next use expects it
+				current = next->previousState;
+			}
+		}
+	}
+
+	for (auto& p : plan.passes)
+		plan.batches += !p.before.empty() + !p.after.empty();
+
+	return plan;
+}
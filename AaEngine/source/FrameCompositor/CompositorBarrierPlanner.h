@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Plans texture transitions between compositor passes, independent of command recording and graphics API headers
+namespace CompositorBarrierPlanner
+{
+	// D3D12_RESOURCE_STATES bits
+	using States = uint32_t;
+	// D3D12_RESOURCE_STATE_DEPTH_READ | NON_PIXEL_SHADER_RESOURCE | PIXEL_SHADER_RESOURCE
+	constexpr States ReadStates = 0x20 | 0x40 | 0x80;
+
+	constexpr uint32_t NoCommandList = uint32_t(-1);
+
+	struct Use
+	{
+		uint32_t resource{};
+		uint32_t pass{};
+
+		// state expected at pass start and state needed by pass
+		States previousState{};
+		States state{};
+		// transition after pass, 0 when not needed
+		States postState{};
+
+		// transition to state is issued by planner, otherwise pass does it by itself
+		bool planned = false;
+	};
+
+	// split barrier halves, begin is issued after previous use and end before pass
+	enum class Split : uint8_t
+	{
+		None,
+		Begin,
+		End,
+	};
+
+	struct Barrier
+	{
+		uint32_t use{};
+		States before{};
+		States after{};
+		Split split = Split::None;
+	};
+
+	struct PassBarriers
+	{
+		// each list is issued as single ResourceBarrier call
+		std::vector<Barrier> before;
+		std::vector<Barrier> after;
+	};
+
+	struct Plan
+	{
+		std::vector<PassBarriers> passes;
+
+		uint32_t transitions{};
+		uint32_t splitTransitions{};
+		uint32_t droppedTransitions{};
+		uint32_t batches{};
+	};
+
+	// uses are in pass order, split barriers are only placed within same command list
+	Plan Build(const std::vector<Use>& uses, const std::vector<uint32_t>& passCommandLists);
+
+	bool IsReadState(States state);
+}
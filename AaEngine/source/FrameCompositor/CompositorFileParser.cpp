@@ -5,7 +5,7 @@
 
 static Compositor::UsageFlags parseFlags(const Config::Object& member)
 {
-	UINT flags = 0;
+	uint32_t flags = 0;
 	for (auto& p : member.params)
 	{
 		if (p.starts_with('(') && p.ends_with(')'))
@@ -37,10 +37,10 @@ struct ParseContext
 	std::map<std::string, std::string> textureAlias;
 };
 
-static std::vector<CompositorTextureSlot> parseCompositorTextureSlot(const Config::Object& param, const CompositorInfo& info, const ParseContext& ctx, UINT flags = 0)
+static std::vector<CompositorTextureSlot> parseCompositorTextureSlot(const Config::Object& param, const CompositorInfo& info, const ParseContext& ctx, uint32_t flags = 0)
 {
-	UINT textureFlags = parseFlags(param);
-	UINT depthFlags = textureFlags & Compositor::DepthRead;
+	uint32_t textureFlags = parseFlags(param);
+	uint32_t depthFlags = textureFlags & Compositor::DepthRead;
 	textureFlags &= ~Compositor::DepthRead;
 
 	std::vector<CompositorTextureSlot> textures;
@@ -213,6 +213,8 @@ CompositorInfo CompositorFileParser::parseFile(std::string directory, std::strin
 								formats.push_back({ {}, "Depth" });
 							else if (param.starts_with('[') && param.ends_with(']'))
 								tex.arraySize = std::stoul(param.c_str() + 1);
+							else if (param == "transient")
+								tex.transient = true;
 						}
 
 						if (formats.size() == 1)
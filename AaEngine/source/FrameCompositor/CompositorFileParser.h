@@ -5,11 +5,12 @@
 #include <vector>
 #include <set>
 #include <optional>
-#include <d3d12.h>
+#include <cstdint>
+#include <dxgiformat.h>
 
 namespace Compositor
 {
-	enum UsageFlags : UINT { PixelShader = 1, ComputeShader = 2, DepthRead = 4, Read = 8, Write = 16, WriteFirst = 32, Async = 64 };
+	enum UsageFlags : uint32_t { PixelShader = 1, ComputeShader = 2, DepthRead = 4, Read = 8, Write = 16, WriteFirst = 32, Async = 64 };
 };
 
 struct CompositorTextureInfo
@@ -20,8 +21,10 @@ struct CompositorTextureInfo
 	bool targetScale = false;
 	bool outputScale = false;
 	DXGI_FORMAT format{};
-	UINT arraySize = 1;
+	uint32_t arraySize = 1;
 	bool uav = false;
+	// only used within frame, memory can be shared with other transient textures
+	bool transient = false;
 };
 
 struct CompositorTextureSlot
@@ -0,0 +1,308 @@
+#include "FrameCompositor/CompositorGraph.h"
+#include <algorithm>
+#include <format>
+
+CompositorGraph::Graph CompositorGraph::Build(const std::vector<CompositorPassInfo>& passes)
+{
+	Graph graph;
+	graph.nodes.resize(passes.size());
+
+	std::map<std::pair<uint32_t, uint32_t>, size_t> edgeIndex;
+	auto addEdge = [&](uint32_t from, uint32_t to, EdgeType type, const std::string& label)
+		{
+			if (from == to)
+				return;
+
+			if (auto it = edgeIndex.find({ from, to }); it != edgeIndex.end())
+			{
+				auto& edge = graph.edges[it->second];
+				if (edge.label.find(label) == std::string::npos)
+					edge.label += ", " + label;
+				return;
+			}
+
+			edgeIndex[{ from, to }] = graph.edges.size();
+			graph.edges.push_back({ from, to, type, label });
+			graph.nodes[to].dependencies.push_back(from);
+		};
+
+	struct TextureAccess
+	{
+		int lastWriter = -1;
+		std::vector<uint32_t> readers;
+	};
+	std::map<std::string, TextureAccess> textures;
+	std::map<std::string, uint32_t> signals;
+
+	for (uint32_t i = 0; i < passes.size(); i++)
+	{
+		auto& pass = passes[i];
+
+		auto read = [&](const std::string& name)
+			{
+				auto& t = textures[name];
+				if (t.lastWriter >= 0)
+					addEdge(t.lastWriter, i, EdgeType::Texture, name);
+				t.readers.push_back(i);
+			};
+		auto write = [&](const std::string& name)
+			{
+				auto& t = textures[name];
+				// write after read, readers already depend on previous writer
+				for (auto r : t.readers)
+					addEdge(r, i, EdgeType::Texture, name);
+				if (t.readers.empty() && t.lastWriter >= 0)
+					addEdge(t.lastWriter, i, EdgeType::Texture, name);
+
+				t.lastWriter = i;
+				t.readers.clear();
+			};
+
+		for (auto& input : pass.inputs)
+		{
+			if (input.flags & Compositor::Read)
+				read(input.name);
+			if (input.flags & Compositor::Write)
+				write(input.name);
+		}
+		for (auto& target : pass.targets)
+		{
+			if (target.flags & Compositor::DepthRead)
+				read(target.name);
+			else
+				write(target.name);
+		}
+
+		if (!pass.after.empty())
+		{
+			for (int j = int(i) - 1; j >= 0; j--)
+			{
+				if (passes[j].name == pass.after)
+				{
+					addEdge(j, i, EdgeType::After, "after");
+					break;
+				}
+			}
+		}
+
+		for (auto& sync : pass.sync)
+		{
+			if (!sync.signal)
+			{
+				// waits for signal from previous frame are not part of graph
+				if (auto it = signals.find(sync.name); it != signals.end())
+					addEdge(it->second, i, EdgeType::Sync, sync.name);
+			}
+		}
+		for (auto& sync : pass.sync)
+		{
+			if (sync.signal)
+				signals[sync.name] = i;
+		}
+	}
+
+	UpdateSchedule(graph);
+
+	return graph;
+}
+
+void CompositorGraph::UpdateSchedule(Graph& graph)
+{
+	auto& nodes = graph.nodes;
+	graph.criticalPathCost = 0;
+	graph.criticalPath.clear();
+
+	if (nodes.empty())
+		return;
+
+	for (auto& node : nodes)
+	{
+		node.earliestStart = 0;
+		for (auto d : node.dependencies)
+			node.earliestStart = std::max(node.earliestStart, nodes[d].earliestFinish);
+
+		node.earliestFinish = node.earliestStart + node.cost;
+		graph.criticalPathCost = std::max(graph.criticalPathCost, node.earliestFinish);
+	}
+
+	for (auto& node : nodes)
+		node.latestFinish = graph.criticalPathCost;
+
+	for (size_t i = nodes.size(); i-- > 0;)
+	{
+		auto latestStart = nodes[i].latestFinish - nodes[i].cost;
+		for (auto d : nodes[i].dependencies)
+			nodes[d].latestFinish = std::min(nodes[d].latestFinish, latestStart);
+	}
+
+	// walk back from last finishing node through critical dependencies
+	uint32_t current = uint32_t(std::max_element(nodes.begin(), nodes.end(), [](const Node& a, const Node& b) { return a.earliestFinish < b.earliestFinish; }) - nodes.begin());
+	while (true)
+	{
+		graph.criticalPath.push_back(current);
+
+		auto& deps = nodes[current].dependencies;
+		auto next = std::find_if(deps.begin(), deps.end(), [&](uint32_t d) { return nodes[d].critical() && nodes[d].earliestFinish >= nodes[current].earliestStart - 1e-4f; });
+		if (next == deps.end())
+			break;
+
+		current = *next;
+	}
+	std::reverse(graph.criticalPath.begin(), graph.criticalPath.end());
+}
+
+std::vector<std::string> CompositorGraph::GetTimingNames(const std::vector<CompositorPassInfo>& passes)
+{
+	std::vector<std::string> names;
+	names.reserve(passes.size());
+
+	std::map<std::string, uint32_t> counts;
+	for (auto& pass : passes)
+	{
+		auto count = ++counts[pass.name];
+		names.push_back(count == 1 ? pass.name : std::format("{} #{}", pass.name, count));
+	}
+
+	return names;
+}
+
+uint32_t CompositorGraph::ApplyCosts(Graph& graph, const std::vector<std::string>& timingNames, const std::map<std::string, float>& measuredMs)
+{
+	uint32_t applied = 0;
+
+	for (uint32_t i = 0; i < graph.nodes.size() && i < timingNames.size(); i++)
+	{
+		if (auto it = measuredMs.find(timingNames[i]); it != measuredMs.end())
+		{
+			graph.nodes[i].cost = it->second;
+			applied++;
+		}
+	}
+
+	if (applied)
+		UpdateSchedule(graph);
+
+	return applied;
+}
+
+void CompositorGraph::SetAsync(CompositorPassInfo& pass)
+{
+	const auto asyncFlags = Compositor::ComputeShader | Compositor::Async;
+
+	pass.flags = Compositor::UsageFlags((pass.flags & ~Compositor::PixelShader) | asyncFlags);
+
+	for (auto& input : pass.inputs)
+		input.flags = Compositor::UsageFlags((input.flags & ~Compositor::PixelShader) | asyncFlags);
+	for (auto& target : pass.targets)
+		target.flags = Compositor::UsageFlags((target.flags & ~Compositor::PixelShader) | asyncFlags);
+
+	for (auto& sync : pass.sync)
+		sync.compute = true;
+}
+
+uint32_t CompositorGraph::AddMissingSync(std::vector<CompositorPassInfo>& passes)
+{
+	// follows validation in FrameCompositor::initializeTextureStates
+	struct TextureInfo
+	{
+		Compositor::UsageFlags lastFlags{};
+		uint32_t lastPass{};
+		std::set<std::string> signals;
+	};
+	std::map<std::string, TextureInfo> textures;
+	std::set<std::string> waits;
+	uint32_t added = 0;
+
+	for (uint32_t i = 0; i < passes.size(); i++)
+	{
+		auto& pass = passes[i];
+
+		for (auto& sync : pass.sync)
+		{
+			if (!sync.signal)
+				waits.insert(sync.name);
+		}
+
+		auto access = [&](const std::string& name, Compositor::UsageFlags flags)
+			{
+				auto& info = textures[name];
+
+				if (info.lastFlags && (info.lastFlags & Compositor::Async) != (flags & Compositor::Async))
+				{
+					bool isSynced = std::any_of(info.signals.begin(), info.signals.end(), [&](const std::string& s) { return waits.contains(s); });
+
+					if (!isSynced)
+					{
+						auto syncName = std::format("Auto{}", added++);
+
+						auto& producer = passes[info.lastPass];
+						producer.sync.emplace_back(syncName, true, bool(producer.flags & Compositor::Async));
+						pass.sync.emplace_back(syncName, false, bool(pass.flags & Compositor::Async));
+						waits.insert(syncName);
+					}
+
+					info.signals.clear();
+				}
+
+				info.lastFlags = flags;
+				info.lastPass = i;
+
+				for (auto& sync : pass.sync)
+				{
+					if (sync.signal)
+						info.signals.insert(sync.name);
+				}
+			};
+
+		for (auto& [name, flags] : pass.inputs)
+			access(name, flags);
+		for (auto& [name, flags] : pass.targets)
+			access(name, flags);
+
+		for (auto& sync : pass.sync)
+		{
+			if (sync.signal)
+			{
+				for (auto& t : textures)
+				{
+					if ((t.second.lastFlags & Compositor::Async) == (pass.flags & Compositor::Async))
+						t.second.signals.insert(sync.name);
+				}
+			}
+		}
+	}
+
+	return added;
+}
+
+std::string CompositorGraph::ToDot(const Graph& graph, const std::vector<CompositorPassInfo>& passes)
+{
+	std::string out = "digraph Compositor\n{\n\trankdir=LR;\n\tnode [shape=box, style=filled, fillcolor=white];\n";
+
+	for (uint32_t i = 0; i < graph.nodes.size(); i++)
+	{
+		auto& node = graph.nodes[i];
+		auto& pass = passes[i];
+
+		std::string attributes;
+		if (pass.flags & Compositor::Async)
+			attributes += ", fillcolor=lightblue";
+		if (node.critical())
+			attributes += ", color=red, penwidth=2";
+
+		auto kind = pass.material.empty() ? "task" : pass.material.c_str();
+		out += std::format("\tp{} [label=\"{}\\n{}\\ncost {:.2f} slack {:.2f}\"{}];\n", i, pass.name, kind, node.cost, node.slack(), attributes);
+	}
+
+	for (auto& edge : graph.edges)
+	{
+		const bool critical = graph.nodes[edge.from].critical() && graph.nodes[edge.to].critical();
+		auto style = edge.type == EdgeType::Sync ? ", style=dashed" : edge.type == EdgeType::After ? ", style=dotted" : "";
+
+		out += std::format("\tp{} -> p{} [label=\"{}\"{}{}];\n", edge.from, edge.to, edge.label, style, critical ? ", color=red" : "");
+	}
+
+	out += "}\n";
+
+	return out;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "FrameCompositor/CompositorFileParser.h"
+
+// Dependencies between compositor passes from texture access, explicit order and sync
+namespace CompositorGraph
+{
+	enum class EdgeType
+	{
+		Texture,
+		After,
+		Sync,
+	};
+
+	struct Edge
+	{
+		uint32_t from{};
+		uint32_t to{};
+		EdgeType type{};
+		// textures or sync names causing dependency
+		std::string label;
+	};
+
+	struct Node
+	{
+		float cost = 1;
+
+		float earliestStart{};
+		float earliestFinish{};
+		float latestFinish{};
+
+		std::vector<uint32_t> dependencies;
+
+		float slack() const { return latestFinish - earliestFinish; }
+		bool critical() const { return slack() < 1e-4f; }
+	};
+
+	struct Graph
+	{
+		std::vector<Node> nodes;
+		std::vector<Edge> edges;
+
+		float criticalPathCost{};
+		std::vector<uint32_t> criticalPath;
+	};
+
+	// passes are already in valid order, edges always go forward
+	Graph Build(const std::vector<CompositorPassInfo>& passes);
+
+	// recompute critical path after node costs changed
+	void UpdateSchedule(Graph& graph);
+
+	// unique per pass names for gpu timing, repeated pass names get " #n" suffix so their times are not summed
+	std::vector<std::string> GetTimingNames(const std::vector<CompositorPassInfo>& passes);
+
+	// measured times by timing name as node costs, nodes without samples keep their cost, returns count of updated nodes
+	uint32_t ApplyCosts(Graph& graph, const std::vector<std::string>& timingNames, const std::map<std::string, float>& measuredMs);
+
+	// move pass to async compute queue, including its texture usage and syncs
+	void SetAsync(CompositorPassInfo& pass);
+
+	// add sync pairs for cross queue texture access without fence, returns count of added pairs
+	uint32_t AddMissingSync(std::vector<CompositorPassInfo>& passes);
+
+	// graphviz format
+	std::string ToDot(const Graph& graph, const std::vector<CompositorPassInfo>& passes);
+}
@@ -17,6 +17,17 @@
 #include "FrameCompositor/Tasks/PrepareFrameTask.h"
 #include "FrameCompositor/Tasks/DeferredVrtComputeTask.h"
 #include "Tasks/WaterSimTask.h"
+#include "FrameCompositor/TransientResourceAliasing.h"
+#include "FrameCompositor/CompositorBarrierPlanner.h"
+#include "Utils/Logger.h"
+#include "Utils/CpuProfiler.h"
+#include "Utils/RenderStats.h"
+#include "Utils/FrameArena.h"
+#include "directx/d3dx12.h"
+#include <format>
+
+static_assert(CompositorBarrierPlanner::ReadStates == (D3D12_RESOURCE_STATE_DEPTH_READ | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+#include <fstream>
 
 FrameCompositor::FrameCompositor(const InitConfig& params, RenderProvider p, RenderWorld& w, ShadowMaps& shadows) : config(params), provider(p), renderWorld(w), shadowMaps(shadows)
 {
@@ -80,6 +91,7 @@ void FrameCompositor::reloadPasses()
 	for (auto& p : info.passes)
 	{
 		auto& pass = passes.emplace_back(p);
+		pass.profileName = CpuProfiler::Get().intern(p.name);
 		auto& task = tasks[pass.info.task];
 
 		if (!task)
@@ -145,6 +157,12 @@ void FrameCompositor::reloadPasses()
 		}
 	}
 
+	auto timingNames = CompositorGraph::GetTimingNames(info.passes);
+	for (size_t i = 0; i < passes.size(); i++)
+		passes[i].timingName = timingNames[i];
+
+	schedulePasses();
+
 	initializeTextureStates();
 
 	reloadTextures();
@@ -162,6 +180,7 @@ void FrameCompositor::reloadPasses()
 	}
 
 	initializeCommands();
+	initializeBarriers();
 }
 
 void FrameCompositor::reloadTextures()
@@ -182,34 +201,14 @@ void FrameCompositor::reloadTextures()
 	rtvHeap.Reset();
 	textures.clear();
 
-	auto initializeTexture = [this](const std::string& name, const CompositorTextureInfo& t)
+	auto transientOffsets = placeTransientTextures();
+
+	auto initializeTexture = [this, &transientOffsets](const std::string& name, const CompositorTextureInfo& t)
 		{
 			if (textures.contains(name))
 				return;
 
-			UINT w = t.width;
-			UINT h = t.height;
-
-			if (t.targetScale)
-			{
-				auto sz = provider.renderSystem.getRenderSize();
-				w = sz.x * t.width;
-				h = sz.y * t.height;
-			}
-			else if (t.outputScale)
-			{
-				auto sz = provider.renderSystem.getOutputSize();
-				w = sz.x * t.width;
-				h = sz.y * t.height;
-			}
-			if (t.arraySize > 1)
-			{
-				auto sqr = sqrt(t.arraySize);
-				w = std::ceil(w / sqr);
-				h = std::ceil(h / sqr);
-			}
-			w = max(w, 1);
-			h = max(h, 1);
+			auto [w, h] = getTextureSize(t);
 
 			{
 				auto lastState = initialTextureStates[name];
@@ -222,6 +221,8 @@ void FrameCompositor::reloadTextures()
 				{
 					if (t.uav)
 						tex.InitUAV(provider.renderSystem.core.device, w, h, t.format, lastState, { .arraySize = t.arraySize });
+					else if (auto transient = transientOffsets.find(name); transient != transientOffsets.end())
+						tex.InitRenderTarget(provider.renderSystem.core.device, w, h, rtvHeap, t.format, lastState, { .heap = transientHeap.Get(), .heapOffset = transient->second });
 					else
 						tex.InitRenderTarget(provider.renderSystem.core.device, w, h, rtvHeap, t.format, lastState, { .arraySize = t.arraySize });
 				}
@@ -297,6 +298,136 @@ void FrameCompositor::reloadTextures()
 	}
 }
 
+XMUINT2 FrameCompositor::getTextureSize(const CompositorTextureInfo& t) const
+{
+	UINT w = t.width;
+	UINT h = t.height;
+
+	if (t.targetScale)
+	{
+		auto sz = provider.renderSystem.getRenderSize();
+		w = sz.x * t.width;
+		h = sz.y * t.height;
+	}
+	else if (t.outputScale)
+	{
+		auto sz = provider.renderSystem.getOutputSize();
+		w = sz.x * t.width;
+		h = sz.y * t.height;
+	}
+	if (t.arraySize > 1)
+	{
+		auto sqr = sqrt(t.arraySize);
+		w = std::ceil(w / sqr);
+		h = std::ceil(h / sqr);
+	}
+
+	return { max(w, 1), max(h, 1) };
+}
+
+std::map<std::string, UINT64> FrameCompositor::placeTransientTextures()
+{
+	transientHeap.Reset();
+
+	for (auto& pass : passes)
+		pass.activateTransientTarget = false;
+
+	struct Lifetime
+	{
+		UINT firstUse = UINT_MAX;
+		UINT lastUse = 0;
+		bool valid = true;
+	};
+	std::map<std::string, Lifetime> lifetimes;
+
+	for (auto& [name, t] : info.textures)
+	{
+		if (t.transient)
+			lifetimes[name];
+	}
+
+	if (lifetimes.empty())
+		return {};
+
+	for (UINT i = 0; i < passes.size(); i++)
+	{
+		auto& pass = passes[i];
+
+		auto useTexture = [&](const std::string& name, bool target)
+			{
+				auto it = lifetimes.find(name);
+				if (it == lifetimes.end())
+					return;
+
+				auto& lifetime = it->second;
+
+				// only fullscreen passes in graphics queue keep pass order and overwrite whole target
+				if (pass.info.material.empty() || pass.info.mrt || (pass.info.flags & Compositor::Async))
+					lifetime.valid = false;
+
+				// read before write means content is kept between frames
+				if (lifetime.firstUse == UINT_MAX && !target)
+					lifetime.valid = false;
+
+				lifetime.firstUse = min(lifetime.firstUse, i);
+				lifetime.lastUse = max(lifetime.lastUse, i);
+			};
+
+		for (auto& input : pass.info.inputs)
+			useTexture(input.name, false);
+		for (auto& target : pass.info.targets)
+			useTexture(target.name, true);
+	}
+
+	auto device = provider.renderSystem.core.device;
+	std::vector<std::string> names;
+	std::vector<TransientResourceAliasing::Resource> resources;
+
+	for (auto& [name, lifetime] : lifetimes)
+	{
+		auto& t = info.textures[name];
+
+		if (!lifetime.valid || lifetime.firstUse == UINT_MAX || t.uav || t.arraySize > 1 || name.ends_with(":Depth") || name == "Output")
+		{
+			Logger::logWarning("Compositor texture " + name + " cant be transient");
+			continue;
+		}
+
+		auto size = getTextureSize(t);
+		auto desc = GpuTexture2D::GetTextureDesc(size.x, size.y, t.format, { .flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET });
+		auto allocation = device->GetResourceAllocationInfo(0, 1, &desc);
+
+		names.push_back(name);
+		resources.push_back({ allocation.SizeInBytes, allocation.Alignment, lifetime.firstUse, lifetime.lastUse });
+	}
+
+	if (resources.empty())
+		return {};
+
+	auto placement = TransientResourceAliasing::Solve(resources);
+
+	auto heapDesc = CD3DX12_HEAP_DESC(placement.memorySize, D3D12_HEAP_TYPE_DEFAULT, 0, D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES);
+	auto hr = device->CreateHeap(&heapDesc, IID_PPV_ARGS(&transientHeap));
+	if (FAILED(hr))
+	{
+		Logger::logErrorD3D("Failed to create compositor transient heap", hr);
+		return {};
+	}
+	transientHeap->SetName(L"CompositorTransient");
+
+	std::map<std::string, UINT64> offsets;
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		offsets[names[i]] = placement.offsets[i];
+		passes[resources[i].firstUse].activateTransientTarget = true;
+	}
+
+	const float MB = 1024.f * 1024.f;
+	Logger::log(std::format("Compositor transient textures: {} in {:.1f} MB heap, saved {:.1f} MB", names.size(), placement.memorySize / MB, placement.savedBytes() / MB));
+
+	return offsets;
+}
+
 void FrameCompositor::renderQuad(PassData& pass, RenderContext& ctx, ID3D12GraphicsCommandList* commandList)
 {
 	auto& mainTarget = pass.targets.front();
@@ -306,6 +437,10 @@ void FrameCompositor::renderQuad(PassData& pass, RenderContext& ctx, ID3D12Graph
 	else
 		mainTarget.texture->PrepareAsRenderTarget(commandList, mainTarget.previousState);
 
+	// aliased memory has undefined content, target has to be initialized
+	if (pass.activateTransientTarget)
+		commandList->DiscardResource(mainTarget.texture->texture.Get(), nullptr);
+
 	GpuTextureStates::Transition(commandList, pass.inputs);
 
 	for (UINT i = 0; auto& input : pass.inputs)
@@ -317,13 +452,14 @@ void FrameCompositor::renderQuad(PassData& pass, RenderContext& ctx, ID3D12Graph
 	MaterialDataStorage storage;
 
 	auto material = pass.material;
-	material->GetBase()->BindSignature(commandList);
+	D3D12GraphicsCommands commands(commandList);
+	material->GetBase()->BindSignature(commands);
 
 	material->LoadMaterialConstants(storage);
 	material->UpdatePerFrame(storage, constants);
-	material->BindPipeline(commandList);
-	material->BindTextures(commandList);
-	material->BindConstants(commandList, storage, constants);
+	material->BindPipeline(commands);
+	material->BindTextures(commands);
+	material->BindConstants(commands, storage, constants);
 
 	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	commandList->DrawInstanced(3, 1, 0, 0);
@@ -331,8 +467,12 @@ void FrameCompositor::renderQuad(PassData& pass, RenderContext& ctx, ID3D12Graph
 
 void FrameCompositor::render(RenderContext& ctx)
 {
+	auto& gpuProfiler = provider.renderSystem.core.gpuProfiler;
+
 	for (auto& pass : passes)
 	{
+		CpuProfiler::Zone zone(pass.profileName);
+
 		auto& syncCommands = pass.syncCommands;
 		if (pass.startCommands)
 			provider.renderSystem.core.StartCommandListNoMarker(*syncCommands);
@@ -340,6 +480,12 @@ void FrameCompositor::render(RenderContext& ctx)
 			provider.renderSystem.core.StartCommandListNoMarker(*pass.computeCommands);
 		if (pass.backbuffer)
 			pass.targets.front().texture = &provider.renderSystem.core.backbuffer[provider.renderSystem.core.frameIndex];
+		if (syncCommands)
+			pushBarriers(syncCommands->commandList, pass.barriersBefore, pass.activateTransientTarget ? pass.targets.front().texture : nullptr);
+
+		// threaded tasks are timed by their own command lists
+		auto inlineCommands = syncCommands ? syncCommands->commandList : pass.computeCommands ? pass.computeCommands->commandList : nullptr;
+		auto gpuQuery = inlineCommands ? gpuProfiler.begin(inlineCommands, pass.timingName, provider.renderSystem.core.frameIndex) : GpuTimestampQueries::NoQuery;
 
 		if (pass.material)
 		{
@@ -356,6 +502,9 @@ void FrameCompositor::render(RenderContext& ctx)
 				pass.task->update(ctx, pass);
 		}
 
+		if (inlineCommands)
+			gpuProfiler.end(inlineCommands, gpuQuery);
+
 		if (pass.present)
 		{
 			auto& target = pass.targets.front();
@@ -366,15 +515,161 @@ void FrameCompositor::render(RenderContext& ctx)
 				target.texture->PrepareAsView(syncCommands->commandList, target.previousState);
 		}
 
-		if (!pass.postTransition.empty() && syncCommands)
+		if (syncCommands)
+			pushBarriers(syncCommands->commandList, pass.barriersAfter);
+	}
+	RenderStats::Add(RenderStat::CompositorPasses, passes.size());
+
+	executeCommands();
+}
+
+void FrameCompositor::schedulePasses()
+{
+	graph = CompositorGraph::Build(info.passes);
+	applyMeasuredCosts(graph);
+
+	UINT asyncCandidates = 0;
+	UINT asyncPlaced = 0;
+	for (UINT i = 0; auto& pass : passes)
+	{
+		// compute work off critical path can overlap graphics work. Only tasks recording for compute queue qualify,
+		// shipped compositor files already put all of them on async compute explicitly. Graphics queue compute
+		// passes stay, Upscale runs DLSS/FSR on graphics list and DeferredVRT.Compute expects graphics queue states
+		bool asyncCandidate = pass.task && !(pass.info.flags & Compositor::Async) && pass.task->getExecution(pass).isInlineCompute();
+
+		asyncCandidates += asyncCandidate;
+
+		if (asyncCandidate && !graph.nodes[i].critical())
+		{
+			CompositorGraph::SetAsync(pass.info);
+			asyncPlaced++;
+		}
+		i++;
+	}
+
+	auto syncAdded = CompositorGraph::AddMissingSync(info.passes);
+
+	if (syncAdded)
+	{
+		graph = CompositorGraph::Build(info.passes);
+		applyMeasuredCosts(graph);
+	}
+
+	Logger::log(std::format("Compositor graph: {} passes, {} edges, critical path {} passes ({:.3f}), {} of {} async candidates placed to async compute, {} sync added",
+		passes.size(), graph.edges.size(), graph.criticalPath.size(), graph.criticalPathCost, asyncPlaced, asyncCandidates, syncAdded));
+}
+
+void FrameCompositor::applyMeasuredCosts(CompositorGraph::Graph& g) const
+{
+	std::map<std::string, float> measuredMs;
+	for (auto& stats : provider.renderSystem.core.gpuProfiler.queries.getStats())
+		measuredMs[stats.name] = stats.averageMs;
+
+	std::vector<std::string> timingNames;
+	for (auto& pass : passes)
+		timingNames.push_back(pass.timingName);
+
+	CompositorGraph::ApplyCosts(g, timingNames, measuredMs);
+}
+
+void FrameCompositor::dumpGraph(const std::string& file) const
+{
+	auto timedGraph = graph;
+	applyMeasuredCosts(timedGraph);
+
+	std::ofstream out(file);
+	out << CompositorGraph::ToDot(timedGraph, info.passes);
+
+	Logger::log("Compositor graph written to " + file);
+}
+
+void FrameCompositor::initializeBarriers()
+{
+	std::map<std::string, UINT> resourceIds;
+	std::map<ID3D12GraphicsCommandList*, UINT> commandListIds;
+	std::vector<CompositorBarrierPlanner::Use> uses;
+	std::vector<GpuTextureStates*> useStates;
+	std::vector<uint32_t> passCommandLists;
+
+	for (UINT passIdx = 0; auto& pass : passes)
+	{
+		pass.barriersBefore.clear();
+		pass.barriersAfter.clear();
+
+		if (pass.syncCommands)
+			passCommandLists.push_back(commandListIds.emplace(pass.syncCommands->commandList, (UINT)commandListIds.size()).first->second);
+		else
+			passCommandLists.push_back(CompositorBarrierPlanner::NoCommandList);
+
+		auto addUse = [&](const std::string& name, GpuTextureStates& states, bool planned)
+			{
+				bool postTransition = pass.syncCommands && std::find(pass.postTransition.begin(), pass.postTransition.end(), &states) != pass.postTransition.end();
+
+				auto resource = resourceIds.emplace(name, (UINT)resourceIds.size()).first->second;
+				auto postState = postTransition ? states.nextState : D3D12_RESOURCE_STATES{};
+				uses.push_back({ resource, passIdx, CompositorBarrierPlanner::States(states.previousState), CompositorBarrierPlanner::States(states.state), CompositorBarrierPlanner::States(postState), planned });
+				useStates.push_back(&states);
+			};
+
+		// fullscreen passes leave transitions to planner, tasks do their own
+		const bool quadPass = pass.material != nullptr;
+
+		for (UINT i = 0; auto& input : pass.info.inputs)
+			addUse(input.name, pass.inputs[i++], quadPass);
+
+		for (UINT i = 0; auto& target : pass.info.targets)
 		{
-			TextureTransitions<5> tr;
-			for (auto& pt : pass.postTransition)
-				tr.add(pt->texture, pt->state, pt->nextState);
-			tr.push(syncCommands->commandList);
+			auto& states = pass.targets[i++];
+			addUse(target.name, states, quadPass && !pass.mrt && !pass.present && states.state == D3D12_RESOURCE_STATE_RENDER_TARGET);
 		}
+
+		passIdx++;
+	}
+
+	auto plan = CompositorBarrierPlanner::Build(uses, passCommandLists);
+
+	auto toBarrier = [&](const CompositorBarrierPlanner::Barrier& b) -> PassData::Barrier
+		{
+			auto flags = b.split == CompositorBarrierPlanner::Split::Begin ? D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY :
+				b.split == CompositorBarrierPlanner::Split::End ? D3D12_RESOURCE_BARRIER_FLAG_END_ONLY : D3D12_RESOURCE_BARRIER_FLAG_NONE;
+
+			return { useStates[b.use], D3D12_RESOURCE_STATES(b.before), D3D12_RESOURCE_STATES(b.after), flags };
+		};
+
+	for (UINT i = 0; i < passes.size(); i++)
+	{
+		for (auto& b : plan.passes[i].before)
+			passes[i].barriersBefore.push_back(toBarrier(b));
+		for (auto& b : plan.passes[i].after)
+			passes[i].barriersAfter.push_back(toBarrier(b));
+	}
+
+	// presume planned transitions are done when pass starts
+	for (size_t i = 0; i < uses.size(); i++)
+	{
+		if (uses[i].planned)
+			useStates[i]->previousState = useStates[i]->state;
+	}
+
+	Logger::log(std::format("Compositor barriers: {} transitions in {} batches, {} split, {} dropped", plan.transitions, plan.batches, plan.splitTransitions, plan.droppedTransitions));
+}
+
+void FrameCompositor::pushBarriers(ID3D12GraphicsCommandList* commandList, const std::vector<PassData::Barrier>& barriers, GpuTexture2D* activatedTarget)
+{
+	barriersBuffer.clear();
+
+	// aliased memory is activated before its transitions
+	if (activatedTarget)
+		barriersBuffer.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, activatedTarget->texture.Get()));
+
+	for (auto& b : barriers)
+		barriersBuffer.push_back(CD3DX12_RESOURCE_BARRIER::Transition(b.texture->texture->texture.Get(), b.before, b.after, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, b.flags));
+
+	if (!barriersBuffer.empty())
+	{
+		commandList->ResourceBarrier((UINT)barriersBuffer.size(), barriersBuffer.data());
+		RenderStats::Add(RenderStat::Barriers, barriersBuffer.size());
 	}
-	executeCommands();
 }
 
 const GpuTexture2D* FrameCompositor::getTexture(const std::string& name) const
@@ -404,6 +699,8 @@ CompositorTask* FrameCompositor::getTask(const std::string& name)
 
 void FrameCompositor::executeCommands()
 {
+	CpuProfiler::Zone zone("FrameCompositor::executeCommands");
+
 	auto& renderer = provider.renderSystem.core;
 
 	for (auto& t : tasks)
@@ -411,7 +708,7 @@ void FrameCompositor::executeCommands()
 		for (auto& f : t.syncWait)
 			f.first->Wait(f.second->fence.Get(), f.second->value++);
 
-		if (t.finishEvents.empty())
+		if (t.jobs.empty())
 		{
 			for (auto& c : t.data)
 			{
@@ -420,18 +717,25 @@ void FrameCompositor::executeCommands()
 		}
 		else
 		{
-			for (size_t i = 0; i < t.finishEvents.size(); i++)
+			// execute in order of recording jobs finishing
+			FrameVector<const JobSystem::Handle*> pendingJobs(t.jobs.begin(), t.jobs.end());
+			FrameVector<CommandsData*> pendingData;
+			for (auto& c : t.data)
+				pendingData.push_back(&c);
+
+			while (!pendingJobs.empty())
 			{
-				DWORD dwWaitResult = WaitForMultipleObjects(t.finishEvents.size(), t.finishEvents.data(), FALSE, INFINITE);
-				if (dwWaitResult >= WAIT_OBJECT_0 && dwWaitResult < WAIT_OBJECT_0 + t.finishEvents.size())
-				{
-					int index = dwWaitResult - WAIT_OBJECT_0;
-					renderer.ExecuteCommandList(t.data[index]);
-				}
+				auto index = JobSystem::Get().waitAny(pendingJobs);
+				renderer.ExecuteCommandList(*pendingData[index]);
+
+				pendingJobs.erase(pendingJobs.begin() + index);
+				pendingData.erase(pendingData.begin() + index);
 			}
 		}
 
 		for (auto& f : t.syncSignal)
 			f.first->Signal(f.second->fence.Get(), f.second->value);
+
+		RenderStats::Add(RenderStat::CommandListsExecuted, t.data.size());
 	}
 }
@@ -2,6 +2,7 @@
 
 #include "RenderCore/RenderSystem.h"
 #include "FrameCompositor/Tasks/CompositorTask.h"
+#include "FrameCompositor/CompositorGraph.h"
 
 class AssignedMaterial;
 class ShadowMaps;
@@ -36,6 +37,9 @@ public:
 
 	CompositorTask* getTask(const std::string& name);
 
+	// passes dependency graph in graphviz format
+	void dumpGraph(const std::string& file) const;
+
 protected:
 
 	std::set<std::string> globalDefines;
@@ -44,8 +48,13 @@ protected:
 	InitConfig config;
 
 	CompositorInfo info;
+	ComPtr<ID3D12Heap> transientHeap;
 	std::map<std::string, GpuTexture2D> textures;
 
+	XMUINT2 getTextureSize(const CompositorTextureInfo&) const;
+	// heap offsets of transient textures, placed by their lifetime in passes
+	std::map<std::string, UINT64> placeTransientTextures();
+
 	RenderTargetHeap rtvHeap;
 
 	struct PassData : public CompositorPass
@@ -62,6 +71,24 @@ protected:
 		bool startComputeCommands = false;
 
 		std::vector<GpuTextureStates*> postTransition;
+
+		struct Barrier
+		{
+			GpuTextureStates* texture;
+			D3D12_RESOURCE_STATES before;
+			D3D12_RESOURCE_STATES after;
+			D3D12_RESOURCE_BARRIER_FLAGS flags;
+		};
+		// batched transitions around pass, planned from all passes usage
+		std::vector<Barrier> barriersBefore;
+		std::vector<Barrier> barriersAfter;
+
+		// first use of transient target, its memory was used by other textures
+		bool activateTransientTarget = false;
+
+		const char* profileName{};
+		// gpu timestamp scope, unique among passes
+		std::string timingName;
 	};
 	std::vector<PassData> passes;
 
@@ -77,7 +104,7 @@ protected:
 
 	struct TasksGroup
 	{
-		std::vector<HANDLE> finishEvents;
+		std::vector<const JobSystem::Handle*> jobs;
 		std::vector<CommandsData> data;
 		std::vector<CompositorPassInfo*> passes;
 
@@ -86,10 +113,19 @@ protected:
 	};
 	std::vector<TasksGroup> tasks;
 
+	CompositorGraph::Graph graph;
+	void schedulePasses();
+	// measured gpu time of pass timing scope as cost, passes without samples keep cost of 1
+	void applyMeasuredCosts(CompositorGraph::Graph& graph) const;
+
 	void initializeCommands();
 	void initializeTextureStates();
 	std::map<std::string, D3D12_RESOURCE_STATES> initialTextureStates;
 
+	void initializeBarriers();
+	void pushBarriers(ID3D12GraphicsCommandList* commandList, const std::vector<PassData::Barrier>& barriers, GpuTexture2D* activatedTarget = nullptr);
+	std::vector<CD3DX12_RESOURCE_BARRIER> barriersBuffer;
+
 	void executeCommands();
 
 	void renderQuad(PassData& pass, RenderContext& ctx, ID3D12GraphicsCommandList* commandList);
@@ -350,7 +350,7 @@ void FrameCompositor::initializeCommands()
 			for (auto& t : asyncTasks)
 			{
 				group.data.push_back(t.commands);
-				group.finishEvents.push_back(t.finishEvent);
+				group.jobs.push_back(t.job);
 			}
 			group.passes = std::move(asyncPasses);
 			asyncTasks.clear();
@@ -3,6 +3,7 @@
 #include "RenderCore/RenderSystem.h"
 #include "Scene/FrameParameters.h"
 #include "Resources/GraphicsResources.h"
+#include "Utils/JobSystem.h"
 
 class Camera;
 class RenderObjectsStorage;
@@ -21,7 +22,8 @@ struct RenderContext
 
 struct AsyncTaskInfo
 {
-	HANDLE finishEvent;
+	// recording job, submitted by task every frame before commands are executed
+	const JobSystem::Handle* job;
 	CommandsData commands;
 };
 
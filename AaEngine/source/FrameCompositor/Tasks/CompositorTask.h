@@ -26,7 +26,7 @@ public:
 
 	// One-time setup (resources, PSOs, render queues). No command recording here.
 	virtual void initialize(CompositorPass& pass) {};
-	// Declares command lists recorded on the task's own worker thread, collected by the compositor.
+	// Declares command lists recorded by jobs on the shared JobSystem, collected by the compositor.
 	// Only meaningful for tasks whose execution RecordMode is Threaded.
 	virtual AsyncTasksInfo buildAsyncTasks(CompositorPass& pass) { return {}; };
 	virtual void resize(CompositorPass& pass) {};
@@ -35,7 +35,7 @@ public:
 	enum class RecordMode
 	{
 		None,     // records nothing this pass (data preparation only)
-		Threaded, // records on its own worker thread into its own command list
+		Threaded, // records in JobSystem jobs into its own command list
 		Inline,   // records inline into the compositor's shared command list
 	};
 	// Which GPU queue the recorded commands target.
@@ -55,7 +55,7 @@ public:
 	};
 	virtual Execution getExecution(CompositorPass&) const = 0;
 
-	// Per-frame work that does not record into the shared command list (kick a worker thread, prepare data).
+	// Per-frame work that does not record into the shared command list (submit recording jobs, prepare data).
 	virtual void update(RenderContext& ctx, CompositorPass& pass) {};
 	// Records inline into the shared command list. The queue (graphics/compute) is determined by the
 	// list passed in, matching getExecution().queue.
@@ -5,6 +5,7 @@
 #include "Resources/Model/ModelResources.h"
 #include "RenderObject/DrawPrimitives.h"
 #include "RenderCore/ShadowMaps.h"
+#include "Utils/CpuProfiler.h"
 
 SceneRenderTask* instance = nullptr;
 
@@ -19,34 +20,18 @@ SceneRenderTask::SceneRenderTask(RenderProvider p, RenderWorld& w, ShadowMaps& s
 SceneRenderTask::~SceneRenderTask()
 {
 	instance = nullptr;
-	running = false;
 
-	if (opaque.work.eventBegin)
-	{
-		SetEvent(opaque.work.eventBegin);
-		opaque.work.worker.join();
-		opaque.work.commands.deinit();
-		CloseHandle(opaque.work.eventBegin);
-		CloseHandle(opaque.work.eventFinish);
-	}
+	opaque.work.deinit();
+	earlyZ.work.deinit();
+	transparent.work.deinit();
+}
 
-	if (earlyZ.work.eventBegin)
-	{
-		SetEvent(earlyZ.work.eventBegin);
-		earlyZ.work.worker.join();
-		earlyZ.work.commands.deinit();
-		CloseHandle(earlyZ.work.eventBegin);
-		CloseHandle(earlyZ.work.eventFinish);
-	}
+void SceneRenderTask::AsyncWork::deinit()
+{
+	JobSystem::Get().wait(job);
 
-	if (transparent.work.eventBegin)
-	{
-		SetEvent(transparent.work.eventBegin);
-		transparent.work.worker.join();
-		transparent.work.commands.deinit();
-		CloseHandle(transparent.work.eventBegin);
-		CloseHandle(transparent.work.eventFinish);
-	}
+	if (commands.commandList)
+		commands.deinit();
 }
 
 AsyncTasksInfo SceneRenderTask::buildAsyncTasks(CompositorPass& pass)
@@ -61,41 +46,17 @@ AsyncTasksInfo SceneRenderTask::buildAsyncTasks(CompositorPass& pass)
 	{
 		opaque.queue = renderWorld.createQueue(pass.mrt->formats, MaterialTechnique::Default);
 
-		opaque.work.eventBegin = CreateEvent(NULL, FALSE, FALSE, NULL);
-		opaque.work.eventFinish = CreateEvent(NULL, FALSE, FALSE, NULL);
 		opaque.work.commands = provider.renderSystem.core.CreateCommandList(L"SceneRender", PixColor::SceneRender);
 
-		opaque.work.worker = std::thread([this, &pass]
-			{
-				while (WaitForSingleObject(opaque.work.eventBegin, INFINITE) == WAIT_OBJECT_0 && running)
-				{
-					renderScene(pass);
-
-					SetEvent(opaque.work.eventFinish);
-				}
-			});
-
-		tasks = {{ opaque.work.eventFinish, opaque.work.commands }};
+		tasks = {{ &opaque.work.job, opaque.work.commands }};
 	}
 	else if (pass.info.entry == "Transparent")
 	{
 		transparent.queue = renderWorld.createQueue(pass.mrt->formats, MaterialTechnique::Default, Order::Transparent);
 
-		transparent.work.eventBegin = CreateEvent(NULL, FALSE, FALSE, NULL);
-		transparent.work.eventFinish = CreateEvent(NULL, FALSE, FALSE, NULL);
 		transparent.work.commands = provider.renderSystem.core.CreateCommandList(L"SceneRenderTransparent", PixColor::SceneTransparent);
 
-		transparent.work.worker = std::thread([this, &pass]
-			{
-				while (WaitForSingleObject(transparent.work.eventBegin, INFINITE) == WAIT_OBJECT_0 && running)
-				{
-					renderTransparentScene(pass);
-
-					SetEvent(transparent.work.eventFinish);
-				}
-			});
-
-		tasks = { { transparent.work.eventFinish, transparent.work.commands } };
+		tasks = { { &transparent.work.job, transparent.work.commands } };
 	}
 	else if (pass.info.entry == "Wireframe")
 	{
@@ -111,21 +72,9 @@ AsyncTasksInfo SceneRenderTask::buildAsyncTasks(CompositorPass& pass)
 		transparent.queue = renderWorld.createQueue({ pass.mrt->formats[0], pass.mrt->formats[1] }, MaterialTechnique::Default, Order::Transparent);
 		transparent.wireframeQueue = renderWorld.createQueue({ pass.mrt->formats.front() }, MaterialTechnique::Wireframe, Order::Transparent);
 
-		opaque.work.eventBegin = CreateEvent(NULL, FALSE, FALSE, NULL);
-		opaque.work.eventFinish = CreateEvent(NULL, FALSE, FALSE, NULL);
 		opaque.work.commands = provider.renderSystem.core.CreateCommandList(L"Wireframe", PixColor::SceneRender);
 
-		opaque.work.worker = std::thread([this, &pass]
-			{
-				while (WaitForSingleObject(opaque.work.eventBegin, INFINITE) == WAIT_OBJECT_0 && running)
-				{
-					renderWireframe(pass);
-
-					SetEvent(opaque.work.eventFinish);
-				}
-			});
-
-		tasks = { { opaque.work.eventFinish, opaque.work.commands } };
+		tasks = { { &opaque.work.job, opaque.work.commands } };
 	}
 	else if (pass.info.entry == "Forward")
 	{
@@ -139,37 +88,56 @@ AsyncTasksInfo SceneRenderTask::initializeEarlyZ(CompositorPass& pass)
 {
 	earlyZ.queue = renderWorld.createQueue({}, MaterialTechnique::Depth);
 
-	earlyZ.work.eventBegin = CreateEvent(NULL, FALSE, FALSE, NULL);
-	earlyZ.work.eventFinish = CreateEvent(NULL, FALSE, FALSE, NULL);
 	earlyZ.work.commands = provider.renderSystem.core.CreateCommandList(L"EarlyZ", PixColor::EarlyZ);
+	earlyZ.pass = &pass;
 
-	earlyZ.work.worker = std::thread([this, &pass]
-		{
-			while (WaitForSingleObject(earlyZ.work.eventBegin, INFINITE) == WAIT_OBJECT_0 && running)
-			{
-				renderEarlyZ(pass);
-
-				SetEvent(earlyZ.work.eventFinish);
-			}
-		});
-
-	return { { earlyZ.work.eventFinish, earlyZ.work.commands } };
+	return { { &earlyZ.work.job, earlyZ.work.commands } };
 }
 
 void SceneRenderTask::update(RenderContext& renderCtx, CompositorPass& pass)
 {
+	auto& jobs = JobSystem::Get();
+
 	if (pass.info.entry == "EarlyZ")
 	{
-		//just init, early z starts from Opaque thread
+		//just init, early z starts with Opaque visibility
 		ctx = renderCtx;
 	}
 	else if (pass.info.entry == "Opaque" || pass.info.entry == "Wireframe")
 	{
-		SetEvent(opaque.work.eventBegin);
+		const bool wireframe = pass.info.entry == "Wireframe";
+
+		// visibility is shared by early z and opaque
+		JobSystem::Handle visibility[] = { jobs.submit([this, wireframe]
+			{
+				CpuProfiler::Zone zone("SceneVisibility");
+				opaque.renderables->updateVisibility(wireframe ? *ctx.camera : getViewCamera(), opaque.visibility);
+			}) };
+
+		if (earlyZ.pass)
+			earlyZ.work.job = jobs.submit([this]
+				{
+					CpuProfiler::Zone zone("EarlyZ");
+					renderEarlyZ(*earlyZ.pass);
+				}, visibility);
+
+		opaque.work.job = jobs.submit([this, &pass, wireframe]
+			{
+				CpuProfiler::Zone zone("Opaque");
+
+				if (wireframe)
+					renderWireframe(pass);
+				else
+					renderScene(pass);
+			}, visibility);
 	}
 	else if (pass.info.entry == "Transparent")
 	{
-		SetEvent(transparent.work.eventBegin);
+		transparent.work.job = jobs.submit([this, &pass]
+			{
+				CpuProfiler::Zone zone("Transparent");
+				renderTransparentScene(pass);
+			});
 	}
 }
 
@@ -202,11 +170,6 @@ SceneRenderTask& SceneRenderTask::Get()
 
 void SceneRenderTask::renderWireframe(CompositorPass& pass)
 {
-	opaque.renderables->updateVisibility(*ctx.camera, opaque.visibility);
-
-	if (earlyZ.work.eventBegin)
-		SetEvent(earlyZ.work.eventBegin);
-
 	auto marker = provider.renderSystem.core.StartCommandList(opaque.work.commands);
 
 	pass.mrt->PrepareAsTarget(opaque.work.commands.commandList, pass.targets, true, TransitionFlags::UseDepth);
@@ -245,11 +208,6 @@ const Camera& SceneRenderTask::getViewCamera() const
 
 void SceneRenderTask::renderScene(CompositorPass& pass)
 {
-	opaque.renderables->updateVisibility(getViewCamera(), opaque.visibility);
-
-	if (earlyZ.work.eventBegin)
-		SetEvent(earlyZ.work.eventBegin);
-
 	auto marker = provider.renderSystem.core.StartCommandList(opaque.work.commands);
 
 	pass.mrt->PrepareAsTarget(opaque.work.commands.commandList, pass.targets, true, TransitionFlags::UseDepth);
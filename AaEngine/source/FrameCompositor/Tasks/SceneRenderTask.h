@@ -4,7 +4,6 @@
 #include "FrameCompositor/RenderContext.h"
 #include "FrameCompositor/Tasks/CompositorTask.h"
 #include "Scene/RenderObject.h"
-#include <thread>
 #include "Editor/EntityPicker.h"
 #include "RenderCore/ShadowMaps.h"
 
@@ -41,12 +40,10 @@ private:
 	struct AsyncWork
 	{
 		CommandsData commands;
-		HANDLE eventBegin{};
-		HANDLE eventFinish{};
-		std::thread worker;
-	};
+		JobSystem::Handle job;
 
-	bool running = true;
+		void deinit();
+	};
 
 	RenderContext ctx;
 
@@ -64,6 +61,7 @@ private:
 	{
 		AsyncWork work;
 		RenderQueue* queue{};
+		CompositorPass* pass{};
 	}
 	earlyZ;
 
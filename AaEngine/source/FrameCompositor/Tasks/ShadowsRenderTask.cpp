@@ -1,6 +1,7 @@
 #include "FrameCompositor/Tasks/ShadowsRenderTask.h"
 #include "Scene/RenderObject.h"
 #include "Scene/RenderWorld.h"
+#include "Utils/CpuProfiler.h"
 
 ShadowsRenderTask::ShadowsRenderTask(RenderProvider p, RenderWorld& w, ShadowMaps& shadows) : shadowMaps(shadows), CompositorTask(p, w)
 {
@@ -15,17 +16,12 @@ ShadowsRenderTask::ShadowsRenderTask(RenderProvider p, RenderWorld& w, ShadowMap
 
 ShadowsRenderTask::~ShadowsRenderTask()
 {
-	running = false;
-
 	for (auto& shadow : cascades)
 	{
-		if (shadow.eventBegin)
+		if (shadow.commands.commandList)
 		{
-			SetEvent(shadow.eventBegin);
-			shadow.worker.join();
+			JobSystem::Get().wait(shadow.job);
 			shadow.commands.deinit();
-			CloseHandle(shadow.eventBegin);
-			CloseHandle(shadow.eventFinish);
 		}
 	}
 }
@@ -38,24 +34,9 @@ AsyncTasksInfo ShadowsRenderTask::buildAsyncTasks(CompositorPass&)
 
 	for (auto& shadow : cascades)
 	{
-		shadow.eventBegin = CreateEvent(NULL, FALSE, FALSE, NULL);
-		shadow.eventFinish = CreateEvent(NULL, FALSE, FALSE, NULL);
 		shadow.commands = provider.renderSystem.core.CreateCommandList(L"Shadows", PixColor::Shadows);
 
-		shadow.worker = std::thread([this, idx = tasks.size()]
-			{
-				auto& shadow = cascades[idx];
-				auto& cascade = shadowMaps.cascades[idx];
-
-				while (WaitForSingleObject(shadow.eventBegin, INFINITE) == WAIT_OBJECT_0 && running)
-				{
-					prepareShadowCascade(shadow, cascade);
-
-					SetEvent(shadow.eventFinish);
-				}
-			});
-
-		tasks.emplace_back(shadow.eventFinish, shadow.commands);
+		tasks.emplace_back(&shadow.job, shadow.commands);
 	}
 
 	return tasks;
@@ -65,19 +46,21 @@ void ShadowsRenderTask::update(RenderContext& renderCtx, CompositorPass&)
 {
 	ctx = renderCtx;
 
-	for (auto& shadow : cascades)
+	for (UINT idx = 0; auto& shadow : cascades)
 	{
-		SetEvent(shadow.eventBegin);
+		shadow.job = JobSystem::Get().submit([this, idx]
+			{
+				CpuProfiler::Zone zone("ShadowCascade");
+				prepareShadowCascade(cascades[idx], shadowMaps.cascades[idx]);
+			});
+		idx++;
 	}
 }
 
 void ShadowsRenderTask::prepareShadowCascade(ShadowWork& shadow, ShadowMaps::ShadowData& cascade)
 {
 	if (!cascade.update)
-	{
-		SetEvent(shadow.eventFinish);
 		return;
-	}
 
 	auto marker = provider.renderSystem.core.StartCommandList(shadow.commands);
 
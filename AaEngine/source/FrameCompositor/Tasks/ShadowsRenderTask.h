@@ -3,7 +3,6 @@
 #include "FrameCompositor/Tasks/CompositorTask.h"
 #include "Scene/RenderQueue.h"
 #include "RenderCore/ShadowMaps.h"
-#include <thread>
 
 class ShadowsRenderTask : public CompositorTask
 {
@@ -24,9 +23,7 @@ private:
 	struct ShadowWork
 	{
 		CommandsData commands;
-		HANDLE eventBegin{};
-		HANDLE eventFinish{};
-		std::thread worker;
+		JobSystem::Handle job;
 
 		RenderObjectsVisibilityData renderablesData;
 		std::vector<UINT> idFilter;
@@ -41,8 +38,6 @@ private:
 
 	void prepareShadowCascade(ShadowWork& work, ShadowMaps::ShadowData& data);
 
-	bool running = true;
-
 	RenderQueue* depthQueue{};
 
 	ShadowMaps& shadowMaps;
@@ -1,5 +1,6 @@
 #include "FrameCompositor/Tasks/VoxelizeSceneTask.h"
 #include "Scene/RenderWorld.h"
+#include "Utils/CpuProfiler.h"
 
 static VoxelizeSceneTask* instance = nullptr;
 
@@ -10,18 +11,12 @@ VoxelizeSceneTask::VoxelizeSceneTask(RenderProvider p, RenderWorld& w, ShadowMap
 
 VoxelizeSceneTask::~VoxelizeSceneTask()
 {
-	running = false;
+	JobSystem::Get().wait(voxelizeJob);
 
 	voxelization.shutdown();
 
-	if (eventBegin)
-	{
-		SetEvent(eventBegin);
-		worker.join();
+	if (voxelizeCommands.commandList)
 		voxelizeCommands.deinit();
-		CloseHandle(eventBegin);
-		CloseHandle(eventFinish);
-	}
 
 	instance = nullptr;
 }
@@ -61,25 +56,9 @@ AsyncTasksInfo VoxelizeSceneTask::buildAsyncTasks(CompositorPass& pass)
 	frameCbuffer = provider.resources.shaderBuffers.CreateCbufferResource(sizeof(Matrix), "FrameInfo");
 
 	AsyncTasksInfo tasks;
-	eventBegin = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-	eventFinish = CreateEvent(nullptr, FALSE, FALSE, nullptr);
 	voxelizeCommands = provider.renderSystem.core.CreateCommandList(L"Voxelize", PixColor::Voxelize);
 
-	worker = std::thread([this, &pass]
-		{
-			while (WaitForSingleObject(eventBegin, INFINITE) == WAIT_OBJECT_0 && running)
-			{
-				auto marker = provider.renderSystem.core.StartCommandList(voxelizeCommands);
-
-				voxelization.voxelizeCascades(voxelizeCommands, pass.targets.front(), ctx);
-
-				marker.close();
-
-				SetEvent(eventFinish);
-			}
-		});
-
-	tasks.emplace_back(eventFinish, voxelizeCommands);
+	tasks.emplace_back(&voxelizeJob, voxelizeCommands);
 
 	return tasks;
 }
@@ -107,5 +86,14 @@ void VoxelizeSceneTask::update(RenderContext& renderCtx, CompositorPass& pass)
 	}
 
 	ctx = renderCtx;
-	SetEvent(eventBegin);
+
+	voxelizeJob = JobSystem::Get().submit([this, &pass]
+		{
+			CpuProfiler::Zone zone("Voxelize");
+			auto marker = provider.renderSystem.core.StartCommandList(voxelizeCommands);
+
+			voxelization.voxelizeCascades(voxelizeCommands, pass.targets.front(), ctx);
+
+			marker.close();
+		});
 }
@@ -2,7 +2,6 @@
 
 #include "FrameCompositor/Tasks/CompositorTask.h"
 #include "RenderCore/VCT/anisoSeparate/AnisoSeparateVoxelization.h"
-#include <thread>
 
 struct RenderQueue;
 class RenderWorld;
@@ -33,11 +32,7 @@ private:
 	AnisoSeparateVoxelization voxelization;
 
 	CommandsData voxelizeCommands;
-	HANDLE eventBegin{};
-	HANDLE eventFinish{};
-	std::thread worker;
-
-	bool running = true;
+	JobSystem::Handle voxelizeJob;
 
 	RenderContext ctx{};
 
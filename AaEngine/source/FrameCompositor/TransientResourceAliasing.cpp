@@ -0,0 +1,65 @@
+#include "FrameCompositor/TransientResourceAliasing.h"
+#include <algorithm>
+#include <numeric>
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+bool TransientResourceAliasing::LifetimesOverlap(const Resource& a, const Resource& b)
+{
+	return a.firstUse <= b.lastUse && b.firstUse <= a.lastUse;
+}
+
+TransientResourceAliasing::Placement TransientResourceAliasing::Solve(const std::vector<Resource>& resources)
+{
+	Placement placement;
+	placement.offsets.resize(resources.size());
+
+	// largest first, smaller ones fill gaps after them
+	std::vector<size_t> order(resources.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](size_t l, size_t r) { return resources[l].size > resources[r].size; });
+
+	struct Range
+	{
+		uint64_t begin;
+		uint64_t end;
+	};
+	std::vector<size_t> placed;
+	std::vector<Range> occupied;
+
+	for (auto idx : order)
+	{
+		auto& resource = resources[idx];
+		const uint64_t alignment = std::max<uint64_t>(resource.alignment, 1);
+
+		// memory used by resources alive at the same time
+		occupied.clear();
+		for (auto other : placed)
+		{
+			if (LifetimesOverlap(resource, resources[other]))
+				occupied.push_back({ placement.offsets[other], placement.offsets[other] + resources[other].size });
+		}
+		std::sort(occupied.begin(), occupied.end(), [](const Range& l, const Range& r) { return l.begin < r.begin; });
+
+		// first gap big enough
+		uint64_t offset = 0;
+		for (auto& range : occupied)
+		{
+			if (AlignUp(offset, alignment) + resource.size <= range.begin)
+				break;
+
+			offset = std::max(offset, range.end);
+		}
+		offset = AlignUp(offset, alignment);
+
+		placement.offsets[idx] = offset;
+		placement.memorySize = std::max(placement.memorySize, offset + resource.size);
+		placement.totalSize += AlignUp(resource.size, alignment);
+		placed.push_back(idx);
+	}
+
+	return placement;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// Places resources with non overlapping lifetimes into shared memory, independent of graphics API
+namespace TransientResourceAliasing
+{
+	struct Resource
+	{
+		uint64_t size{};
+		uint64_t alignment = 1;
+
+		// first and last pass using the resource, inclusive
+		uint32_t firstUse{};
+		uint32_t lastUse{};
+	};
+
+	struct Placement
+	{
+		// offset of each input resource in shared memory
+		std::vector<uint64_t> offsets;
+		uint64_t memorySize{};
+		// size needed without aliasing
+		uint64_t totalSize{};
+
+		uint64_t savedBytes() const { return totalSize - memorySize; }
+	};
+
+	Placement Solve(const std::vector<Resource>& resources);
+
+	bool LifetimesOverlap(const Resource& a, const Resource& b);
+}
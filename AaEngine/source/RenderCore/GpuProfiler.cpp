@@ -0,0 +1,114 @@
+#include "RenderCore/GpuProfiler.h"
+#include "Utils/CpuProfiler.h"
+#include "Utils/Directx.h"
+#include "Utils/Logger.h"
+#include "directx/d3dx12.h"
+
+void GpuProfiler::init(ID3D12Device* device, ID3D12CommandQueue* directQueue, ID3D12CommandQueue* computeQueue)
+{
+	queues[Direct] = directQueue;
+	queues[Compute] = computeQueue;
+
+	queries.init(MaxScopesPerFrame, FrameCount);
+
+	D3D12_QUERY_HEAP_DESC heapDesc{};
+	heapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+	heapDesc.Count = queries.getQueriesCount();
+
+	auto hr = device->CreateQueryHeap(&heapDesc, IID_PPV_ARGS(&queryHeap));
+	if (FAILED(hr))
+	{
+		Logger::logErrorD3D("CreateQueryHeap failed", hr);
+		enabled = false;
+		return;
+	}
+	queryHeap->SetName(L"GpuProfilerQueries");
+
+	auto heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK);
+	auto bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(UINT64(heapDesc.Count) * sizeof(UINT64));
+
+	hr = device->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &bufferDesc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&readbackBuffer));
+	if (FAILED(hr))
+	{
+		Logger::logErrorD3D("GpuProfiler readback buffer failed", hr);
+		enabled = false;
+		return;
+	}
+	readbackBuffer->SetName(L"GpuProfilerReadback");
+}
+
+UINT GpuProfiler::begin(ID3D12GraphicsCommandList* commandList, const std::string& name, UINT frameIndex)
+{
+	if (!enabled || !queryHeap)
+		return GpuTimestampQueries::NoQuery;
+
+	auto type = commandList->GetType();
+	if (type != D3D12_COMMAND_LIST_TYPE_DIRECT && type != D3D12_COMMAND_LIST_TYPE_COMPUTE)
+		return GpuTimestampQueries::NoQuery;
+
+	auto query = queries.allocate(frameIndex, queries.registerScope(name), type == D3D12_COMMAND_LIST_TYPE_COMPUTE ? Compute : Direct);
+
+	if (query != GpuTimestampQueries::NoQuery)
+		commandList->EndQuery(queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, query);
+
+	return query;
+}
+
+void GpuProfiler::end(ID3D12GraphicsCommandList* commandList, UINT query)
+{
+	if (query == GpuTimestampQueries::NoQuery)
+		return;
+
+	commandList->EndQuery(queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, query + 1);
+	// resolve on same queue as it was written, no cross queue dependency
+	commandList->ResolveQueryData(queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, query, 2, readbackBuffer.Get(), query * sizeof(UINT64));
+}
+
+void GpuProfiler::readFrame(UINT frameIndex)
+{
+	if (!readbackBuffer)
+		return;
+
+	const UINT offset = queries.frameQueryOffset(frameIndex);
+	const UINT count = queries.frameQueriesCount(frameIndex);
+
+	std::vector<UINT64> timestamps(count);
+	if (count)
+	{
+		D3D12_RANGE readRange{ offset * sizeof(UINT64), (offset + count) * sizeof(UINT64) };
+		void* data{};
+		if (FAILED(readbackBuffer->Map(0, &readRange, &data)))
+			return;
+
+		memcpy(timestamps.data(), (UINT8*)data + readRange.Begin, count * sizeof(UINT64));
+
+		D3D12_RANGE writeRange{};
+		readbackBuffer->Unmap(0, &writeRange);
+	}
+
+	LARGE_INTEGER qpcFrequency;
+	QueryPerformanceFrequency(&qpcFrequency);
+
+	GpuTimestampQueries::Calibration calibration[QueuesCount]{};
+	for (UINT i = 0; i < QueuesCount; i++)
+	{
+		UINT64 cpuTimestamp{};
+		if (FAILED(queues[i]->GetTimestampFrequency(&calibration[i].frequency)) || FAILED(queues[i]->GetClockCalibration(&calibration[i].gpuTimestamp, &cpuTimestamp)))
+		{
+			calibration[i] = {};
+			continue;
+		}
+
+		// steady_clock used by cpu profiler is performance counter based
+		calibration[i].cpuTimeNs = UINT64(double(cpuTimestamp) * 1e9 / double(qpcFrequency.QuadPart));
+	}
+
+	auto samples = queries.resolve(frameIndex, timestamps, calibration);
+
+	auto& profiler = CpuProfiler::Get();
+	if (profiler.isCapturing())
+	{
+		for (auto& s : samples)
+			profiler.addTrackEvent(s.queue == Compute ? "GPU compute" : "GPU direct", profiler.intern(queries.getScopeName(s.scope)), s.startNs, s.endNs);
+	}
+}
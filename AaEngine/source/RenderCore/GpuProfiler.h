@@ -0,0 +1,36 @@
+#pragma once
+
+#include "RenderCore/GpuTimestampQueries.h"
+#include <d3d12.h>
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+// Timestamp queries around command list work on direct and compute queues, read back frames in flight later
+class GpuProfiler
+{
+public:
+
+	void init(ID3D12Device* device, ID3D12CommandQueue* directQueue, ID3D12CommandQueue* computeQueue);
+
+	// returns query to end, NoQuery when not recorded
+	UINT begin(ID3D12GraphicsCommandList* commandList, const std::string& name, UINT frameIndex);
+	void end(ID3D12GraphicsCommandList* commandList, UINT query);
+
+	// frame has to be finished on gpu
+	void readFrame(UINT frameIndex);
+
+	GpuTimestampQueries queries;
+
+	bool enabled = true;
+
+private:
+
+	static constexpr UINT MaxScopesPerFrame = 256;
+
+	enum Queue { Direct, Compute, QueuesCount };
+	ID3D12CommandQueue* queues[QueuesCount]{};
+
+	ComPtr<ID3D12QueryHeap> queryHeap;
+	ComPtr<ID3D12Resource> readbackBuffer;
+};
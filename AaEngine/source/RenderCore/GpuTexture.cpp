@@ -123,21 +123,29 @@ void GpuTexture2D::CreateDepthBuffer(ID3D12Device* device, D3D12_RESOURCE_STATES
 	);
 }
 
-void GpuTexture2D::CreateTextureBuffer(ID3D12Device* device, D3D12_RESOURCE_STATES state, const InitParams& params)
+D3D12_RESOURCE_DESC GpuTexture2D::GetTextureDesc(UINT width, UINT height, DXGI_FORMAT format, const InitParams& params)
 {
-	view = {};
-
 	D3D12_RESOURCE_DESC textureDesc = {};
 	textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
 	textureDesc.Width = width;
 	textureDesc.Height = height;
-	textureDesc.DepthOrArraySize = depthOrArraySize;
+	textureDesc.DepthOrArraySize = params.arraySize;
 	textureDesc.MipLevels = params.mipLevels;
 	textureDesc.Format = format;
 	textureDesc.SampleDesc.Count = 1;
 	textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
 	textureDesc.Flags = params.flags;
 
+	return textureDesc;
+}
+
+void GpuTexture2D::CreateTextureBuffer(ID3D12Device* device, D3D12_RESOURCE_STATES state, const InitParams& params)
+{
+	view = {};
+
+	D3D12_RESOURCE_DESC textureDesc = GetTextureDesc(width, height, format, params);
+	textureDesc.DepthOrArraySize = depthOrArraySize;
+
 	D3D12_CLEAR_VALUE clearValue = {};
 	clearValue.Format = format;
 	memcpy(clearValue.Color, &ClearColor, sizeof(ClearColor));
@@ -146,16 +154,32 @@ void GpuTexture2D::CreateTextureBuffer(ID3D12Device* device, D3D12_RESOURCE_STAT
 	if (params.flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS)
 		clearValuePtr = nullptr;
 
-	auto heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+	HRESULT hr;
 
-	auto hr = device->CreateCommittedResource(
-		&heapProps,
-		D3D12_HEAP_FLAG_NONE,
-		&textureDesc,
-		state,
-		clearValuePtr,
-		IID_PPV_ARGS(&texture)
-	);
+	if (params.heap)
+	{
+		hr = device->CreatePlacedResource(
+			params.heap,
+			params.heapOffset,
+			&textureDesc,
+			state,
+			clearValuePtr,
+			IID_PPV_ARGS(&texture)
+		);
+	}
+	else
+	{
+		auto heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+
+		hr = device->CreateCommittedResource(
+			&heapProps,
+			D3D12_HEAP_FLAG_NONE,
+			&textureDesc,
+			state,
+			clearValuePtr,
+			IID_PPV_ARGS(&texture)
+		);
+	}
 
 	if (FAILED(hr))
 		Logger::logErrorD3D("CreateTextureBuffer", hr);
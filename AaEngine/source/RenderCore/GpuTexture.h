@@ -41,7 +41,12 @@ public:
 		D3D12_RESOURCE_FLAGS flags;
 		UINT mipLevels = 1;
 		UINT arraySize = 1;
+
+		// placed into existing heap instead of committed
+		ID3D12Heap* heap{};
+		UINT64 heapOffset{};
 	};
+	static D3D12_RESOURCE_DESC GetTextureDesc(UINT width, UINT height, DXGI_FORMAT format, const InitParams&);
 	void InitUAV(ID3D12Device* device, UINT width, UINT height, DXGI_FORMAT format, D3D12_RESOURCE_STATES state, InitParams&& params = {});
 
 	void InitRenderTarget(ID3D12Device* device, UINT width, UINT height, RenderTargetHeap& heap, DXGI_FORMAT format, D3D12_RESOURCE_STATES state, InitParams&& params = {});
@@ -0,0 +1,150 @@
+#include "RenderCore/GpuTimestampQueries.h"
+#include <algorithm>
+
+void GpuTimestampQueries::init(uint32_t maxScopes, uint32_t framesCount, uint32_t history)
+{
+	maxScopesPerFrame = maxScopes;
+	historySize = history;
+
+	frames.clear();
+	frames.resize(framesCount);
+
+	for (auto& f : frames)
+		f.allocations.resize(maxScopesPerFrame);
+}
+
+uint32_t GpuTimestampQueries::getQueriesCount() const
+{
+	return uint32_t(frames.size()) * maxScopesPerFrame * 2;
+}
+
+uint32_t GpuTimestampQueries::registerScope(const std::string& name)
+{
+	std::lock_guard lock(mutex);
+
+	if (auto it = scopeIds.find(name); it != scopeIds.end())
+		return it->second;
+
+	auto id = uint32_t(scopes.size());
+	auto& scope = scopes.emplace_back();
+	scope.name = name;
+	scope.history.resize(historySize);
+
+	scopeIds[name] = id;
+
+	return id;
+}
+
+uint32_t GpuTimestampQueries::allocate(uint32_t frameIdx, uint32_t scope, uint32_t queue)
+{
+	auto& frame = frames[frameIdx];
+
+	auto idx = frame.used->fetch_add(1, std::memory_order_relaxed);
+	if (idx >= maxScopesPerFrame)
+	{
+		frame.used->store(maxScopesPerFrame, std::memory_order_relaxed);
+		return NoQuery;
+	}
+
+	frame.allocations[idx] = { scope, queue };
+
+	return frameQueryOffset(frameIdx) + idx * 2;
+}
+
+uint32_t GpuTimestampQueries::frameQueryOffset(uint32_t frame) const
+{
+	return frame * maxScopesPerFrame * 2;
+}
+
+uint32_t GpuTimestampQueries::frameQueriesCount(uint32_t frame) const
+{
+	return std::min(frames[frame].used->load(std::memory_order_relaxed), maxScopesPerFrame) * 2;
+}
+
+std::vector<GpuTimestampQueries::Sample> GpuTimestampQueries::resolve(uint32_t frameIdx, std::span<const uint64_t> timestamps, std::span<const Calibration> queues)
+{
+	auto& frame = frames[frameIdx];
+	const uint32_t count = std::min<uint32_t>(frameQueriesCount(frameIdx), uint32_t(timestamps.size())) / 2;
+
+	std::vector<Sample> samples;
+	samples.reserve(count);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		auto& allocation = frame.allocations[i];
+		auto& calibration = queues[allocation.queue];
+		if (!calibration.frequency)
+			continue;
+
+		auto toCpuTime = [&](uint64_t ticks)
+			{
+				double offset = (double(ticks) - double(calibration.gpuTimestamp)) * 1e9 / double(calibration.frequency);
+				return uint64_t(double(calibration.cpuTimeNs) + offset);
+			};
+
+		auto begin = timestamps[i * 2];
+		auto end = std::max(timestamps[i * 2 + 1], begin);
+
+		samples.push_back({ allocation.scope, allocation.queue, toCpuTime(begin), toCpuTime(end) });
+	}
+
+	frame.used->store(0, std::memory_order_relaxed);
+
+	{
+		std::lock_guard lock(mutex);
+
+		// scope can be recorded multiple times in frame
+		std::vector<float> frameMs(scopes.size(), -1.f);
+		for (auto& s : samples)
+			frameMs[s.scope] = std::max(frameMs[s.scope], 0.f) + (s.endNs - s.startNs) / 1e6f;
+
+		for (uint32_t i = 0; i < scopes.size(); i++)
+		{
+			if (frameMs[i] < 0)
+				continue;
+
+			auto& scope = scopes[i];
+			scope.lastMs = frameMs[i];
+			scope.history[scope.historyNext] = frameMs[i];
+			scope.historyNext = (scope.historyNext + 1) % historySize;
+			scope.historyCount = std::min(scope.historyCount + 1, historySize);
+		}
+	}
+
+	return samples;
+}
+
+std::vector<GpuTimestampQueries::ScopeStats> GpuTimestampQueries::getStats() const
+{
+	std::lock_guard lock(mutex);
+
+	std::vector<ScopeStats> stats;
+	for (auto& scope : scopes)
+	{
+		if (!scope.historyCount)
+			continue;
+
+		auto& s = stats.emplace_back();
+		s.name = scope.name;
+		s.lastMs = scope.lastMs;
+		s.minMs = s.maxMs = scope.history[0];
+
+		float sum = 0;
+		for (uint32_t i = 0; i < scope.historyCount; i++)
+		{
+			auto ms = scope.history[i];
+			sum += ms;
+			s.minMs = std::min(s.minMs, ms);
+			s.maxMs = std::max(s.maxMs, ms);
+		}
+		s.averageMs = sum / scope.historyCount;
+	}
+
+	return stats;
+}
+
+std::string GpuTimestampQueries::getScopeName(uint32_t scope) const
+{
+	std::lock_guard lock(mutex);
+	return scopes[scope].name;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+// Timestamp query pairs allocated per frame in flight and rolling statistics of resolved scopes, independent of GPU api
+class GpuTimestampQueries
+{
+public:
+
+	static constexpr uint32_t NoQuery = uint32_t(-1);
+
+	void init(uint32_t maxScopesPerFrame, uint32_t framesCount, uint32_t historySize = 120);
+
+	uint32_t getQueriesCount() const;
+
+	uint32_t registerScope(const std::string& name);
+
+	// thread safe, returns begin query index (end query follows) or NoQuery when frame is full
+	uint32_t allocate(uint32_t frame, uint32_t scope, uint32_t queue);
+
+	// range of queries written by frame
+	uint32_t frameQueryOffset(uint32_t frame) const;
+	uint32_t frameQueriesCount(uint32_t frame) const;
+
+	// maps queue timestamps to cpu time
+	struct Calibration
+	{
+		uint64_t frequency{};
+		uint64_t gpuTimestamp{};
+		uint64_t cpuTimeNs{};
+	};
+
+	struct Sample
+	{
+		uint32_t scope;
+		uint32_t queue;
+		uint64_t startNs;
+		uint64_t endNs;
+	};
+
+	// timestamps of frame range, call after frame finished on gpu. Updates statistics and frees frame queries
+	std::vector<Sample> resolve(uint32_t frame, std::span<const uint64_t> timestamps, std::span<const Calibration> queues);
+
+	struct ScopeStats
+	{
+		std::string name;
+		float lastMs{};
+		float averageMs{};
+		float minMs{};
+		float maxMs{};
+	};
+	std::vector<ScopeStats> getStats() const;
+
+	std::string getScopeName(uint32_t scope) const;
+
+private:
+
+	struct Allocation
+	{
+		uint32_t scope;
+		uint32_t queue;
+	};
+
+	struct Frame
+	{
+		std::unique_ptr<std::atomic<uint32_t>> used = std::make_unique<std::atomic<uint32_t>>(0);
+		std::vector<Allocation> allocations;
+	};
+	std::vector<Frame> frames;
+	uint32_t maxScopesPerFrame{};
+
+	struct Scope
+	{
+		std::string name;
+
+		// ring of per frame durations
+		std::vector<float> history;
+		uint32_t historyNext{};
+		uint32_t historyCount{};
+		float lastMs{};
+	};
+
+	mutable std::mutex mutex;
+	std::vector<Scope> scopes;
+	std::map<std::string, uint32_t> scopeIds;
+	uint32_t historySize{};
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <d3d12.h>
+
+// Command list subset used by scene and material submission, methods mirror ID3D12GraphicsCommandList
+class GraphicsCommands
+{
+public:
+
+	virtual ~GraphicsCommands() = default;
+
+	virtual void SetGraphicsRootSignature(ID3D12RootSignature* signature) = 0;
+	virtual void SetPipelineState(ID3D12PipelineState* pipelineState) = 0;
+
+	virtual void SetGraphicsRootDescriptorTable(UINT rootIndex, D3D12_GPU_DESCRIPTOR_HANDLE descriptor) = 0;
+	virtual void SetGraphicsRoot32BitConstants(UINT rootIndex, UINT count, const void* data, UINT offset) = 0;
+	virtual void SetGraphicsRootConstantBufferView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address) = 0;
+	virtual void SetGraphicsRootShaderResourceView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address) = 0;
+	virtual void SetGraphicsRootUnorderedAccessView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address) = 0;
+
+	virtual void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology) = 0;
+	virtual void IASetVertexBuffers(UINT slot, UINT count, const D3D12_VERTEX_BUFFER_VIEW* views) = 0;
+	virtual void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view) = 0;
+
+	virtual void DrawInstanced(UINT vertexCount, UINT instanceCount, UINT startVertex, UINT startInstance) = 0;
+	virtual void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance) = 0;
+	virtual void DispatchMesh(UINT x, UINT y, UINT z) = 0;
+	virtual void ExecuteIndirect(ID3D12CommandSignature* signature, UINT maxCommands, ID3D12Resource* arguments, UINT64 argumentsOffset, ID3D12Resource* countBuffer, UINT64 countOffset) = 0;
+
+	virtual void ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers) = 0;
+};
+
+// Forwards to command list used in production
+class D3D12GraphicsCommands final : public GraphicsCommands
+{
+public:
+
+	D3D12GraphicsCommands(ID3D12GraphicsCommandList* commandList) : commandList(commandList) {}
+
+	void SetGraphicsRootSignature(ID3D12RootSignature* signature) override { commandList->SetGraphicsRootSignature(signature); }
+	void SetPipelineState(ID3D12PipelineState* pipelineState) override { commandList->SetPipelineState(pipelineState); }
+
+	void SetGraphicsRootDescriptorTable(UINT rootIndex, D3D12_GPU_DESCRIPTOR_HANDLE descriptor) override { commandList->SetGraphicsRootDescriptorTable(rootIndex, descriptor); }
+	void SetGraphicsRoot32BitConstants(UINT rootIndex, UINT count, const void* data, UINT offset) override { commandList->SetGraphicsRoot32BitConstants(rootIndex, count, data, offset); }
+	void SetGraphicsRootConstantBufferView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address) override { commandList->SetGraphicsRootConstantBufferView(rootIndex, address); }
+	void SetGraphicsRootShaderResourceView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address) override { commandList->SetGraphicsRootShaderResourceView(rootIndex, address); }
+	void SetGraphicsRootUnorderedAccessView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address) override { commandList->SetGraphicsRootUnorderedAccessView(rootIndex, address); }
+
+	void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology) override { commandList->IASetPrimitiveTopology(topology); }
+	void IASetVertexBuffers(UINT slot, UINT count, const D3D12_VERTEX_BUFFER_VIEW* views) override { commandList->IASetVertexBuffers(slot, count, views); }
+	void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view) override { commandList->IASetIndexBuffer(view); }
+
+	void DrawInstanced(UINT vertexCount, UINT instanceCount, UINT startVertex, UINT startInstance) override { commandList->DrawInstanced(vertexCount, instanceCount, startVertex, startInstance); }
+	void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance) override { commandList->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance); }
+	void DispatchMesh(UINT x, UINT y, UINT z) override { ((ID3D12GraphicsCommandList6*)commandList)->DispatchMesh(x, y, z); }
+	void ExecuteIndirect(ID3D12CommandSignature* signature, UINT maxCommands, ID3D12Resource* arguments, UINT64 argumentsOffset, ID3D12Resource* countBuffer, UINT64 countOffset) override
+	{
+		commandList->ExecuteIndirect(signature, maxCommands, arguments, argumentsOffset, countBuffer, countOffset);
+	}
+
+	void ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers) override { commandList->ResourceBarrier(count, barriers); }
+
+	ID3D12GraphicsCommandList* commandList;
+};
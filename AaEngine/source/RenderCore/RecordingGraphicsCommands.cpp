@@ -0,0 +1,176 @@
+#include "RenderCore/RecordingGraphicsCommands.h"
+
+RecordingGraphicsCommands::Command& RecordingGraphicsCommands::push(Type type)
+{
+	counters[size_t(type)]++;
+
+	auto& c = commands.emplace_back();
+	c.type = type;
+	return c;
+}
+
+void RecordingGraphicsCommands::SetGraphicsRootSignature(ID3D12RootSignature* signature)
+{
+	push(Type::SetRootSignature).object = signature;
+}
+
+void RecordingGraphicsCommands::SetPipelineState(ID3D12PipelineState* pipelineState)
+{
+	push(Type::SetPipelineState).object = pipelineState;
+}
+
+void RecordingGraphicsCommands::SetGraphicsRootDescriptorTable(UINT rootIndex, D3D12_GPU_DESCRIPTOR_HANDLE descriptor)
+{
+	auto& c = push(Type::SetDescriptorTable);
+	c.index = rootIndex;
+	c.value = descriptor.ptr;
+}
+
+void RecordingGraphicsCommands::SetGraphicsRoot32BitConstants(UINT rootIndex, UINT count, const void* data, UINT offset)
+{
+	auto& c = push(Type::SetRootConstants);
+	c.index = rootIndex;
+	c.counts[0] = count;
+	c.counts[1] = offset;
+	c.constantsOffset = UINT(constants.size());
+
+	auto values = static_cast<const uint32_t*>(data);
+	constants.insert(constants.end(), values, values + count);
+}
+
+void RecordingGraphicsCommands::SetGraphicsRootConstantBufferView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+	auto& c = push(Type::SetConstantBufferView);
+	c.index = rootIndex;
+	c.value = address;
+}
+
+void RecordingGraphicsCommands::SetGraphicsRootShaderResourceView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+	auto& c = push(Type::SetShaderResourceView);
+	c.index = rootIndex;
+	c.value = address;
+}
+
+void RecordingGraphicsCommands::SetGraphicsRootUnorderedAccessView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+	auto& c = push(Type::SetUnorderedAccessView);
+	c.index = rootIndex;
+	c.value = address;
+}
+
+void RecordingGraphicsCommands::IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)
+{
+	push(Type::SetTopology).counts[0] = UINT(topology);
+}
+
+void RecordingGraphicsCommands::IASetVertexBuffers(UINT slot, UINT count, const D3D12_VERTEX_BUFFER_VIEW* views)
+{
+	auto& c = push(Type::SetVertexBuffers);
+	c.index = slot;
+	c.counts[0] = count;
+	c.value = count ? views->BufferLocation : 0;
+}
+
+void RecordingGraphicsCommands::IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view)
+{
+	push(Type::SetIndexBuffer).value = view ? view->BufferLocation : 0;
+}
+
+void RecordingGraphicsCommands::DrawInstanced(UINT vertexCount, UINT instanceCount, UINT startVertex, UINT startInstance)
+{
+	auto& c = push(Type::DrawInstanced);
+	c.counts[0] = vertexCount;
+	c.counts[1] = instanceCount;
+	c.counts[2] = startVertex;
+	c.counts[3] = startInstance;
+}
+
+void RecordingGraphicsCommands::DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance)
+{
+	auto& c = push(Type::DrawIndexedInstanced);
+	c.counts[0] = indexCount;
+	c.counts[1] = instanceCount;
+	c.counts[2] = startIndex;
+	c.counts[3] = startInstance;
+	c.value = UINT64(baseVertex);
+}
+
+void RecordingGraphicsCommands::DispatchMesh(UINT x, UINT y, UINT z)
+{
+	auto& c = push(Type::DispatchMesh);
+	c.counts[0] = x;
+	c.counts[1] = y;
+	c.counts[2] = z;
+}
+
+void RecordingGraphicsCommands::ExecuteIndirect(ID3D12CommandSignature*, UINT maxCommands, ID3D12Resource* arguments, UINT64 argumentsOffset, ID3D12Resource*, UINT64)
+{
+	auto& c = push(Type::ExecuteIndirect);
+	c.object = arguments;
+	c.value = argumentsOffset;
+	c.counts[0] = maxCommands;
+}
+
+void RecordingGraphicsCommands::ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER*)
+{
+	push(Type::ResourceBarrier).counts[0] = count;
+}
+
+const std::vector<RecordingGraphicsCommands::Command>& RecordingGraphicsCommands::getCommands() const
+{
+	return commands;
+}
+
+std::span<const uint32_t> RecordingGraphicsCommands::getConstants(const Command& c) const
+{
+	if (c.type != Type::SetRootConstants)
+		return {};
+
+	return { constants.data() + c.constantsOffset, c.counts[0] };
+}
+
+size_t RecordingGraphicsCommands::count(Type type) const
+{
+	return counters[size_t(type)];
+}
+
+size_t RecordingGraphicsCommands::drawsCount() const
+{
+	return count(Type::DrawInstanced) + count(Type::DrawIndexedInstanced) + count(Type::DispatchMesh) + count(Type::ExecuteIndirect);
+}
+
+size_t RecordingGraphicsCommands::stateChangesCount() const
+{
+	return count(Type::SetPipelineState) + count(Type::SetRootSignature);
+}
+
+void RecordingGraphicsCommands::clear()
+{
+	commands.clear();
+	constants.clear();
+	counters = {};
+}
+
+const char* RecordingGraphicsCommands::GetName(Type type)
+{
+	switch (type)
+	{
+	case Type::SetRootSignature: return "SetRootSignature";
+	case Type::SetPipelineState: return "SetPipelineState";
+	case Type::SetDescriptorTable: return "SetDescriptorTable";
+	case Type::SetRootConstants: return "SetRootConstants";
+	case Type::SetConstantBufferView: return "SetConstantBufferView";
+	case Type::SetShaderResourceView: return "SetShaderResourceView";
+	case Type::SetUnorderedAccessView: return "SetUnorderedAccessView";
+	case Type::SetTopology: return "SetTopology";
+	case Type::SetVertexBuffers: return "SetVertexBuffers";
+	case Type::SetIndexBuffer: return "SetIndexBuffer";
+	case Type::DrawInstanced: return "DrawInstanced";
+	case Type::DrawIndexedInstanced: return "DrawIndexedInstanced";
+	case Type::DispatchMesh: return "DispatchMesh";
+	case Type::ExecuteIndirect: return "ExecuteIndirect";
+	case Type::ResourceBarrier: return "ResourceBarrier";
+	default: return "";
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "RenderCore/GraphicsCommands.h"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Captures command stream into memory without executing it, to inspect submission order and state changes without gpu
+class RecordingGraphicsCommands final : public GraphicsCommands
+{
+public:
+
+	enum class Type : uint8_t
+	{
+		SetRootSignature,
+		SetPipelineState,
+		SetDescriptorTable,
+		SetRootConstants,
+		SetConstantBufferView,
+		SetShaderResourceView,
+		SetUnorderedAccessView,
+		SetTopology,
+		SetVertexBuffers,
+		SetIndexBuffer,
+		DrawInstanced,
+		DrawIndexedInstanced,
+		DispatchMesh,
+		ExecuteIndirect,
+		ResourceBarrier,
+		Count
+	};
+
+	struct Command
+	{
+		Type type;
+		// root parameter or input slot
+		UINT index{};
+		// root signature, pipeline or indirect arguments
+		const void* object{};
+		// gpu address, descriptor or buffer location
+		UINT64 value{};
+		// vertex/index, instance and start counts, barriers count or constants count
+		UINT counts[4]{};
+		// first of copied root constants
+		UINT constantsOffset{};
+	};
+
+	void SetGraphicsRootSignature(ID3D12RootSignature* signature) override;
+	void SetPipelineState(ID3D12PipelineState* pipelineState) override;
+
+	void SetGraphicsRootDescriptorTable(UINT rootIndex, D3D12_GPU_DESCRIPTOR_HANDLE descriptor) override;
+	void SetGraphicsRoot32BitConstants(UINT rootIndex, UINT count, const void* data, UINT offset) override;
+	void SetGraphicsRootConstantBufferView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address) override;
+	void SetGraphicsRootShaderResourceView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address) override;
+	void SetGraphicsRootUnorderedAccessView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address) override;
+
+	void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology) override;
+	void IASetVertexBuffers(UINT slot, UINT count, const D3D12_VERTEX_BUFFER_VIEW* views) override;
+	void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view) override;
+
+	void DrawInstanced(UINT vertexCount, UINT instanceCount, UINT startVertex, UINT startInstance) override;
+	void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance) override;
+	void DispatchMesh(UINT x, UINT y, UINT z) override;
+	void ExecuteIndirect(ID3D12CommandSignature* signature, UINT maxCommands, ID3D12Resource* arguments, UINT64 argumentsOffset, ID3D12Resource* countBuffer, UINT64 countOffset) override;
+
+	void ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers) override;
+
+	const std::vector<Command>& getCommands() const;
+	std::span<const uint32_t> getConstants(const Command&) const;
+
+	size_t count(Type) const;
+	// draws, mesh dispatches and indirect executions
+	size_t drawsCount() const;
+	// pipeline and root signature switches
+	size_t stateChangesCount() const;
+
+	void clear();
+
+	static const char* GetName(Type);
+
+private:
+
+	Command& push(Type type);
+
+	std::vector<Command> commands;
+	std::vector<uint32_t> constants;
+	std::array<size_t, size_t(Type::Count)> counters{};
+};
@@ -159,6 +159,8 @@ RenderCore::RenderCore()
 
 	for (auto& f : fenceValues)
 		f = 1;
+
+	gpuProfiler.init(device, commandQueue, computeQueue);
 }
 
 RenderCore::~RenderCore()
@@ -388,7 +390,7 @@ CommandsMarker RenderCore::StartCommandList(CommandsData& commands)
 {
 	StartCommandListNoMarker(commands);
 
-	return { commands };
+	return { commands, &gpuProfiler, frameIndex };
 }
 
 void RenderCore::StartCommandListNoMarker(CommandsData& commands)
@@ -411,7 +413,7 @@ CommandsMarker RenderCore::StartCommandList(CommandsData& commands, ID3D12Descri
 	ID3D12DescriptorHeap* descriptorHeaps[] = { heap };
 	commands.commandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
 
-	return { commands };
+	return { commands, &gpuProfiler, frameIndex };
 }
 
 void RenderCore::ExecuteCommandList(CommandsData& commands)
@@ -436,6 +438,9 @@ void RenderCore::EndFrame()
 {
 	MoveToNextFrame();
 	VertexBufferModelGarbageCollector::Get().advanceFrame();
+
+	// frame slot was waited for, its timestamps are available
+	gpuProfiler.readFrame(frameIndex);
 }
 
 void RenderCore::WaitForAllFrames()
@@ -505,12 +510,18 @@ void CommandsData::deinit()
 	}
 }
 
-CommandsMarker::CommandsMarker(CommandsData& c)
+CommandsMarker::CommandsMarker(CommandsData& c, GpuProfiler* p, UINT frameIndex)
 {
 	if (!c.name.empty())
 	{
 		commandList = c.commandList;
 		PIXBeginEvent(commandList, (UINT64)c.color, c.name.c_str());
+
+		if (p)
+		{
+			profiler = p;
+			gpuQuery = profiler->begin(commandList, c.name, frameIndex);
+		}
 	}
 }
 
@@ -526,7 +537,10 @@ CommandsMarker::~CommandsMarker()
 
 void CommandsMarker::move(const char* text, PixColor color)
 {
-	close();
+	// gpu timing continues until close
+	if (!closed && commandList)
+		PIXEndEvent(commandList);
+
 	closed = false;
 	PIXBeginEvent(commandList, (UINT64)color, text);
 }
@@ -544,6 +558,12 @@ void CommandsMarker::close()
 		closed = true;
 		PIXEndEvent(commandList);
 	}
+
+	if (profiler)
+	{
+		profiler->end(commandList, gpuQuery);
+		profiler = nullptr;
+	}
 }
 
 GlobalQueueMarker::GlobalQueueMarker(ID3D12CommandQueue* q, const char* name) : queue(q)
@@ -8,6 +8,7 @@
 #include "RenderCore/Upscaling.h"
 #include "Resources/DescriptorManager.h"
 #include "RenderCore/PixColor.h"
+#include "RenderCore/GpuProfiler.h"
 
 using namespace DirectX;
 
@@ -33,7 +34,7 @@ private:
 
 struct CommandsMarker
 {
-	CommandsMarker(CommandsData&);
+	CommandsMarker(CommandsData&, GpuProfiler* profiler = nullptr, UINT frameIndex = 0);
 	CommandsMarker(ID3D12GraphicsCommandList* c, const char* name, PixColor color);
 	~CommandsMarker();
 
@@ -44,6 +45,9 @@ struct CommandsMarker
 private:
 	bool closed = false;
 	ID3D12GraphicsCommandList* commandList{};
+
+	GpuProfiler* profiler{};
+	UINT gpuQuery = GpuTimestampQueries::NoQuery;
 };
 
 struct ColorSpace
@@ -82,6 +86,9 @@ public:
 	RenderTargetHeap rtvHeap;
 	GpuTexture2D backbuffer[FrameCount];
 
+	// times all command lists started with marker
+	GpuProfiler gpuProfiler;
+
 	bool IsDisplayHDR() const;
 	DXGI_OUTPUT_DESC1 GetDisplayDesc() const;
 
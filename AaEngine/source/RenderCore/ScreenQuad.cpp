@@ -7,7 +7,8 @@ void ScreenQuad::Render(AssignedMaterial* material, const GpuTexture2D& target,
 	ShaderConstantsProvider constants(provider.params, {}, * ctx.camera, target);
 	MaterialDataStorage storage;
 
-	material->GetBase()->BindSignature(commandList);
+	D3D12GraphicsCommands commands(commandList);
+	material->GetBase()->BindSignature(commands);
 
 	material->LoadMaterialConstants(storage);
 	memcpy(storage.rootParams.data(), &data.vertices, sizeof(data.vertices));
@@ -15,9 +16,9 @@ void ScreenQuad::Render(AssignedMaterial* material, const GpuTexture2D& target,
 		memcpy(reinterpret_cast<char*>(storage.rootParams.data()) + sizeof(data.vertices), materialData, materialDataSize);
 
 	material->UpdatePerFrame(storage, constants);
-	material->BindPipeline(commandList);
-	material->BindTextures(commandList);
-	material->BindConstants(commandList, storage, constants);
+	material->BindPipeline(commands);
+	material->BindTextures(commands);
+	material->BindConstants(commands, storage, constants);
 
 	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	commandList->DrawInstanced(6, 1, 0, 0);
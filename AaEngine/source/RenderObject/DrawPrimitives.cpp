@@ -37,15 +37,16 @@ void BoundingBoxDraw::renderAxisAligned(ID3D12GraphicsCommandList* commandList,
 		material->SetParameter(ResourcesInfo::AutoParam::WORLD_POSITION, &centerPosition.x, sizeof(centerPosition) / sizeof(float));
 	}
 
-	material->GetBase()->BindSignature(commandList);
+	D3D12GraphicsCommands commands(commandList);
+	material->GetBase()->BindSignature(commands);
 
 	MaterialDataStorage storage;
 	material->LoadMaterialConstants(storage);
 	material->UpdatePerFrame(storage, constants);
-	material->BindPipeline(commandList);
-	material->BindTextures(commandList);
+	material->BindPipeline(commands);
+	material->BindTextures(commands);
 	//material->UpdatePerObject(storage, constants);
-	material->BindConstants(commandList, storage, constants);
+	material->BindConstants(commands, storage, constants);
 
 	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
@@ -69,7 +70,7 @@ void BoundingBoxDraw::renderObjectAligned(ID3D12GraphicsCommandList* commandList
 		minScale = min(minScale, 1);
 		scale += Vector3(minScale) * boundsOffsetAdd * 2;
 
-		Vector3 boxPosition = entity->getPosition();
+		Vector3 boxPosition = entity->getWorldPosition();
 
 		Vector3 positionOffset{};
 		positionOffset.y -= (bbox.Extents.y - bbox.Center.y) + minScale * boundsOffsetAdd; //box model has center at bottom
@@ -89,15 +90,16 @@ void BoundingBoxDraw::renderObjectAligned(ID3D12GraphicsCommandList* commandList
 		material->SetParameter(ResourcesInfo::AutoParam::WORLD_POSITION, &boxPosition.x, sizeof(boxPosition) / sizeof(float));
 	}
 
-	material->GetBase()->BindSignature(commandList);
+	D3D12GraphicsCommands commands(commandList);
+	material->GetBase()->BindSignature(commands);
 
 	MaterialDataStorage storage;
 	material->LoadMaterialConstants(storage);
 	material->UpdatePerFrame(storage, constants);
-	material->BindPipeline(commandList);
-	material->BindTextures(commandList);
+	material->BindPipeline(commands);
+	material->BindTextures(commands);
 	//material->UpdatePerObject(storage, constants);
-	material->BindConstants(commandList, storage, constants);
+	material->BindConstants(commands, storage, constants);
 
 	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
@@ -23,6 +23,7 @@ void SplineSweepMesh::clear()
 	indices.clear();
 	bounds = {};
 	hasBounds = false;
+	optimization = {};
 }
 
 SplineSweepMesh SplineSweepMeshGenerator::generate(const Spline& spline, const ShapeProfile2D& profile, const SplineSweepMeshSettings& settings)
@@ -40,6 +41,13 @@ SplineSweepMesh SplineSweepMeshGenerator::generate(const Spline& spline, const S
 	if (settings.generateEndCaps)
 		appendEndCaps(mesh, samples, profile, ranges);
 
+	// sweep is emitted in strip order along the path, with poor post-transform cache reuse
+	if (settings.optimizeVertexOrder && !mesh.empty())
+	{
+		mesh.optimization = MeshOptimizer::optimizeMesh(mesh.indices, mesh.vertices.data(), mesh.vertices.size(), sizeof(SplineSweepVertex), &mesh.vertices.front().position.x, sizeof(SplineSweepVertex));
+		mesh.vertices.resize(mesh.optimization.vertexCount);
+	}
+
 	return mesh;
 }
 
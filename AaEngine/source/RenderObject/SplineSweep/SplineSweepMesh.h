@@ -3,6 +3,7 @@
 #include "RenderObject/SplineSweep/ShapeProfile.h"
 #include "RenderObject/SplineSweep/Spline.h"
 #include "Resources/Model/VertexBufferModel.h"
+#include "Resources/Model/MeshOptimizer.h"
 #include "Utils/MathUtils.h"
 
 #include <cstdint>
@@ -22,6 +23,7 @@ struct SplineSweepMesh
 	std::vector<uint32_t> indices;
 	BoundingBoxVolume bounds{};
 	bool hasBounds = false;
+	MeshOptimizer::Report optimization{};
 
 	void clear();
 	bool empty() const { return vertices.empty() || indices.empty(); }
@@ -38,6 +40,7 @@ struct SplineSweepMeshSettings
 	bool preventProfileFoldover = true;
 	bool splitOpenProfileQuadsAtCenter = true;
 	bool splitClosedProfileQuadsAtCenter = true;
+	bool optimizeVertexOrder = true;
 };
 
 class SplineSweepMeshGenerator
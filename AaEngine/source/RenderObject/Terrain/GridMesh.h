@@ -7,6 +7,7 @@
 #include "Scene/Camera.h"
 #include <unordered_map>
 #include "Scene/EntityGeometry.h"
+#include "Utils/FrameArena.h"
 
 // Data sent to the StructuredBuffer
 struct TileData
@@ -79,7 +80,7 @@ public:
 			uint32_t size;
 			uint32_t level;
 		};
-		std::vector<Node> stack;
+		FrameVector<Node> stack;
 		stack.reserve(1024);
 
 		// Start at root blocks
@@ -147,7 +148,7 @@ public:
 			uint32_t size;
 			uint32_t level;
 		};
-		std::vector<Node> stack;
+		FrameVector<Node> stack;
 		stack.reserve(1024);
 
 		// Start at root blocks
@@ -230,7 +231,7 @@ public:
 			uint32_t size;
 			uint32_t level;
 		};
-		std::vector<Node> stack;
+		FrameVector<Node> stack;
 		stack.reserve(1024);
 
 		// Start at root blocks
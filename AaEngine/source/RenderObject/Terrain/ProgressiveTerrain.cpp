@@ -5,6 +5,7 @@
 #include <format>
 #include "RenderCore/VCT/anisoSeparate/AnisoSeparateVoxelization.h"
 #include "Utils/Logger.h"
+#include "Utils/CpuProfiler.h"
 
 const UINT TextureSize = 1024;
 const UINT TerrainModelSize = 33;
@@ -15,15 +16,7 @@ ProgressiveTerrain::ProgressiveTerrain()
 
 ProgressiveTerrain::~ProgressiveTerrain()
 {
-	updateCtx.running = false;
-
-	for (auto& work : chunkUpdateThreads)
-	{
-		SetEvent(work.eventBegin);
-		work.worker.join();
-		CloseHandle(work.eventBegin);
-		CloseHandle(work.eventFinish);
-	}
+	waitForChunkUpdates();
 }
 
 void ProgressiveTerrain::initialize(RenderSystem& renderSystem, GraphicsResources& resources, ResourceUploadBatch& batch, RenderWorld& renderWorld)
@@ -106,21 +99,6 @@ void ProgressiveTerrain::initialize(RenderSystem& renderSystem, GraphicsResource
 			chunkDirty[x][y] = true;
 		}
 
-	for (UINT i = 0; auto& work : chunkUpdateThreads)
-	{
-		work.eventBegin = CreateEvent(NULL, FALSE, FALSE, NULL);
-		work.eventFinish = CreateEvent(NULL, FALSE, FALSE, NULL);
-
-		work.worker = std::thread([this, &work, &renderSystem, idx = i++]
-			{
-				while (WaitForSingleObject(work.eventBegin, INFINITE) == WAIT_OBJECT_0 && updateCtx.running)
-				{
-					runChunkUpdateThread(idx);
-					SetEvent(work.eventFinish);
-				}
-			});
-	}
-
 	auto csShader = resources.shaders.getShader("generateHeightmapNormalsCS", ShaderType::Compute, ShaderRef{ "grid/generateHeightmapNormalsCS.hlsl", "CSMain", "cs_6_6" });
 	heightmapToNormalCS.init(*renderSystem.core.device, *csShader);
 
@@ -162,6 +140,8 @@ void ProgressiveTerrain::regenerateChunk(ID3D12GraphicsCommandList* commandList,
 
 void ProgressiveTerrain::update(ID3D12GraphicsCommandList* commandList, const Camera& camera, const ShadowMaps& shadows, UINT frameIdx)
 {
+	CpuProfiler::Zone zone("Terrain");
+
 	XMINT2 cameraChunk = params.gridCenterAt(camera.getPosition(), params.tileSize, GridsSize);
 
 	if (cameraChunk.x != gridCenterChunk.x || cameraChunk.y != gridCenterChunk.y)
@@ -215,23 +195,25 @@ void ProgressiveTerrain::dispatchChunkUpdates(const Camera& camera, const Shadow
 	updateCtx.shadows = &shadows;
 	updateCtx.frameIdx = frameIdx;
 
-	for (auto& work : chunkUpdateThreads)
+	for (UINT i = 0; auto& job : chunkUpdateJobs)
 	{
-		SetEvent(work.eventBegin);
+		job = JobSystem::Get().submit([this, idx = i++] { runChunkUpdate(idx); });
 	}
 }
 
-void ProgressiveTerrain::runChunkUpdateThread(UINT threadIndex)
+void ProgressiveTerrain::runChunkUpdate(UINT updateIndex)
 {
+	CpuProfiler::Zone zone("TerrainChunkUpdate");
+
 	if (!updateLod)
 		return;
 
 	const auto& camera = *updateCtx.camera;
 
 	BoundingOrientedBox shadowBbox;
-	if (threadIndex >= 1 && threadIndex <= 4) //shadow camera 1-4
+	if (updateIndex >= 1 && updateIndex <= 4) //shadow camera 1-4
 	{
-		UINT i = threadIndex - 1;
+		UINT i = updateIndex - 1;
 		auto& shadowCamera = updateCtx.shadows->cascades[i].camera;
 		shadowBbox = shadowCamera.prepareOrientedBox();
 	}
@@ -241,25 +223,25 @@ void ProgressiveTerrain::runChunkUpdateThread(UINT threadIndex)
 		{
 			auto& grid = terrainGrid[x][y];
 
-			if (threadIndex == 0) // main camera
+			if (updateIndex == 0) // main camera
 			{
 				terrainGridTiles.BuildLOD(camera.getPosition(), camera.prepareFrustum(), chunkWorldCoord[x][y]);
 				grid.mesh.update(grid.entity->geometry, (UINT)terrainGridTiles.m_renderList.size(), terrainGridTiles.m_renderList.data(), (UINT)terrainGridTiles.m_renderList.size() * sizeof(TileData), updateCtx.frameIdx);
 			}
-			else if (threadIndex >= 1 && threadIndex <= 4) //shadow camera 1-4
+			else if (updateIndex >= 1 && updateIndex <= 4) //shadow camera 1-4
 			{
-				UINT i = threadIndex - 1;
+				UINT i = updateIndex - 1;
 				auto& tiles = shadowTerrainGridTiles[i];
 
 				const UINT tileLod[] = { 9, 9, 7, 6 };
 				tiles.BuildLOD(camera.getPosition(), shadowBbox, chunkWorldCoord[x][y], tileLod[i]);
 
-				auto& g = grid.geometryViews.viewGeometries[threadIndex - 1];
+				auto& g = grid.geometryViews.viewGeometries[updateIndex - 1];
 				grid.shadowMesh[i].update(g, (UINT)tiles.m_renderList.size(), tiles.m_renderList.data(), (UINT)tiles.m_renderList.size() * sizeof(TileData), updateCtx.frameIdx);
 			}
 			else //voxelize camera 1-4
 			{
-				UINT i = threadIndex - 5;
+				UINT i = updateIndex - 5;
 
 				auto cascadeExtends = AnisoSeparateVoxelization::CascadeExtends[i];
 				Vector2 voxelizeExtends = Vector2(cascadeExtends, cascadeExtends) * 1.5f;
@@ -269,12 +251,12 @@ void ProgressiveTerrain::runChunkUpdateThread(UINT threadIndex)
 				tiles.BuildAabbLOD(camera.getPosition(), chunkWorldCoord[x][y], p - voxelizeExtends, p + voxelizeExtends);
 				//tiles.BuildLOD(camera.getPosition(), chunkWorldCoord[x][y]);
 
-				auto& g = grid.geometryViews.viewGeometries[threadIndex - 1];
+				auto& g = grid.geometryViews.viewGeometries[updateIndex - 1];
 				grid.voxelizeMesh[i].update(g, (UINT)tiles.m_renderList.size(), tiles.m_renderList.data(), (UINT)tiles.m_renderList.size() * sizeof(TileData), updateCtx.frameIdx);
 
 				if (i == 3) // shadowmap uses last cascade tiles
 				{
-					auto& g = grid.geometryViews.viewGeometries[threadIndex];
+					auto& g = grid.geometryViews.viewGeometries[updateIndex];
 					grid.voxelizeMesh[3].update(g, (UINT)tiles.m_renderList.size(), tiles.m_renderList.data(), (UINT)tiles.m_renderList.size() * sizeof(TileData), updateCtx.frameIdx);
 				}
 			}
@@ -283,9 +265,9 @@ void ProgressiveTerrain::runChunkUpdateThread(UINT threadIndex)
 
 void ProgressiveTerrain::waitForChunkUpdates()
 {
-	for (auto& work : chunkUpdateThreads)
+	for (auto& job : chunkUpdateJobs)
 	{
-		WaitForSingleObject(work.eventFinish, INFINITE);
+		JobSystem::Get().wait(job);
 	}
 }
 
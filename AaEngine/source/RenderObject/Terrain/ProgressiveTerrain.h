@@ -7,6 +7,7 @@
 #include "Resources/Compute/TerrainGenerationCS.h"
 #include "Resources/Compute/TextureToMeshCS.h"
 #include "Resources/Compute/GenerateMipsComputeShader.h"
+#include "Utils/JobSystem.h"
 #include <functional>
 
 class RenderWorld;
@@ -81,23 +82,17 @@ protected:
 	void regenerateChunk(ID3D12GraphicsCommandList* commandList, int x, int y);
 
 	void dispatchChunkUpdates(const Camera& camera, const ShadowMaps& shadows, UINT frameIdx);
-	void runChunkUpdateThread(UINT threadIndex);
+	void runChunkUpdate(UINT updateIndex);
 	void waitForChunkUpdates();
 
-	struct AsyncWork
-	{
-		HANDLE eventBegin{};
-		HANDLE eventFinish{};
-		std::thread worker;
-	};
-	std::array<AsyncWork, 1 + 4 + 4> chunkUpdateThreads;
+	// main camera, 4 shadow cascades, 4 voxelize cascades
+	std::array<JobSystem::Handle, 1 + 4 + 4> chunkUpdateJobs;
 
 	struct 
 	{
 		const Camera* camera{};
 		const ShadowMaps* shadows{};
 		UINT frameIdx{};
-		bool running = true;
 	}
 	updateCtx;
 };
\ No newline at end of file
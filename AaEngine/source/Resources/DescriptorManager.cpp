@@ -1,7 +1,11 @@
 #include "Resources/DescriptorManager.h"
 #include "directx/d3dx12.h"
 #include "Resources/Textures/TextureResources.h"
+#include "Utils/Logger.h"
+#include "Utils/RenderStats.h"
+#include <algorithm>
 #include <ranges>
+#include <format>
 
 static DescriptorManager* instance = nullptr;
 
@@ -26,8 +30,10 @@ DescriptorManager& DescriptorManager::get()
 	return *instance;
 }
 
-void DescriptorManager::init(UINT maxDescriptors)
+void DescriptorManager::init(UINT count)
 {
+	maxDescriptors = count;
+
 	D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
 	heapDesc.NumDescriptors = maxDescriptors;
 	heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
@@ -76,6 +82,20 @@ UINT DescriptorManager::createTextureView(FileTexture& texture)
 	return texture.srvHeapIndex;
 }
 
+void DescriptorManager::updateTextureView(FileTexture& texture)
+{
+	if (!texture.srvHandle.ptr)
+		return;
+
+	// frames in flight still read previous descriptor, new view goes to another slot and previous is freed with delay
+	auto previousIndex = texture.srvHeapIndex;
+
+	texture.srvHandle = {};
+	createTextureView(texture);
+
+	removeDescriptorIndex(previousIndex);
+}
+
 void DescriptorManager::createTextureView(GpuTextureResource& texture, UINT mipLevels)
 {
 	if (texture.view.srvHandle.ptr)
@@ -150,6 +170,8 @@ void DescriptorManager::createUAVView(GpuTexture3D& texture)
 	auto mipLevels = texture.texture->GetDesc().MipLevels;
 	texture.uav.resize(mipLevels);
 
+	auto firstIndex = createDescriptorRange({ texture.name.c_str(), texture.texture.Get(), D3D12_SRV_DIMENSION_BUFFER }, mipLevels);
+
 	for (UINT mipLevel = 0; mipLevel < mipLevels; mipLevel++)
 	{
 		D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
@@ -159,7 +181,7 @@ void DescriptorManager::createUAVView(GpuTexture3D& texture)
 		uavDesc.Texture3D.FirstWSlice = 0;
 		uavDesc.Texture3D.WSize = -1;
 
-		auto index = createDescriptorIndex({ texture.name.c_str(), texture.texture.Get(), D3D12_SRV_DIMENSION_BUFFER });
+		auto index = firstIndex + mipLevel;
 		auto cpuHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(mainDescriptorHeap->GetCPUDescriptorHandleForHeapStart(), index
 			, device.GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV));
 
@@ -183,6 +205,8 @@ std::vector<ShaderTextureViewUAV> DescriptorManager::createUAVMips(GpuTextureRes
 	auto mipLevels = texture.texture->GetDesc().MipLevels;
 	std::vector<ShaderTextureViewUAV> uav(mipLevels);
 
+	auto firstIndex = createDescriptorRange({ texture.name.c_str(), texture.texture.Get(), D3D12_SRV_DIMENSION_BUFFER }, mipLevels);
+
 	for (UINT mipLevel = 0; mipLevel < mipLevels; mipLevel++)
 	{
 		D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
@@ -190,7 +214,7 @@ std::vector<ShaderTextureViewUAV> DescriptorManager::createUAVMips(GpuTextureRes
 		uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
 		uavDesc.Texture2D.MipSlice = mipLevel;
 
-		auto index = createDescriptorIndex({ texture.name.c_str(), texture.texture.Get(), D3D12_SRV_DIMENSION_BUFFER });
+		auto index = firstIndex + mipLevel;
 		auto cpuHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(mainDescriptorHeap->GetCPUDescriptorHandleForHeapStart(), index
 			, device.GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV));
 
@@ -367,8 +391,9 @@ void DescriptorManager::removeUAV(GpuTextureResource& texture)
 
 void DescriptorManager::removeUAV(const std::vector<ShaderTextureViewUAV>& uav)
 {
-	for (auto& u : uav)
-		removeDescriptorIndex(u.heapIndex);
+	// created as one table by createUAVMips
+	if (!uav.empty())
+		removeDescriptorRange(uav.front().heapIndex, (UINT)uav.size());
 }
 
 void DescriptorManager::removeUAV(const ShaderViewUAV& uav)
@@ -382,39 +407,151 @@ void DescriptorManager::removeDescriptorIndex(UINT index)
 		return;
 
 	descriptorsInfo[index] = {};
-	firstFreeDescriptor = min(firstFreeDescriptor, index);
+	pendingFree.push_back({ index, 1, frameCounter + FrameCount });
+}
 
-	while (index + 1 == currentDescriptorCount && descriptorsInfo[index].dimension == D3D12_SRV_DIMENSION_UNKNOWN)
-	{
-		currentDescriptorCount--;
-		index--;
-		descriptorsInfo.pop_back();
-	}
+void DescriptorManager::removeDescriptorRange(UINT index, UINT count)
+{
+	if (!index)
+		return;
+
+	std::fill_n(descriptorsInfo.begin() + index, count, DescriptorInfo{});
+	pendingFree.push_back({ index, count, frameCounter + FrameCount });
 }
 
 UINT DescriptorManager::createDescriptorIndex(const DescriptorInfo& info)
 {
-	auto r = firstFreeDescriptor;
-
-	if (firstFreeDescriptor == currentDescriptorCount)
+	if (freeSlots.empty())
 	{
-		descriptorsInfo.push_back(info);
-		firstFreeDescriptor = ++currentDescriptorCount;
-		return r;
+		// table ranges are split only when heap has no space left at the end
+		if (descriptorsInfo.size() < maxDescriptors)
+			return appendDescriptors(info, 1);
+
+		return createDescriptorRange(info, 1);
 	}
 
-	descriptorsInfo[r] = info;
+	auto index = freeSlots.back();
+	freeSlots.pop_back();
+
+	descriptorsInfo[index] = info;
+	RenderStats::Add(RenderStat::DescriptorWrites, 1);
 
-	for (UINT i = firstFreeDescriptor + 1; i <= currentDescriptorCount; i++)
+	return index;
+}
+
+UINT DescriptorManager::createDescriptorRange(const DescriptorInfo& info, UINT count)
+{
+	for (auto it = freeRanges.begin(); it != freeRanges.end(); it++)
 	{
-		if (i == currentDescriptorCount || descriptorsInfo[i].dimension == D3D12_SRV_DIMENSION_UNKNOWN)
+		if (it->count >= count)
 		{
-			firstFreeDescriptor = i;
-			break;
+			auto index = it->start;
+			it->start += count;
+			it->count -= count;
+
+			if (!it->count)
+				freeRanges.erase(it);
+
+			std::fill_n(descriptorsInfo.begin() + index, count, info);
+			RenderStats::Add(RenderStat::DescriptorWrites, count);
+
+			return index;
 		}
 	}
 
-	return r;
+	return appendDescriptors(info, count);
+}
+
+UINT DescriptorManager::appendDescriptors(const DescriptorInfo& info, UINT count)
+{
+	auto index = (UINT)descriptorsInfo.size();
+
+	if (index + count > maxDescriptors)
+	{
+		Logger::logError(std::format("Descriptor heap full, {} used of {}", getStats().used, maxDescriptors));
+		throw std::exception("Descriptor heap full");
+	}
+
+	descriptorsInfo.resize(index + count, info);
+	RenderStats::Add(RenderStat::DescriptorWrites, count);
+
+	return index;
+}
+
+void DescriptorManager::advanceFrame()
+{
+	++frameCounter;
+	while (!pendingFree.empty() && pendingFree.front().releaseOnFrame <= frameCounter)
+	{
+		auto& pending = pendingFree.front();
+
+		if (pending.count == 1)
+			freeSlots.push_back(pending.index);
+		else
+			releaseDescriptorRange(pending.index, pending.count);
+
+		pendingFree.pop_front();
+	}
+}
+
+void DescriptorManager::releaseDescriptorRange(UINT index, UINT count)
+{
+	auto it = std::lower_bound(freeRanges.begin(), freeRanges.end(), index, [](const FreeRange& r, UINT i) { return r.start < i; });
+
+	if (it != freeRanges.begin() && std::prev(it)->start + std::prev(it)->count == index)
+	{
+		it = std::prev(it);
+		it->count += count;
+	}
+	else
+		it = freeRanges.insert(it, { index, count });
+
+	if (auto next = std::next(it); next != freeRanges.end() && it->start + it->count == next->start)
+	{
+		it->count += next->count;
+		freeRanges.erase(next);
+	}
+
+	// free space at the end shrinks allocated range
+	if (it->start + it->count == descriptorsInfo.size())
+	{
+		descriptorsInfo.resize(it->start);
+		freeRanges.erase(it);
+	}
+}
+
+DescriptorManager::Stats DescriptorManager::getStats() const
+{
+	Stats stats;
+	stats.capacity = maxDescriptors;
+	stats.allocatedRange = (UINT)descriptorsInfo.size();
+	for (auto& pending : pendingFree)
+		stats.pendingFree += pending.count;
+
+	// end of heap is never fragmented
+	stats.largestFreeRange = maxDescriptors - stats.allocatedRange;
+	stats.free = (UINT)freeSlots.size();
+	if (!freeSlots.empty())
+		stats.largestFreeRange = max(stats.largestFreeRange, 1u);
+
+	for (auto& r : freeRanges)
+	{
+		stats.free += r.count;
+		stats.largestFreeRange = max(stats.largestFreeRange, r.count);
+	}
+
+	stats.used = stats.allocatedRange - stats.free - stats.pendingFree;
+
+	return stats;
+}
+
+void DescriptorManager::logReport() const
+{
+	auto stats = getStats();
+	const UINT holes = stats.free + stats.pendingFree;
+
+	Logger::log(std::format("Descriptors: {} used of {}, allocated range {}, {} free holes ({:.1f}% fragmentation), {} pending free, largest free range {}",
+		stats.used, stats.capacity, stats.allocatedRange, holes, stats.allocatedRange ? 100.f * holes / stats.allocatedRange : 0.f, stats.pendingFree, stats.largestFreeRange));
 }
 
 void DescriptorManager::initializeSamplers(float MipLODBias)
@@ -2,6 +2,7 @@
 
 #include <d3d12.h>
 #include <initializer_list>
+#include <deque>
 #include "RenderCore/GpuTexture.h"
 
 struct Texture;
@@ -22,6 +23,8 @@ public:
 	void initializeSamplers(float MipLODBias);
 
 	UINT createTextureView(FileTexture& texture);
+	// moves view to new descriptor after texture resource was replaced, previous one is kept for frames in flight
+	void updateTextureView(FileTexture& texture);
 	void createTextureView(GpuTextureResource& texture, UINT mipLevels = -1);
 	void createTextureView(GpuTexture3D& texture, UINT mipLevels = -1);
 	void createTextureView(RenderTargetTextures& textures);
@@ -53,6 +56,21 @@ public:
 	void removeUAV(const ShaderViewUAV&);
 	void removeUAV(const std::vector<ShaderTextureViewUAV>&);
 
+	// removed descriptors are reused only after frames which could use them finished
+	void advanceFrame();
+
+	struct Stats
+	{
+		UINT capacity{};
+		UINT used{};
+		UINT allocatedRange{};
+		UINT free{};
+		UINT pendingFree{};
+		UINT largestFreeRange{};
+	};
+	Stats getStats() const;
+	void logReport() const;
+
 private:
 
 	std::vector<DescriptorInfo> descriptorsInfo;
@@ -60,7 +78,33 @@ private:
 	ID3D12Device& device;
 
 	void removeDescriptorIndex(UINT idx);
+	void removeDescriptorRange(UINT index, UINT count);
+	// single descriptor from free slots, O(1)
 	UINT createDescriptorIndex(const DescriptorInfo&);
-	UINT firstFreeDescriptor = 0;
-	UINT currentDescriptorCount = 0;
+	// contiguous indices for descriptor tables, first fit from free ranges or end of allocated range
+	UINT createDescriptorRange(const DescriptorInfo&, UINT count);
+	UINT appendDescriptors(const DescriptorInfo&, UINT count);
+	void releaseDescriptorRange(UINT index, UINT count);
+
+	UINT maxDescriptors = 0;
+
+	// freed single descriptors, kept apart from tables so view churn doesn't fragment ranges
+	std::vector<UINT> freeSlots;
+
+	// freed descriptor tables, sorted by start, neighbours are always merged
+	struct FreeRange
+	{
+		UINT start;
+		UINT count;
+	};
+	std::vector<FreeRange> freeRanges;
+
+	struct PendingFree
+	{
+		UINT index;
+		UINT count;
+		uint64_t releaseOnFrame;
+	};
+	std::deque<PendingFree> pendingFree;
+	uint64_t frameCounter = 0;
 };
\ No newline at end of file
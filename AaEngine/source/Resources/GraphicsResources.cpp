@@ -2,10 +2,11 @@
 #include "App/Directories.h"
 
 GraphicsResources::GraphicsResources(RenderSystem& rs)
-	: descriptors(*rs.core.device), shaderBuffers(*rs.core.device), materials(rs, *this), models(rs), shaderDefines(*this), shaders(shaderDefines)
+	: descriptors(*rs.core.device), shaderBuffers(*rs.core.device), materials(rs, *this), textureStreaming(rs), models(rs), shaderDefines(*this), shaders(shaderDefines)
 {
 	descriptors.init(10000);
 	descriptors.initializeSamplers(rs.upscale.getMipLodBias());
+	textures.streaming = &textureStreaming;
 
 	shaders.loadShaderReferences(SHADER_DIRECTORY);
 	materials.loadMaterials(MATERIAL_DIRECTORY);
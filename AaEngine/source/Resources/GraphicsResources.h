@@ -6,6 +6,7 @@
 #include "Resources/Shader/ShaderDefines.h"
 #include "Resources/Material/MaterialResources.h"
 #include "Resources/Model/ModelResources.h"
+#include "Resources/Textures/TextureStreaming.h"
 
 class RenderSystem;
 
@@ -18,6 +19,7 @@ struct GraphicsResources
 	ShaderDefines shaderDefines;
 	ShaderLibrary shaders;
 	TextureResources textures;
+	TextureStreaming textureStreaming;
 	MaterialResources materials;
 	ModelResources models;
 };
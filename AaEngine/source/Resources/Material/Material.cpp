@@ -5,6 +5,7 @@
 #include "Scene/Camera.h"
 #include "Scene/RenderEntity.h"
 #include "Resources/Shader/ShaderLibrary.h"
+#include "Resources/Model/VertexQuantization.h"
 #include "Resources/Textures/TextureResources.h"
 #include "Utils/Logger.h"
 #include <sstream>
@@ -36,6 +37,8 @@ void MaterialBase::Load(ShaderLibrary& shaderLib)
 	if (rootSignature)
 		return;
 
+	shaderLibrary = &shaderLib;
+
 	for (auto type : ShaderTypes())
 	{
 		if (auto& shaderName = ref.pipeline.shaders[type]; !shaderName.empty())
@@ -50,9 +53,9 @@ void MaterialBase::Load(ShaderLibrary& shaderLib)
 	rootSignature = info.createRootSignature(device, as_wstring(ref.name).c_str(), ref.resources.samplers);
 }
 
-void MaterialBase::BindSignature(ID3D12GraphicsCommandList* commandList) const
+void MaterialBase::BindSignature(GraphicsCommands& commands) const
 {
-	commandList->SetGraphicsRootSignature(rootSignature);
+	commands.SetGraphicsRootSignature(rootSignature);
 }
 
 ID3D12RootSignature* MaterialBase::GetSignature() const
@@ -70,7 +73,7 @@ std::size_t HashInputLayout(const std::vector<D3D12_INPUT_ELEMENT_DESC>& layout,
 
 		std::hash<std::uint32_t> hashUint32;
  		seed ^= hashUint32(element.SemanticIndex) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-// 		seed ^= hashUint32(element.Format) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		seed ^= hashUint32(element.Format) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 // 		seed ^= hashUint32(element.AlignedByteOffset) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 	}
 	for (const auto& t : target)
@@ -163,8 +166,8 @@ ID3D12PipelineState* MaterialBase::CreatePipelineState(const std::vector<D3D12_I
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
 	psoDesc.InputLayout = { layout.empty() ? nullptr : layout.data(), (UINT)layout.size() };
 	psoDesc.pRootSignature = rootSignature;
-	if (shaders[ShaderType::Vertex])
-		psoDesc.VS = { shaders[ShaderType::Vertex]->blob->GetBufferPointer(), shaders[ShaderType::Vertex]->blob->GetBufferSize() };
+	if (auto vertexShader = GetVertexShader(layout))
+		psoDesc.VS = { vertexShader->blob->GetBufferPointer(), vertexShader->blob->GetBufferSize() };
 	if (shaders[ShaderType::Geometry])
 		psoDesc.GS = { shaders[ShaderType::Geometry]->blob->GetBufferPointer(), shaders[ShaderType::Geometry]->blob->GetBufferSize() };
 	if (shaders[ShaderType::Pixel])
@@ -181,6 +184,36 @@ ID3D12PipelineState* MaterialBase::CreatePipelineState(const std::vector<D3D12_I
 	return pipelineState;
 }
 
+const LoadedShader* MaterialBase::GetVertexShader(const std::vector<D3D12_INPUT_ELEMENT_DESC>& layout) const
+{
+	auto shader = shaders[ShaderType::Vertex];
+	if (!shader || !shaderLibrary)
+		return shader;
+
+	// packed vertex formats are decoded by shader variant with matching defines
+	auto packedDefines = VertexQuantization::GetLayoutDefines(layout);
+	if (packedDefines.empty())
+		return shader;
+
+	auto variantRef = shader->ref;
+	auto variantName = ref.pipeline.shaders[ShaderType::Vertex];
+
+	for (auto& define : packedDefines)
+	{
+		variantName += ":" + define.first;
+		variantRef.defines.push_back(define);
+	}
+
+	auto variant = shaderLibrary->getShader(variantName, ShaderType::Vertex, variantRef);
+	if (!variant || !variant->blob)
+	{
+		Logger::logError("Failed to create packed vertex variant " + variantName);
+		return shader;
+	}
+
+	return variant;
+}
+
 ID3D12PipelineState* MaterialBase::CreatePipelineStateMS(const std::vector<DXGI_FORMAT>& target, const TechniqueProperties& technique)
 {
 	D3DX12_MESH_SHADER_PIPELINE_STATE_DESC psoDesc = {};
@@ -377,7 +410,7 @@ void MaterialBase::CreateResourcesData(MaterialInstance& instance, GraphicsResou
 	{
 		if (!t.file.empty())
 		{
-			auto texture = resources.textures.loadFile(device, batch, t.file, { .forceSrgb = t.forceSrgb });
+			auto texture = resources.textures.loadFile(device, batch, t.file, { .forceSrgb = t.forceSrgb, .streaming = true, .compression = t.compression });
 			resources.descriptors.createTextureView(*texture);
 
 			instance.SetTexture(*texture, texSlot);
@@ -475,6 +508,11 @@ void MaterialInstance::SetTexture(ShaderTextureView& texture, const std::string&
 	}
 }
 
+UINT MaterialInstance::GetTexturesCount() const
+{
+	return (UINT)resources->textures.size();
+}
+
 ShaderTextureView* MaterialInstance::GetTexture(UINT slot) const
 {
 	return resources->textures[slot].texture;
@@ -660,7 +698,8 @@ bool MaterialInstance::GetParameter(const std::string& name, float* output) cons
 
 void MaterialInstance::LoadMaterialConstants(MaterialDataStorage& data) const
 {
-	data.rootParams = resources->rootBuffer.defaultData;
+	auto& defaultData = resources->rootBuffer.defaultData;
+	data.rootParams = FrameVector<float>(defaultData.begin(), defaultData.end());
 }
 
 void MaterialInstance::UpdatePerFrame(MaterialDataStorage& data, const ShaderConstantsProvider& info)
@@ -752,37 +791,37 @@ void MaterialInstance::UpdateBindlessTexture(const ResourcesInfo::Texture& textu
 	*(UINT*)&buff[param.bufferOffset] = texture.texture->srvHeapIndex;
 }
 
-void MaterialInstance::BindTextures(ID3D12GraphicsCommandList* commandList)
+void MaterialInstance::BindTextures(GraphicsCommands& commands)
 {
 	for (UINT i = 0; i < resources->boundTexturesCount; i++)
 	{
 		auto& t = resources->textures[i];
-		commandList->SetGraphicsRootDescriptorTable(t.rootIndex, t.texture->srvHandle);
+		commands.SetGraphicsRootDescriptorTable(t.rootIndex, t.texture->srvHandle);
 	}
 
 	for (auto& uav : resources->uavs)
-		commandList->SetGraphicsRootUnorderedAccessView(uav.rootIndex, uav.uav->GetGPUVirtualAddress());
+		commands.SetGraphicsRootUnorderedAccessView(uav.rootIndex, uav.uav->GetGPUVirtualAddress());
 }
 
-void MaterialInstance::BindConstants(ID3D12GraphicsCommandList* commandList, const MaterialDataStorage& data, const ShaderConstantsProvider& constants)
+void MaterialInstance::BindConstants(GraphicsCommands& commands, const MaterialDataStorage& data, const ShaderConstantsProvider& constants)
 {
 	if (data.rootParams.size())
-		commandList->SetGraphicsRoot32BitConstants(resources->rootBuffer.rootIndex, data.rootParams.size(), data.rootParams.data(), 0);
+		commands.SetGraphicsRoot32BitConstants(resources->rootBuffer.rootIndex, data.rootParams.size(), data.rootParams.data(), 0);
 
 	for (auto& b : resources->buffers)
 	{
 		if (b.type == GpuBufferType::Instancing || b.type == GpuBufferType::Geometry)
-			commandList->SetGraphicsRootShaderResourceView(b.rootIndex, constants.getGeometryBuffer());
+			commands.SetGraphicsRootShaderResourceView(b.rootIndex, constants.getGeometryBuffer());
 		else if (b.type == GpuBufferType::Redirect)
-			commandList->SetGraphicsRootShaderResourceView(b.rootIndex, constants.getGeometryRedirectBuffer());
+			commands.SetGraphicsRootShaderResourceView(b.rootIndex, constants.getGeometryRedirectBuffer());
 		else if (b.type == GpuBufferType::CBuffer)
-			commandList->SetGraphicsRootConstantBufferView(b.rootIndex, b.data.cbuffer.data[constants.params.frameIndex]->GpuAddress());
+			commands.SetGraphicsRootConstantBufferView(b.rootIndex, b.data.cbuffer.data[constants.params.frameIndex]->GpuAddress());
 		else if (b.type == GpuBufferType::GpuMemory)
-			commandList->SetGraphicsRootShaderResourceView(b.rootIndex, b.data.gpuMemory.data->addr);
+			commands.SetGraphicsRootShaderResourceView(b.rootIndex, b.data.gpuMemory.data->addr);
 	}
 }
 
-void AssignedMaterial::BindPipeline(ID3D12GraphicsCommandList* commandList)
+void AssignedMaterial::BindPipeline(GraphicsCommands& commands)
 {
-	commandList->SetPipelineState(pipelineState);
+	commands.SetPipelineState(pipelineState);
 }
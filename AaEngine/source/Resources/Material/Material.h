@@ -11,6 +11,8 @@
 #include "Resources/Shader/ShaderLibrary.h"
 #include "Resources/Shader/ShaderResources.h"
 #include "Resources/Shader/ShaderSignature.h"
+#include "RenderCore/GraphicsCommands.h"
+#include "Utils/FrameArena.h"
 #include <map>
 #include <array>
 
@@ -26,7 +28,8 @@ struct GraphicsResources;
 
 struct MaterialDataStorage
 {
-	std::vector<float> rootParams;
+	// filled per frame by LoadMaterialConstants
+	FrameVector<float> rootParams;
 };
 
 class MaterialBase
@@ -38,7 +41,7 @@ public:
 
 	void Load(ShaderLibrary& shaderLib);
 
-	void BindSignature(ID3D12GraphicsCommandList* commandList) const;
+	void BindSignature(GraphicsCommands& commands) const;
 	ID3D12RootSignature* GetSignature() const;
 
 	AssignedMaterial* GetAssignedMaterial(MaterialInstance* instance, const std::vector<D3D12_INPUT_ELEMENT_DESC>& layout, const std::vector<DXGI_FORMAT>& target, MaterialTechnique technique);
@@ -74,6 +77,8 @@ private:
 	ID3D12PipelineState* GetPipelineState(const std::vector<D3D12_INPUT_ELEMENT_DESC>& layout, const std::vector<DXGI_FORMAT>& target, MaterialTechnique);
 	ID3D12PipelineState* CreatePipelineState(const std::vector<D3D12_INPUT_ELEMENT_DESC>& layout, const std::vector<DXGI_FORMAT>& target, const TechniqueProperties&);
 	ID3D12PipelineState* CreatePipelineStateMS(const std::vector<DXGI_FORMAT>& target, const TechniqueProperties&);
+	const LoadedShader* GetVertexShader(const std::vector<D3D12_INPUT_ELEMENT_DESC>& layout) const;
+	ShaderLibrary* shaderLibrary{};
 
 	struct PipelineStateData
 	{
@@ -130,6 +135,7 @@ public:
 	void SetTexture(ShaderTextureView& texture, UINT slot);
 	void SetTexture(ShaderTextureView& texture, const std::string& name);
 	ShaderTextureView* GetTexture(UINT slot) const;
+	UINT GetTexturesCount() const;
 
 	void SetUAV(ID3D12Resource* uav, UINT slot);
 
@@ -161,8 +167,8 @@ public:
 	void UpdatePerFrame(MaterialDataStorage& data, const ShaderConstantsProvider& info);
 	void UpdatePerObject(MaterialDataStorage& buffers, const ShaderConstantsProvider& info);
 
-	void BindTextures(ID3D12GraphicsCommandList* commandList);
-	void BindConstants(ID3D12GraphicsCommandList* commandList, const MaterialDataStorage& data, const ShaderConstantsProvider& buffers);
+	void BindTextures(GraphicsCommands& commands);
+	void BindConstants(GraphicsCommands& commands, const MaterialDataStorage& data, const ShaderConstantsProvider& buffers);
 
 	void SetGpuBuffer(const std::string& name, StructuredBufferData*);
 
@@ -204,7 +210,7 @@ public:
 		return pipelineState == pipeline;
 	}
 
-	void BindPipeline(ID3D12GraphicsCommandList* commandList);
+	void BindPipeline(GraphicsCommands& commands);
 
 	MaterialInstance* origin{};
 
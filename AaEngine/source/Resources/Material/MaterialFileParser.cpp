@@ -252,11 +252,14 @@ static void ParseMaterialObject(MaterialRef& mat, shaderRefMaps& shaders, const
 				{
 					tex.file = param.value;
 					tex.forceSrgb = tex.id == "Diffuse";
+					tex.compression = {};
 
 					for (auto& p : param.params)
 					{
 						if (p == "srgb")
 							tex.forceSrgb = true;
+						else if (auto compression = BlockCompression::ParseFormat(p); compression != BlockCompression::Format::None)
+							tex.compression = compression;
 					}
 				}
 				else if (param.type == "compositor" || param.type == "name")
@@ -6,6 +6,7 @@
 #include <d3d12.h>
 #include "Resources/Shader/ShaderResources.h"
 #include "Resources/Shader/ShaderFileParser.h"
+#include "Resources/Textures/BlockCompression.h"
 #include <optional>
 
 struct MaterialDepthState
@@ -24,6 +25,7 @@ struct TextureRef
 	std::string id;
 	std::string file;
 	bool forceSrgb = false;
+	BlockCompression::Format compression = BlockCompression::Format::None;
 };
 
 using SamplerRef = SamplerInfo;
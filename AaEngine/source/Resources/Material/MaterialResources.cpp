@@ -5,6 +5,7 @@
 #include "Resources/GraphicsResources.h"
 #include "App/Directories.h"
 #include "Resources/Compute/ComputeShader.h"
+#include "Resources/Shader/RootSignatureCache.h"
 
 MaterialResources::MaterialResources(RenderSystem& rs, GraphicsResources& r) : renderSystem(rs), resources(r)
 {
@@ -12,6 +13,7 @@ MaterialResources::MaterialResources(RenderSystem& rs, GraphicsResources& r) : r
 
 MaterialResources::~MaterialResources()
 {
+	RootSignatureCache::Get().clear();
 }
 
 MaterialInstance* MaterialResources::getMaterial(std::string name)
@@ -149,6 +151,7 @@ void MaterialResources::reloadShaders(const std::vector<const LoadedShader*>& sh
 	}
 
 	ComputeShaderLibrary::Reload(*renderSystem.core.device, shadersChanged);
+	RootSignatureCache::Get().releaseUnused();
 
 	if (!reloaded.empty())
 		MaterialEvents::Get().notifyReloaded(reloaded);
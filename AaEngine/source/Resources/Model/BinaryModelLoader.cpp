@@ -1,13 +1,16 @@
 #include "Resources/Model/BinaryModelLoader.h"
 #include "Resources/Model/BinaryModelSerialization.h"
+#include "Resources/Model/MeshletBuilder.h"
 #include "Utils/Logger.h"
+#include "Utils/MappedFile.h"
 #include "Math.h"
 
 VertexBufferModel* BinaryModelLoader::load(std::string filename, ModelParseOptions options)
 {
-	ModelInfo info;
+	MappedFile file;
+	ModelView info;
 
-	if (!BinaryModelSerialization::ReadModel(filename, info))
+	if (!file.open(filename) || !BinaryModelSerialization::ReadModel(file.data(), info))
 	{
 		Logger::logError("Failed to load model " + filename);
 		return nullptr;
@@ -17,21 +20,59 @@ VertexBufferModel* BinaryModelLoader::load(std::string filename, ModelParseOptio
 
 	for (auto& element : info.layout)
 	{
-		model->addLayoutElement(element.format, VertexElementSemantic::GetConstName(element.semantic));
+		model->addLayoutElement(element.format, VertexElementSemantic::GetConstName(std::string(element.semantic, strnlen(element.semantic, std::size(element.semantic)))));
 	}
 
 	auto vertexSize = model->getLayoutVertexSize(0);
 
-	model->calculateBounds(info.vertexData.data(), info.vertexCount, vertexSize, model->vertexLayout);
+	if (!vertexSize || info.vertexData.size() < size_t(info.vertexCount) * vertexSize)
+	{
+		Logger::logError("Invalid vertex data in model " + filename);
+		delete model;
+		return nullptr;
+	}
+
+	if (info.bounds)
+		model->bbox = BoundingBoxVolume(Vector3(info.bounds->min), Vector3(info.bounds->max)).createBbox();
+	else
+		model->calculateBounds(info.vertexData.data(), info.vertexCount, vertexSize, model->vertexLayout);
 
+	// upload straight from mapped file memory
 	if (info.indexCount)
 	{
 		model->indexCount = info.indexCount;
-		model->CreateIndexBuffer(options.device, options.batch, info.indices.data(), info.indices.size());
+
+		if (info.indexSize == sizeof(uint32_t))
+			model->CreateIndexBuffer(options.device, options.batch, (const uint32_t*)info.indexData.data(), info.indexCount);
+		else
+			model->CreateIndexBuffer(options.device, options.batch, (const uint16_t*)info.indexData.data(), info.indexCount);
 	}
 
 	model->vertexCount = info.vertexCount;
 	model->CreateVertexBuffer(options.device, options.batch, info.vertexData.data(), info.vertexCount, vertexSize);
 
+	for (auto& submesh : info.submeshes)
+	{
+		model->submeshes.emplace_back(submesh.indexStart, submesh.indexCount, std::string(submesh.material, strnlen(submesh.material, std::size(submesh.material))));
+	}
+	for (auto& lod : info.lods)
+	{
+		model->lods.emplace_back(lod.indexStart, lod.indexCount, lod.distance);
+	}
+
+	if (!info.meshlets.empty() && info.meshletBounds.size() == info.meshlets.size())
+	{
+		model->meshlets.meshlets.assign(info.meshlets.begin(), info.meshlets.end());
+		model->meshlets.bounds.assign(info.meshletBounds.begin(), info.meshletBounds.end());
+		model->meshlets.vertices.assign(info.meshletVertices.begin(), info.meshletVertices.end());
+		model->meshlets.triangles.assign(info.meshletTriangles.begin(), info.meshletTriangles.end());
+	}
+	else
+	{
+		// files saved before meshlets were part of import, built in memory and file is left untouched, export again to store them
+		Logger::log("Building meshlets of model " + filename);
+		model->meshlets = MeshletBuilder::build(*model);
+	}
+
 	return model;
 }
@@ -1,74 +1,286 @@
 #include "Resources/Model/BinaryModelSerialization.h"
+#include "Utils/MappedFile.h"
+#include "Utils/Compression.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
 
-bool BinaryModelSerialization::SaveModel(const std::string& filename, const ModelInfo& model)
+static uint32_t AlignChunk(uint32_t size)
 {
-	std::ofstream file(filename, std::ios::binary);
-	{
-		Header h{ .dataType = HeaderType::Metadata, .dataSize = sizeof(MetadataObject) };
-		file.write((const char*)&h, h.headerSize);
+	return (size + BinaryModelSerialization::ChunkAlignment - 1) & ~(BinaryModelSerialization::ChunkAlignment - 1);
+}
 
-		MetadataObject data{ model.indexCount, model.vertexCount };
-		file.write((const char*)&data, h.dataSize);
-	}
-	if (!model.layout.empty())
-	{
-		Header h{ .dataType = HeaderType::Layout, .dataSize = (uint32_t)(model.layout.size() * sizeof(VertexLayoutElement)) };
-		file.write((const char*)&h, h.headerSize);
-		file.write((const char*)model.layout.data(), h.dataSize);
-	}
-	if (!model.vertexData.empty())
+static void WriteRawChunk(std::ofstream& file, uint32_t type, const void* data, uint32_t dataSize)
+{
+	BinaryModelSerialization::Header h{ .dataType = type, .dataSize = dataSize };
+	file.write((const char*)&h, h.headerSize);
+	file.write((const char*)data, dataSize);
+
+	const char padding[BinaryModelSerialization::ChunkAlignment]{};
+	file.write(padding, AlignChunk(dataSize) - dataSize);
+}
+
+static void WriteChunk(std::ofstream& file, BinaryModelSerialization::HeaderType type, const void* data, size_t dataSize, bool compress)
+{
+	if (compress)
 	{
-		Header h{ .dataType = HeaderType::Vertices, .dataSize = (uint32_t)model.vertexData.size() };
-		file.write((const char*)&h, h.headerSize);
-		file.write(model.vertexData.data(), h.dataSize);
+		auto compressed = Compression::compressLz4({ (const uint8_t*)data, dataSize });
+
+		// not worth it for incompressible data
+		if (compressed.size() + sizeof(uint32_t) < dataSize)
+		{
+			const uint32_t uncompressedSize = (uint32_t)dataSize;
+			compressed.insert(compressed.begin(), (const uint8_t*)&uncompressedSize, (const uint8_t*)&uncompressedSize + sizeof(uncompressedSize));
+
+			WriteRawChunk(file, type | BinaryModelSerialization::CompressedLz4Flag, compressed.data(), (uint32_t)compressed.size());
+			return;
+		}
 	}
-	if (!model.indices.empty())
+
+	WriteRawChunk(file, type, data, (uint32_t)dataSize);
+}
+
+template<typename T>
+static void WriteChunk(std::ofstream& file, BinaryModelSerialization::HeaderType type, const std::vector<T>& data, bool compress = false)
+{
+	if (!data.empty())
+		WriteChunk(file, type, data.data(), data.size() * sizeof(T), compress);
+}
+
+bool BinaryModelSerialization::SaveModel(const std::string& filename, const ModelInfo& model)
+{
+	const bool shortIndices = std::all_of(model.indices.begin(), model.indices.end(), [](uint32_t i) { return i <= UINT16_MAX; });
+
+	std::ofstream file(filename, std::ios::binary);
 	{
-		Header h{ .dataType = HeaderType::Indices, .dataSize = (uint32_t)model.indices.size() * sizeof(uint16_t) };
-		file.write((const char*)&h, h.headerSize);
-		file.write((const char*)model.indices.data(), h.dataSize);
+		MetadataObject data{ model.indexCount, model.vertexCount, uint32_t(shortIndices ? sizeof(uint16_t) : sizeof(uint32_t)) };
+		WriteRawChunk(file, HeaderType::Metadata, &data, sizeof(data));
 	}
 
+	WriteChunk(file, HeaderType::Layout, model.layout);
+	WriteChunk(file, HeaderType::Vertices, model.vertexData, model.compress);
+
+	if (shortIndices)
+		WriteChunk(file, HeaderType::Indices, std::vector<uint16_t>(model.indices.begin(), model.indices.end()), model.compress);
+	else
+		WriteChunk(file, HeaderType::Indices, model.indices, model.compress);
+
+	WriteChunk(file, HeaderType::Submeshes, model.submeshes);
+	if (model.bounds)
+		WriteRawChunk(file, HeaderType::Bounds, &*model.bounds, sizeof(ModelBounds));
+	WriteChunk(file, HeaderType::LodRanges, model.lods);
+
+	WriteChunk(file, HeaderType::Meshlets, model.meshlets.meshlets);
+	WriteChunk(file, HeaderType::MeshletBounds, model.meshlets.bounds);
+	WriteChunk(file, HeaderType::MeshletVertices, model.meshlets.vertices, model.compress);
+	WriteChunk(file, HeaderType::MeshletTriangles, model.meshlets.triangles, model.compress);
+
 	return !file.fail();
 }
 
 bool BinaryModelSerialization::ReadModel(const std::string& filename, ModelInfo& model)
 {
-	std::ifstream file(filename, std::ios::binary);
+	MappedFile file;
+	if (!file.open(filename))
+		return false;
+
+	ModelView view;
+	if (!ReadModel(file.data(), view))
+		return false;
+
+	model.layout.assign(view.layout.begin(), view.layout.end());
+	model.vertexData.assign(view.vertexData.begin(), view.vertexData.end());
+	model.indexCount = view.indexCount;
+	model.vertexCount = view.vertexCount;
 
-	while (file)
+	model.indices.resize(view.indexData.size() / view.indexSize);
+	for (size_t i = 0; i < model.indices.size(); i++)
+	{
+		if (view.indexSize == sizeof(uint16_t))
+			model.indices[i] = ((const uint16_t*)view.indexData.data())[i];
+		else
+			model.indices[i] = ((const uint32_t*)view.indexData.data())[i];
+	}
+
+	model.submeshes.assign(view.submeshes.begin(), view.submeshes.end());
+	if (view.bounds)
+		model.bounds = *view.bounds;
+	model.lods.assign(view.lods.begin(), view.lods.end());
+
+	model.meshlets.meshlets.assign(view.meshlets.begin(), view.meshlets.end());
+	model.meshlets.bounds.assign(view.meshletBounds.begin(), view.meshletBounds.end());
+	model.meshlets.vertices.assign(view.meshletVertices.begin(), view.meshletVertices.end());
+	model.meshlets.triangles.assign(view.meshletTriangles.begin(), view.meshletTriangles.end());
+
+	return true;
+}
+
+template<typename T>
+static std::span<const T> ViewChunk(const uint8_t* data, uint32_t dataSize)
+{
+	if (dataSize % sizeof(T) || (uintptr_t)data % alignof(T))
+		return {};
+
+	return { (const T*)data, dataSize / sizeof(T) };
+}
+
+bool BinaryModelSerialization::ReadModel(std::span<const uint8_t> data, ModelView& model)
+{
+	size_t offset = 0;
+
+	while (offset < data.size())
 	{
 		Header h;
-		file.read((char*)&h.headerSize, sizeof(h.headerSize));
-		file.read((char*)&h.dataType, h.headerSize - sizeof(h.headerSize));
+		if (data.size() - offset < sizeof(h.headerSize))
+			break;
+
+		memcpy(&h.headerSize, data.data() + offset, sizeof(h.headerSize));
+
+		if (h.headerSize < sizeof(Header) || h.headerSize > data.size() - offset)
+		{
+			Logger::logWarning("Invalid model chunk header size " + std::to_string(h.headerSize));
+			return false;
+		}
+
+		memcpy(&h, data.data() + offset, sizeof(Header));
+		offset += h.headerSize;
+
+		if (h.version < 2 || h.version > CurrentVersion)
+		{
+			Logger::logWarning("Unsupported model version " + std::to_string(h.version));
+			return false;
+		}
+
+		if (h.dataSize > data.size() - offset)
+		{
+			Logger::logWarning("Model chunk size " + std::to_string(h.dataSize) + " exceeds file size");
+			return false;
+		}
+
+		auto chunk = data.data() + offset;
+		offset += std::min<size_t>(AlignChunk(h.dataSize), data.size() - offset);
 
 		if (!h.dataSize)
 			continue;
 
+		if (h.dataType & CompressedLz4Flag)
+		{
+			uint32_t uncompressedSize{};
+			if (h.dataSize < sizeof(uncompressedSize))
+				return false;
+
+			memcpy(&uncompressedSize, chunk, sizeof(uncompressedSize));
+
+			auto& unpacked = model.unpacked.emplace_back(uncompressedSize);
+			if (!Compression::decompressLz4({ chunk + sizeof(uncompressedSize), h.dataSize - sizeof(uncompressedSize) }, unpacked))
+			{
+				Logger::logWarning("Failed to decompress model chunk");
+				return false;
+			}
+
+			chunk = unpacked.data();
+			h.dataSize = uncompressedSize;
+			h.dataType &= ~CompressedLz4Flag;
+		}
+
 		if (h.dataType == HeaderType::Metadata)
 		{
+			if (h.dataSize < offsetof(MetadataObject, indexSize))
+				return false;
+
 			MetadataObject obj;
-			file.read((char*)&obj, h.dataSize);
+			memcpy(&obj, chunk, std::min<size_t>(h.dataSize, sizeof(obj)));
+
+			if (obj.indexSize != sizeof(uint16_t) && obj.indexSize != sizeof(uint32_t))
+				return false;
 
 			model.indexCount = obj.indexCount;
 			model.vertexCount = obj.vertexCount;
+			model.indexSize = obj.indexSize;
 		}
 		else if (h.dataType == HeaderType::Layout)
 		{
-			model.layout.resize(h.dataSize / sizeof(VertexLayoutElement));
-			file.read((char*)model.layout.data(), h.dataSize);
+			model.layout = ViewChunk<VertexLayoutElement>(chunk, h.dataSize);
+			if (model.layout.empty())
+				return false;
 		}
 		else if (h.dataType == HeaderType::Vertices)
 		{
-			model.vertexData.resize(h.dataSize);
-			file.read(model.vertexData.data(), h.dataSize);
+			model.vertexData = ViewChunk<char>(chunk, h.dataSize);
 		}
 		else if (h.dataType == HeaderType::Indices)
 		{
-			model.indices.resize(h.dataSize / sizeof(uint16_t));
-			file.read((char*)model.indices.data(), h.dataSize);
+			model.indexData = ViewChunk<uint8_t>(chunk, h.dataSize);
+		}
+		else if (h.dataType == HeaderType::Submeshes)
+		{
+			model.submeshes = ViewChunk<ModelSubmesh>(chunk, h.dataSize);
+		}
+		else if (h.dataType == HeaderType::Bounds)
+		{
+			if (auto bounds = ViewChunk<ModelBounds>(chunk, h.dataSize); !bounds.empty())
+				model.bounds = bounds.data();
 		}
+		else if (h.dataType == HeaderType::LodRanges)
+		{
+			model.lods = ViewChunk<ModelLodRange>(chunk, h.dataSize);
+		}
+		else if (h.dataType == HeaderType::Meshlets)
+		{
+			model.meshlets = ViewChunk<ModelMeshlet>(chunk, h.dataSize);
+		}
+		else if (h.dataType == HeaderType::MeshletVertices)
+		{
+			model.meshletVertices = ViewChunk<uint32_t>(chunk, h.dataSize);
+		}
+		else if (h.dataType == HeaderType::MeshletTriangles)
+		{
+			model.meshletTriangles = ViewChunk<uint8_t>(chunk, h.dataSize);
+		}
+		else if (h.dataType == HeaderType::MeshletBounds)
+		{
+			model.meshletBounds = ViewChunk<ModelMeshletBounds>(chunk, h.dataSize);
+		}
+	}
+
+	// index chunk type depends on metadata, validate once everything is read
+	if (model.indexData.size() % model.indexSize || (uintptr_t)model.indexData.data() % model.indexSize)
+		return false;
+
+	const size_t indicesCount = model.indexData.size() / model.indexSize;
+	if (indicesCount < model.indexCount)
+		return false;
+
+	for (auto& submesh : model.submeshes)
+	{
+		if (size_t(submesh.indexStart) + submesh.indexCount > indicesCount)
+			return false;
+	}
+	for (auto& lod : model.lods)
+	{
+		if (size_t(lod.indexStart) + lod.indexCount > indicesCount)
+			return false;
+	}
+
+	if (!model.meshletBounds.empty() && model.meshletBounds.size() != model.meshlets.size())
+		return false;
+	for (auto& meshlet : model.meshlets)
+	{
+		if (size_t(meshlet.vertexOffset) + meshlet.vertexCount > model.meshletVertices.size())
+			return false;
+		if (size_t(meshlet.triangleOffset) + meshlet.triangleCount * 3 > model.meshletTriangles.size())
+			return false;
+
+		for (size_t i = 0; i < meshlet.triangleCount * 3; i++)
+			if (model.meshletTriangles[meshlet.triangleOffset + i] >= meshlet.vertexCount)
+				return false;
+	}
+	for (auto vertex : model.meshletVertices)
+	{
+		if (vertex >= model.vertexCount)
+			return false;
 	}
 
-	return file.eof();
+	return !model.vertexData.empty();
 }
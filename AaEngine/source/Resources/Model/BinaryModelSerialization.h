@@ -4,6 +4,8 @@
 #include <fstream>
 #include <d3d12.h>
 #include <cstdint>
+#include <span>
+#include <optional>
 
 struct VertexLayoutElement
 {
@@ -11,14 +13,93 @@ struct VertexLayoutElement
 	char semantic[16];
 };
 
+struct ModelSubmesh
+{
+	uint32_t indexStart{};
+	uint32_t indexCount{};
+	char material[64]{};
+};
+
+struct ModelBounds
+{
+	float min[3]{};
+	float max[3]{};
+};
+
+struct ModelLodRange
+{
+	uint32_t indexStart{};
+	uint32_t indexCount{};
+	float distance{};
+};
+
+struct ModelMeshlet
+{
+	uint32_t vertexOffset{};
+	uint32_t vertexCount{};
+	uint32_t triangleOffset{};
+	uint32_t triangleCount{};
+};
+
+// culling data, backfacing when dot(normalize(coneApex - cameraPosition), coneAxis) >= coneCutoff
+struct ModelMeshletBounds
+{
+	float center[3]{};
+	float radius{};
+	float coneApex[3]{};
+	float coneCutoff = 1.0f;
+	float coneAxis[3]{};
+	float reserved{};
+};
+
+struct ModelMeshlets
+{
+	std::vector<ModelMeshlet> meshlets;
+	std::vector<ModelMeshletBounds> bounds;
+	std::vector<uint32_t> vertices;
+	// 3 local vertex indices per triangle, each meshlet starts 4 byte aligned
+	std::vector<uint8_t> triangles;
+};
+
 struct ModelInfo
 {
 	std::vector<VertexLayoutElement> layout;
 	std::vector<char> vertexData;
 
-	std::vector<uint16_t> indices;
+	std::vector<uint32_t> indices;
+	uint32_t indexCount{};
+	uint32_t vertexCount{};
+
+	std::vector<ModelSubmesh> submeshes;
+	std::optional<ModelBounds> bounds;
+	std::vector<ModelLodRange> lods;
+	ModelMeshlets meshlets;
+
+	// LZ4 compress vertex and index chunks
+	bool compress = false;
+};
+
+// Model data pointing into loaded file memory, only compressed chunks are unpacked into own storage
+struct ModelView
+{
+	std::span<const VertexLayoutElement> layout;
+	std::span<const char> vertexData;
+
+	std::span<const uint8_t> indexData;
+	uint32_t indexSize = sizeof(uint16_t);
 	uint32_t indexCount{};
 	uint32_t vertexCount{};
+
+	std::span<const ModelSubmesh> submeshes;
+	const ModelBounds* bounds{};
+	std::span<const ModelLodRange> lods;
+
+	std::span<const ModelMeshlet> meshlets;
+	std::span<const ModelMeshletBounds> meshletBounds;
+	std::span<const uint32_t> meshletVertices;
+	std::span<const uint8_t> meshletTriangles;
+
+	std::vector<std::vector<uint8_t>> unpacked;
 };
 
 namespace BinaryModelSerialization
@@ -29,20 +110,42 @@ namespace BinaryModelSerialization
 		Vertices,
 		Indices,
 		Metadata,
+		// version 3
+		Submeshes,
+		Bounds,
+		LodRanges,
+		Meshlets,
+		MeshletVertices,
+		MeshletTriangles,
+		MeshletBounds,
 	};
+	// set in dataType of chunks stored compressed, data starts with uncompressed size
+	constexpr uint32_t CompressedLz4Flag = 0x100;
+
+	constexpr uint32_t CurrentVersion = 3;
+
 	struct Header
 	{
 		uint32_t headerSize = sizeof(Header);
 		uint32_t dataType{};
 		uint32_t dataSize{};
-		uint32_t version = 2;
+		uint32_t version = CurrentVersion;
 	};
 	struct MetadataObject
 	{
 		uint32_t indexCount{};
 		uint32_t vertexCount{};
+		// version 3
+		uint32_t indexSize = sizeof(uint16_t);
+		uint32_t reserved{};
 	};
 
+	// chunk data starts aligned, so it can be viewed in place
+	constexpr uint32_t ChunkAlignment = 4;
+
 	bool SaveModel(const std::string& filename, const ModelInfo& model);
 	bool ReadModel(const std::string& filename, ModelInfo& model);
+
+	// validates chunks and points view into data, versions 2 and 3 are supported
+	bool ReadModel(std::span<const uint8_t> data, ModelView& model);
 }
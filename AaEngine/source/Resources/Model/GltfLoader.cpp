@@ -1,6 +1,13 @@
 #include "Resources/Model/GltfLoader.h"
+#include "Resources/Model/VertexQuantization.h"
+#include "Resources/Model/MeshOptimizer.h"
+#include "Resources/Model/MeshletBuilder.h"
 #include "Utils/Logger.h"
+#include "Utils/ParallelFor.h"
 #include "Math.h"
+#include <format>
+#include <chrono>
+#include <DirectXPackedVector.h>
 
 #define TINYGLTF_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
@@ -35,14 +42,173 @@ static std::pair<const char*, DXGI_FORMAT> ParseGltfElement(const std::string& n
 	return { semanticName, format };
 }
 
-static SceneCollection::ResourceData ProcessGLTF(const tinygltf::Model& data, const std::string& path, SceneCollection::LoadCtx& ctx)
+// CPU side of primitive conversion, independent per primitive
+struct PrimitiveTask
+{
+	const tinygltf::Primitive* primitive{};
+	VertexBufferModel* model{};
+
+	VertexQuantization::Result packed;
+	std::vector<uint32_t> indices;
+	size_t sourceVertexCount{};
+	size_t vertexCount{};
+	MeshOptimizer::Report optimization;
+	ModelMeshlets meshlets;
+	BoundingBox bbox;
+
+	float decodeMs{};
+	float optimizeMs{};
+	float meshletsMs{};
+};
+
+using Clock = std::chrono::steady_clock;
+
+static float ElapsedMs(Clock::time_point& start)
+{
+	auto now = Clock::now();
+	float ms = std::chrono::duration<float, std::milli>(now - start).count();
+	start = now;
+
+	return ms;
+}
+
+static std::vector<XMFLOAT3> ReadPackedPositions(const VertexQuantization::Result& packed, size_t vertexCount)
+{
+	std::vector<XMFLOAT3> positions;
+
+	for (const auto& element : packed.layout)
+	{
+		if (!VertexElementSemantic::IsSemantic(element.semantic, VertexElementSemantic::POSITION))
+			continue;
+
+		positions.resize(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			auto data = packed.vertices.data() + i * packed.vertexSize + element.offset;
+
+			if (element.format == DXGI_FORMAT_R16G16B16A16_FLOAT)
+			{
+				auto half = (const PackedVector::HALF*)data;
+				positions[i] = { PackedVector::XMConvertHalfToFloat(half[0]), PackedVector::XMConvertHalfToFloat(half[1]), PackedVector::XMConvertHalfToFloat(half[2]) };
+			}
+			else
+				positions[i] = *(const XMFLOAT3*)data;
+		}
+	}
+
+	return positions;
+}
+
+static void ProcessPrimitive(const tinygltf::Model& data, PrimitiveTask& task)
+{
+	auto time = Clock::now();
+	const auto& prim = *task.primitive;
+
+	size_t vertexCount{};
+	std::vector<VertexQuantization::SourceElement> elements;
+
+	for (const auto& attr : prim.attributes)
+	{
+		const tinygltf::Accessor& acc = data.accessors[attr.second];
+		const tinygltf::BufferView& view = data.bufferViews[acc.bufferView];
+		const tinygltf::Buffer& buf = data.buffers[view.buffer];
+
+		auto e = ParseGltfElement(attr.first, acc.type);
+
+		if (!e.first)
+			continue;
+
+		UINT semanticIndex = 0;
+		if (auto separator = attr.first.find('_'); separator != std::string::npos)
+			semanticIndex = std::stoi(attr.first.substr(separator + 1));
+
+		auto stride = acc.ByteStride(view);
+		if (stride <= 0)
+			stride = task.model->getFormatSize(e.second);
+
+		elements.push_back({ e.first, semanticIndex, e.second, buf.data.data() + view.byteOffset + acc.byteOffset, (UINT)stride });
+
+		vertexCount = acc.count;
+	}
+
+	task.packed = VertexQuantization::Quantize(elements, vertexCount);
+	task.sourceVertexCount = vertexCount;
+
+	const tinygltf::Accessor& idxAcc = data.accessors[prim.indices];
+	const tinygltf::BufferView& idxView = data.bufferViews[idxAcc.bufferView];
+	const tinygltf::Buffer& idxBuf = data.buffers[idxView.buffer];
+
+	auto indicesData = idxBuf.data.data() + idxView.byteOffset + idxAcc.byteOffset;
+
+	auto& indices = task.indices;
+	indices.resize(idxAcc.count);
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		if (idxAcc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
+			indices[i] = ((const uint16_t*)indicesData)[i];
+		else if (idxAcc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
+			indices[i] = indicesData[i];
+		else
+			indices[i] = ((const uint32_t*)indicesData)[i];
+	}
+
+	task.decodeMs = ElapsedMs(time);
+
+	// overdraw sorting uses source float positions, still indexed by original vertices
+	const VertexQuantization::SourceElement* positionElement = nullptr;
+	for (auto& e : elements)
+		if (VertexElementSemantic::IsSemantic(e.semantic, VertexElementSemantic::POSITION))
+			positionElement = &e;
+
+	task.optimization = MeshOptimizer::optimizeMesh(indices, task.packed.vertices.data(), vertexCount, task.packed.vertexSize,
+		positionElement ? (const float*)positionElement->data : nullptr, positionElement ? positionElement->stride : 0);
+
+	task.vertexCount = task.optimization.vertexCount;
+	task.optimizeMs = ElapsedMs(time);
+
+	// reordered positions as stored in vertex buffer
+	auto positions = ReadPackedPositions(task.packed, task.vertexCount);
+	if (!positions.empty())
+	{
+		BoundingBox::CreateFromPoints(task.bbox, positions.size(), positions.data(), sizeof(XMFLOAT3));
+		task.meshlets = MeshletBuilder::build(indices, &positions.front().x, sizeof(XMFLOAT3), positions.size());
+	}
+
+	task.meshletsMs = ElapsedMs(time);
+}
+
+static SceneCollection::ResourceData ProcessGLTF(const tinygltf::Model& data, const std::string& path, SceneCollection::LoadCtx& ctx, float parseMs)
 {
 	SceneCollection::ResourceData loadInfo;
 	loadInfo.path = path;
 
+	struct
+	{
+		size_t meshes{};
+		size_t packedPositions{};
+		size_t vertexCount{};
+		size_t sourceBytes{};
+		size_t packedBytes{};
+	}
+	quantizationStats;
+
+	struct
+	{
+		size_t triangles{};
+		size_t vertices{};
+		size_t meshlets{};
+		double acmrBefore{};
+		double acmrAfter{};
+		double atvrBefore{};
+		double atvrAfter{};
+	}
+	optimizationStats;
+
 	if (!data.buffers.empty())
 		loadInfo.name = data.buffers.front().uri;
 
+	std::vector<PrimitiveTask> tasks;
+
 	for (const auto& mesh : data.meshes)
 	{
 		uint32_t idx = 0;
@@ -58,72 +224,95 @@ static SceneCollection::ResourceData ProcessGLTF(const tinygltf::Model& data, co
 				info.mesh.name += "/" + std::to_string(info.primitiveIdx);
 
 			if (auto model = ctx.resources.models.addLoadedModel(info.mesh.name, path))
-			{
-				// Vertex buffer
-				{
-					size_t vertexCount{};
-					std::vector<const uint8_t*> dataBuffers;
+				tasks.push_back({ &prim, model });
+
+			if (prim.material >= 0)
+				info.materialName = data.materials[prim.material].name;
 
-					for (const auto& attr : prim.attributes)
-					{
-						const tinygltf::Accessor& acc = data.accessors[attr.second];
-						const tinygltf::BufferView& view = data.bufferViews[acc.bufferView];
-						const tinygltf::Buffer& buf = data.buffers[view.buffer];
+			loadInfo.entities.push_back(info);
+		}
+	}
 
-						auto e = ParseGltfElement(attr.first, acc.type);
+	auto time = Clock::now();
 
-						if (!e.first)
-							continue;
+	ParallelFor(tasks.size(), [&](size_t i) { ProcessPrimitive(data, tasks[i]); });
 
-						model->addLayoutElement(e.second, e.first);
-						dataBuffers.push_back(buf.data.data() + view.byteOffset + acc.byteOffset);
+	const float processingMs = ElapsedMs(time);
 
-						vertexCount = acc.count;
-					}
+	// GPU resources are created on calling thread only
+	for (auto& task : tasks)
+	{
+		auto model = task.model;
+		const auto vertexCount = task.vertexCount;
+		const auto& indices = task.indices;
+		const auto& report = task.optimization;
 
-					const auto vertexSize = model->getLayoutVertexSize(0);
+		for (const auto& element : task.packed.layout)
+			model->addLayoutElement(element.format, element.semantic, element.semanticIndex);
 
-					std::vector<char> vbData;
-					vbData.resize(vertexSize * vertexCount);
+		quantizationStats.vertexCount += task.sourceVertexCount;
+		quantizationStats.sourceBytes += task.packed.stats.sourceBytes();
+		quantizationStats.packedBytes += task.packed.stats.packedBytes();
+		quantizationStats.packedPositions += task.packed.stats.positionsPacked;
+		quantizationStats.meshes++;
 
-					for (size_t i = 0; i < model->vertexLayout.size(); i++)
-					{
-						const auto& element = model->vertexLayout[i];
-						auto elementSize = model->getFormatSize(element.Format);
-						auto elementData = dataBuffers[i];
+		optimizationStats.triangles += indices.size() / 3;
+		optimizationStats.acmrBefore += report.before.acmr * indices.size() / 3;
+		optimizationStats.acmrAfter += report.after.acmr * indices.size() / 3;
+		optimizationStats.atvrBefore += report.before.atvr * vertexCount;
+		optimizationStats.atvrAfter += report.after.atvr * vertexCount;
+		optimizationStats.vertices += vertexCount;
 
-						for (size_t i = 0; i < vertexCount; i++)
-						{
-							memcpy(&vbData[i * vertexSize + element.AlignedByteOffset], &elementData[i * elementSize], elementSize);
-						}
-					}
+		model->vertexCount = (uint32_t)vertexCount;
+		model->CreateVertexBuffer(ctx.renderSystem.core.device, &ctx.batch, task.packed.vertices.data(), (UINT)vertexCount, task.packed.vertexSize);
 
-					model->vertexCount = vertexCount;
-					model->CreateVertexBuffer(ctx.renderSystem.core.device, &ctx.batch, vbData.data(), vertexCount, vertexSize);
-				}
+		model->indexCount = (uint32_t)indices.size();
 
-				// Index buffer
-				{
-					const tinygltf::Accessor& idxAcc = data.accessors[prim.indices];
-					const tinygltf::BufferView& idxView = data.bufferViews[idxAcc.bufferView];
-					const tinygltf::Buffer& idxBuf = data.buffers[idxView.buffer];
+		if (vertexCount <= UINT16_MAX + 1)
+		{
+			std::vector<uint16_t> shortIndices(indices.size());
+			for (size_t i = 0; i < indices.size(); i++)
+				shortIndices[i] = (uint16_t)indices[i];
 
-					model->indexCount = idxAcc.count;
+			model->CreateIndexBuffer(ctx.renderSystem.core.device, &ctx.batch, shortIndices.data(), shortIndices.size());
+		}
+		else
+			model->CreateIndexBuffer(ctx.renderSystem.core.device, &ctx.batch, indices.data(), indices.size());
 
-					auto indices = idxBuf.data.data() + idxView.byteOffset + idxAcc.byteOffset;
+		model->bbox = task.bbox;
+		model->meshlets = std::move(task.meshlets);
+		optimizationStats.meshlets += model->meshlets.meshlets.size();
+	}
 
-					if (idxAcc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
-						model->CreateIndexBuffer(ctx.renderSystem.core.device, &ctx.batch, (const uint16_t*)indices, idxAcc.count);
-					else
-						model->CreateIndexBuffer(ctx.renderSystem.core.device, &ctx.batch, (const uint32_t*)indices, idxAcc.count);
-				}
-			}		
+	const float buffersMs = ElapsedMs(time);
 
-			if (prim.material >= 0)
-				info.materialName = data.materials[prim.material].name;
+	if (quantizationStats.sourceBytes)
+	{
+		Logger::log(std::format("Vertex quantization {}: {} meshes ({} half positions), {} vertices, {} KB -> {} KB ({:.1f}%)",
+			path, quantizationStats.meshes, quantizationStats.packedPositions, quantizationStats.vertexCount,
+			quantizationStats.sourceBytes / 1024, quantizationStats.packedBytes / 1024,
+			100.0 * quantizationStats.packedBytes / quantizationStats.sourceBytes));
+	}
+	if (optimizationStats.triangles)
+	{
+		Logger::log(std::format("Mesh optimization {}: {} triangles, {} meshlets, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+			path, optimizationStats.triangles, optimizationStats.meshlets,
+			optimizationStats.acmrBefore / optimizationStats.triangles, optimizationStats.acmrAfter / optimizationStats.triangles,
+			optimizationStats.atvrBefore / optimizationStats.vertices, optimizationStats.atvrAfter / optimizationStats.vertices));
+	}
 
-			loadInfo.entities.push_back(info);
+	{
+		// summed over all threads
+		float decodeMs{}, optimizeMs{}, meshletsMs{};
+		for (auto& task : tasks)
+		{
+			decodeMs += task.decodeMs;
+			optimizeMs += task.optimizeMs;
+			meshletsMs += task.meshletsMs;
 		}
+
+		Logger::log(std::format("Loaded {} in {:.1f} ms: parse {:.1f} ms, {} primitives {:.1f} ms (cpu decode {:.1f}, optimize {:.1f}, meshlets {:.1f}), buffers {:.1f} ms",
+			path, parseMs + processingMs + buffersMs, parseMs, tasks.size(), processingMs, decodeMs, optimizeMs, meshletsMs, buffersMs));
 	}
 
 	for (const auto& node : data.nodes)
@@ -156,6 +345,8 @@ static SceneCollection::ResourceData ProcessGLTF(const tinygltf::Model& data, co
 
 SceneCollection::ResourceData GltfLoader::load(const std::string& path, SceneCollection::LoadCtx ctx)
 {
+	auto start = Clock::now();
+
 	tinygltf::TinyGLTF loader;
 	tinygltf::Model gltfModel;
 	std::string error;
@@ -177,5 +368,5 @@ SceneCollection::ResourceData GltfLoader::load(const std::string& path, SceneCol
 	if (loadFolder.starts_with(SCENE_DIRECTORY))
 		loadFolder.erase(0, SCENE_DIRECTORY.length());
 
-	return ProcessGLTF(gltfModel, loadFolder, ctx);
+	return ProcessGLTF(gltfModel, loadFolder, ctx, ElapsedMs(start));
 }
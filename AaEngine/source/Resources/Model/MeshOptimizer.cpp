@@ -0,0 +1,363 @@
+#include "Resources/Model/MeshOptimizer.h"
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+// Forsyth scoring parameters, cache is larger than stats cache to look ahead
+constexpr uint32_t ForsythCacheSize = 32;
+constexpr float CacheDecayPower = 1.5f;
+constexpr float LastTriangleScore = 0.75f;
+constexpr float ValenceBoostScale = 2.0f;
+constexpr float ValenceBoostPower = 0.5f;
+
+constexpr size_t NoTriangle = SIZE_MAX;
+
+static bool ValidIndices(std::span<const uint32_t> indices, size_t vertexCount)
+{
+	if (indices.size() % 3)
+		return false;
+
+	for (auto i : indices)
+		if (i >= vertexCount)
+			return false;
+
+	return true;
+}
+
+static float VertexScore(int cachePosition, uint32_t remainingValence)
+{
+	if (remainingValence == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+
+	if (cachePosition >= 0)
+	{
+		if (cachePosition < 3)
+			score = LastTriangleScore;
+		else
+			score = std::pow(1.0f - float(cachePosition - 3) / (ForsythCacheSize - 3), CacheDecayPower);
+	}
+
+	return score + ValenceBoostScale * std::pow(float(remainingValence), -ValenceBoostPower);
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize)
+{
+	CacheStats stats;
+	if (indices.empty() || !ValidIndices(indices, vertexCount))
+		return stats;
+
+	// FIFO simulated with insertion timestamps, hits do not refresh
+	std::vector<uint32_t> cacheTime(vertexCount, 0);
+	std::vector<bool> referenced(vertexCount);
+	uint32_t time = cacheSize + 1;
+	size_t misses = 0;
+	size_t uniqueVertices = 0;
+
+	for (auto i : indices)
+	{
+		if (time - cacheTime[i] > cacheSize)
+		{
+			cacheTime[i] = time++;
+			misses++;
+		}
+
+		if (!referenced[i])
+		{
+			referenced[i] = true;
+			uniqueVertices++;
+		}
+	}
+
+	stats.acmr = float(misses) / (indices.size() / 3);
+	stats.atvr = float(misses) / uniqueVertices;
+
+	return stats;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount < 2 || !ValidIndices(indices, vertexCount))
+		return;
+
+	// vertex to triangle adjacency
+	std::vector<uint32_t> remaining(vertexCount);
+	for (auto i : indices)
+		remaining[i]++;
+
+	std::vector<uint32_t> offsets(vertexCount + 1);
+	for (size_t v = 0; v < vertexCount; v++)
+		offsets[v + 1] = offsets[v] + remaining[v];
+
+	std::vector<uint32_t> adjacency(indices.size());
+	{
+		auto cursor = offsets;
+		for (size_t i = 0; i < indices.size(); i++)
+			adjacency[cursor[indices[i]]++] = uint32_t(i / 3);
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+		vertexScore[v] = VertexScore(-1, remaining[v]);
+
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<bool> emitted(triangleCount);
+	size_t bestTriangle = 0;
+
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+		if (triangleScore[t] > triangleScore[bestTriangle])
+			bestTriangle = t;
+	}
+
+	std::vector<uint32_t> output;
+	output.reserve(indices.size());
+
+	std::vector<uint32_t> cache, nextCache;
+	cache.reserve(ForsythCacheSize + 3);
+	nextCache.reserve(ForsythCacheSize + 3);
+
+	size_t scanCursor = 0;
+
+	while (output.size() < indices.size())
+	{
+		// nothing adjacent in cache, continue with next not emitted triangle
+		if (bestTriangle == NoTriangle)
+		{
+			while (emitted[scanCursor])
+				scanCursor++;
+
+			bestTriangle = scanCursor;
+		}
+
+		const uint32_t* triangle = &indices[bestTriangle * 3];
+		emitted[bestTriangle] = true;
+
+		nextCache.clear();
+		for (int i = 0; i < 3; i++)
+		{
+			output.push_back(triangle[i]);
+			remaining[triangle[i]]--;
+
+			if (std::find(nextCache.begin(), nextCache.end(), triangle[i]) == nextCache.end())
+				nextCache.push_back(triangle[i]);
+		}
+
+		for (auto v : cache)
+			if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end())
+				nextCache.push_back(v);
+
+		for (size_t i = 0; i < nextCache.size(); i++)
+		{
+			auto v = nextCache[i];
+			cachePosition[v] = i < ForsythCacheSize ? int(i) : -1;
+			vertexScore[v] = VertexScore(cachePosition[v], remaining[v]);
+		}
+
+		bestTriangle = NoTriangle;
+		float bestScore = -1.0f;
+
+		for (auto v : nextCache)
+		{
+			for (uint32_t a = offsets[v]; a < offsets[v + 1]; a++)
+			{
+				auto t = adjacency[a];
+				if (emitted[t])
+					continue;
+
+				triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+				if (triangleScore[t] > bestScore)
+				{
+					bestScore = triangleScore[t];
+					bestTriangle = t;
+				}
+			}
+		}
+
+		if (nextCache.size() > ForsythCacheSize)
+			nextCache.resize(ForsythCacheSize);
+
+		std::swap(cache, nextCache);
+	}
+
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void MeshOptimizer::optimizeOverdraw(std::span<uint32_t> indices, const float* positions, size_t positionStride, size_t vertexCount, float threshold)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount < 2 || !positions || !ValidIndices(indices, vertexCount))
+		return;
+
+	auto position = [&](uint32_t v) { return (const float*)((const uint8_t*)positions + v * positionStride); };
+
+	// clusters start where cache misses whole triangle, reordering them keeps cache behavior
+	std::vector<size_t> clusterStarts;
+	{
+		std::vector<uint32_t> cacheTime(vertexCount, 0);
+		uint32_t time = StatsCacheSize + 1;
+
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			int misses = 0;
+			for (int i = 0; i < 3; i++)
+			{
+				auto v = indices[t * 3 + i];
+				if (time - cacheTime[v] > StatsCacheSize)
+				{
+					cacheTime[v] = time++;
+					misses++;
+				}
+			}
+
+			if (misses == 3)
+				clusterStarts.push_back(t);
+		}
+	}
+
+	if (clusterStarts.size() < 2)
+		return;
+
+	clusterStarts.push_back(triangleCount);
+	const size_t clusterCount = clusterStarts.size() - 1;
+
+	struct Cluster
+	{
+		float centroid[3]{};
+		float normal[3]{};
+		float area{};
+	};
+	std::vector<Cluster> clusters(clusterCount);
+	float meshCentroid[3]{};
+	float meshArea = 0;
+
+	for (size_t c = 0; c < clusterCount; c++)
+	{
+		auto& cluster = clusters[c];
+
+		for (size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++)
+		{
+			auto p0 = position(indices[t * 3]);
+			auto p1 = position(indices[t * 3 + 1]);
+			auto p2 = position(indices[t * 3 + 2]);
+
+			const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			const float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			const float area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			for (int i = 0; i < 3; i++)
+			{
+				cluster.centroid[i] += (p0[i] + p1[i] + p2[i]) / 3 * area;
+				cluster.normal[i] += n[i];
+			}
+			cluster.area += area;
+		}
+
+		for (int i = 0; i < 3; i++)
+			meshCentroid[i] += cluster.centroid[i];
+		meshArea += cluster.area;
+
+		if (cluster.area > 0)
+			for (int i = 0; i < 3; i++)
+				cluster.centroid[i] /= cluster.area;
+	}
+
+	if (meshArea <= 0)
+		return;
+
+	for (int i = 0; i < 3; i++)
+		meshCentroid[i] /= meshArea;
+
+	// outward facing clusters far from center are likely to occlude the rest
+	std::vector<float> sortKey(clusterCount);
+	for (size_t c = 0; c < clusterCount; c++)
+	{
+		auto& cluster = clusters[c];
+		const float length = std::sqrt(cluster.normal[0] * cluster.normal[0] + cluster.normal[1] * cluster.normal[1] + cluster.normal[2] * cluster.normal[2]);
+
+		float dot = 0;
+		for (int i = 0; i < 3; i++)
+			dot += (cluster.centroid[i] - meshCentroid[i]) * cluster.normal[i];
+
+		sortKey[c] = length > 0 ? dot / length : 0;
+	}
+
+	std::vector<size_t> order(clusterCount);
+	for (size_t c = 0; c < clusterCount; c++)
+		order[c] = c;
+
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+	std::vector<uint32_t> sorted;
+	sorted.reserve(indices.size());
+	for (auto c : order)
+		sorted.insert(sorted.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+
+	const auto before = analyzeVertexCache(indices, vertexCount);
+	const auto after = analyzeVertexCache(sorted, vertexCount);
+
+	if (after.acmr <= before.acmr * threshold)
+		std::copy(sorted.begin(), sorted.end(), indices.begin());
+}
+
+size_t MeshOptimizer::optimizeVertexFetch(std::span<uint32_t> indices, void* vertices, size_t vertexCount, size_t vertexSize)
+{
+	if (!ValidIndices(indices, vertexCount))
+		return vertexCount;
+
+	constexpr uint32_t Unused = UINT32_MAX;
+	std::vector<uint32_t> remap(vertexCount, Unused);
+	uint32_t nextVertex = 0;
+
+	for (auto& i : indices)
+	{
+		if (remap[i] == Unused)
+			remap[i] = nextVertex++;
+
+		i = remap[i];
+	}
+
+	auto data = (uint8_t*)vertices;
+	std::vector<uint8_t> source(data, data + vertexCount * vertexSize);
+
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		if (remap[v] != Unused)
+			memcpy(data + remap[v] * vertexSize, source.data() + v * vertexSize, vertexSize);
+	}
+
+	return nextVertex;
+}
+
+MeshOptimizer::Report MeshOptimizer::optimizeMesh(std::span<uint32_t> indices, void* vertices, size_t vertexCount, size_t vertexSize, const float* positions, size_t positionStride)
+{
+	Report report;
+	report.vertexCount = vertexCount;
+
+	if (!ValidIndices(indices, vertexCount))
+		return report;
+
+	report.before = analyzeVertexCache(indices, vertexCount);
+
+	std::vector<uint32_t> original(indices.begin(), indices.end());
+
+	optimizeVertexCache(indices, vertexCount);
+	optimizeOverdraw(indices, positions, positionStride, vertexCount);
+
+	// greedy reordering can lose to already regular orders like narrow strip grids
+	if (analyzeVertexCache(indices, vertexCount).acmr > report.before.acmr)
+		std::copy(original.begin(), original.end(), indices.begin());
+
+	report.vertexCount = optimizeVertexFetch(indices, vertices, vertexCount, vertexSize);
+
+	report.after = analyzeVertexCache(indices, report.vertexCount);
+
+	return report;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+// Triangle list reordering for post-transform cache, overdraw and vertex fetch
+namespace MeshOptimizer
+{
+	// FIFO size used for statistics, close to what current GPUs reuse
+	constexpr uint32_t StatsCacheSize = 16;
+
+	struct CacheStats
+	{
+		float acmr{};	// transformed vertices per triangle, 0.5 is ideal, 3 is worst
+		float atvr{};	// transformed vertices per referenced vertex, 1 is ideal
+	};
+
+	struct Report
+	{
+		CacheStats before;
+		CacheStats after;
+		size_t vertexCount{};
+	};
+
+	CacheStats analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = StatsCacheSize);
+
+	// Forsyth linear-speed vertex cache optimization
+	void optimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount);
+
+	// reorders cache-friendly clusters front to back from the mesh center, keeps ACMR within threshold
+	void optimizeOverdraw(std::span<uint32_t> indices, const float* positions, size_t positionStride, size_t vertexCount, float threshold = 1.05f);
+
+	// reorders vertices in first use order and drops unreferenced ones, returns new vertex count
+	size_t optimizeVertexFetch(std::span<uint32_t> indices, void* vertices, size_t vertexCount, size_t vertexSize);
+
+	// all passes above, positions can point into vertices
+	Report optimizeMesh(std::span<uint32_t> indices, void* vertices, size_t vertexCount, size_t vertexSize, const float* positions, size_t positionStride);
+}
@@ -0,0 +1,217 @@
+#include "Resources/Model/MeshletBuilder.h"
+#include "Resources/Model/VertexBufferModel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	struct Float3
+	{
+		float x, y, z;
+
+		Float3 operator+(const Float3& o) const { return { x + o.x, y + o.y, z + o.z }; }
+		Float3 operator-(const Float3& o) const { return { x - o.x, y - o.y, z - o.z }; }
+		Float3 operator*(float s) const { return { x * s, y * s, z * s }; }
+		float dot(const Float3& o) const { return x * o.x + y * o.y + z * o.z; }
+		float length() const { return std::sqrt(dot(*this)); }
+		Float3 cross(const Float3& o) const { return { y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x }; }
+	};
+
+	// Ritter bounding sphere, within few percent of minimal
+	void computeSphere(const std::vector<Float3>& points, Float3& center, float& radius)
+	{
+		auto farthest = [&](const Float3& from)
+			{
+				size_t best = 0;
+				float bestDistance = -1;
+				for (size_t i = 0; i < points.size(); i++)
+				{
+					const float d = (points[i] - from).dot(points[i] - from);
+					if (d > bestDistance)
+					{
+						bestDistance = d;
+						best = i;
+					}
+				}
+				return points[best];
+			};
+
+		const Float3 a = farthest(points.front());
+		const Float3 b = farthest(a);
+
+		center = (a + b) * 0.5f;
+		radius = (b - a).length() * 0.5f;
+
+		for (auto& p : points)
+		{
+			const float distance = (p - center).length();
+			if (distance > radius)
+			{
+				const float newRadius = (radius + distance) * 0.5f;
+				center = center + (p - center) * ((newRadius - radius) / distance);
+				radius = newRadius;
+			}
+		}
+	}
+
+	void computeBounds(ModelMeshletBounds& bounds, const std::vector<Float3>& points, const std::vector<Float3>& trianglePoints)
+	{
+		Float3 center;
+		float radius;
+		computeSphere(points, center, radius);
+
+		bounds.center[0] = center.x;
+		bounds.center[1] = center.y;
+		bounds.center[2] = center.z;
+		bounds.radius = radius;
+
+		// normal cone from average of triangle normals
+		std::vector<Float3> normals;
+		normals.reserve(trianglePoints.size() / 3);
+		Float3 axis{};
+
+		for (size_t t = 0; t < trianglePoints.size(); t += 3)
+		{
+			Float3 n = (trianglePoints[t + 1] - trianglePoints[t]).cross(trianglePoints[t + 2] - trianglePoints[t]);
+			const float length = n.length();
+			if (length <= 0)
+				continue;
+
+			n = n * (1.0f / length);
+			normals.push_back(n);
+			axis = axis + n;
+		}
+
+		const float axisLength = axis.length();
+		if (normals.empty() || axisLength <= 0)
+			return;
+
+		axis = axis * (1.0f / axisLength);
+
+		float minDot = 1.0f;
+		for (auto& n : normals)
+			minDot = std::min(minDot, n.dot(axis));
+
+		bounds.coneAxis[0] = axis.x;
+		bounds.coneAxis[1] = axis.y;
+		bounds.coneAxis[2] = axis.z;
+
+		// spread over 90 degrees can not be culled by cone test
+		if (minDot <= 0.1f)
+		{
+			bounds.coneCutoff = 1.0f;
+			bounds.coneApex[0] = center.x;
+			bounds.coneApex[1] = center.y;
+			bounds.coneApex[2] = center.z;
+			return;
+		}
+
+		// move apex back along axis until every triangle plane is in front of it
+		float maxT = 0;
+		size_t normalIdx = 0;
+		for (size_t t = 0; t < trianglePoints.size(); t += 3)
+		{
+			Float3 n = (trianglePoints[t + 1] - trianglePoints[t]).cross(trianglePoints[t + 2] - trianglePoints[t]);
+			if (n.length() <= 0)
+				continue;
+
+			auto& normal = normals[normalIdx++];
+			const float distance = (center - trianglePoints[t]).dot(normal) / normal.dot(axis);
+			maxT = std::max(maxT, distance);
+		}
+
+		const Float3 apex = center - axis * maxT;
+		bounds.coneApex[0] = apex.x;
+		bounds.coneApex[1] = apex.y;
+		bounds.coneApex[2] = apex.z;
+		bounds.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+	}
+}
+
+ModelMeshlets MeshletBuilder::build(std::span<const uint32_t> indices, const float* positions, size_t positionStride, size_t vertexCount)
+{
+	ModelMeshlets result;
+	if (indices.size() < 3 || indices.size() % 3 || !positions)
+		return result;
+
+	for (auto i : indices)
+		if (i >= vertexCount)
+			return result;
+
+	auto position = [&](uint32_t v)
+		{
+			auto p = (const float*)((const uint8_t*)positions + v * positionStride);
+			return Float3{ p[0], p[1], p[2] };
+		};
+
+	constexpr uint8_t NotInMeshlet = 0xFF;
+	std::vector<uint8_t> localIndex(vertexCount, NotInMeshlet);
+
+	ModelMeshlet current{};
+	std::vector<Float3> points;
+	std::vector<Float3> trianglePoints;
+
+	auto flush = [&]()
+		{
+			if (!current.triangleCount)
+				return;
+
+			for (uint32_t i = 0; i < current.vertexCount; i++)
+				localIndex[result.vertices[current.vertexOffset + i]] = NotInMeshlet;
+
+			computeBounds(result.bounds.emplace_back(), points, trianglePoints);
+			result.meshlets.push_back(current);
+
+			// keep next meshlet triangles aligned for 32 bit loads
+			result.triangles.resize((result.triangles.size() + 3) & ~size_t(3));
+
+			current = {};
+			current.vertexOffset = (uint32_t)result.vertices.size();
+			current.triangleOffset = (uint32_t)result.triangles.size();
+			points.clear();
+			trianglePoints.clear();
+		};
+
+	for (size_t t = 0; t < indices.size(); t += 3)
+	{
+		const uint32_t* triangle = &indices[t];
+
+		uint32_t newVertices = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			if (localIndex[triangle[i]] == NotInMeshlet && (i == 0 || triangle[i] != triangle[0]) && (i < 2 || triangle[i] != triangle[1]))
+				newVertices++;
+		}
+
+		if (current.vertexCount + newVertices > MaxVertices || current.triangleCount + 1 > MaxTriangles)
+			flush();
+
+		for (int i = 0; i < 3; i++)
+		{
+			auto v = triangle[i];
+			if (localIndex[v] == NotInMeshlet)
+			{
+				localIndex[v] = (uint8_t)current.vertexCount++;
+				result.vertices.push_back(v);
+				points.push_back(position(v));
+			}
+
+			result.triangles.push_back(localIndex[v]);
+			trianglePoints.push_back(position(v));
+		}
+
+		current.triangleCount++;
+	}
+
+	flush();
+
+	return result;
+}
+
+ModelMeshlets MeshletBuilder::build(const VertexBufferModel& model)
+{
+	if (model.positions.empty())
+		return {};
+
+	return build(model.indices, &model.positions.front().x, sizeof(model.positions.front()), model.positions.size());
+}
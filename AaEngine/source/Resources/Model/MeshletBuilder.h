@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Resources/Model/BinaryModelSerialization.h"
+
+class VertexBufferModel;
+
+// Splits triangle lists into meshlets with culling bounds, for mesh shader rendering
+namespace MeshletBuilder
+{
+	constexpr uint32_t MaxVertices = 64;
+	constexpr uint32_t MaxTriangles = 124;
+
+	// triangles are taken in index order, run after MeshOptimizer to keep meshlets compact
+	ModelMeshlets build(std::span<const uint32_t> indices, const float* positions, size_t positionStride, size_t vertexCount);
+
+	// uses CPU copies of positions and indices
+	ModelMeshlets build(const VertexBufferModel& model);
+}
@@ -1,33 +1,51 @@
 #include "Resources/Model/ModelResources.h"
+#include "Utils/CpuProfiler.h"
 #include "Utils/Logger.h"
+#include "Utils/JobSystem.h"
 #include "App/Directories.h"
 #include <sys/stat.h>
 #include "Resources/Model/OgreMeshFileParser.h"
 #include <memory>
 #include "Resources/Model/BinaryModelLoader.h"
 #include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <format>
 
 static ModelResources* instance = nullptr;
 const std::string CoreGroup = "meshes/core";
 
-ModelResources::ModelResources(RenderSystem& rs) : device(*rs.core.device)
+ModelResources::ModelResources(RenderSystem& rs) : device(*rs.core.device), commandQueue(rs.core.commandQueue)
 {
 	if (instance)
 		throw std::exception("Duplicate AaModelResources");
 
 	instance = this;
 
-	ResourceUploadBatch batch(rs.core.device);
-	batch.Begin();
+	uploadBatch = std::make_unique<ResourceUploadBatch>(rs.core.device);
 
-	preloadFolder(batch, { CoreGroup, true });
+	// core models are needed right away, but still parsed in parallel
+	preloadFolder({ CoreGroup, true });
+	flushStreaming();
+}
 
-	auto uploadResourcesFinished = batch.End(rs.core.commandQueue);
-	uploadResourcesFinished.wait();
+ModelResources& ModelResources::Get()
+{
+	return *instance;
 }
 
 ModelResources::~ModelResources()
 {
+	for (auto& [key, request] : streamingRequests)
+		JobSystem::GetIo().wait(request->job);
+
+	if (uploadFinished.valid())
+		uploadFinished.wait();
+
+	for (auto& [key, request] : streamingRequests)
+		delete request->model;
+
 	for (auto it = groups.begin(); it != groups.end(); it++)
 	{
 		for (auto& m : it->models)
@@ -44,12 +62,20 @@ VertexBufferModel* ModelResources::getModel(const std::string& filename, Resourc
 		auto it = models.find(filename);
 
 		if (it != models.end())
+		{
+			if (it->second)
+				it->second->pinned = true;
+
 			return it->second;
+		}
 	}
 
-	VertexBufferModel* m = loadModel(filename, batch, ctx);
+	VertexBufferModel* m = loadModel(filename, &batch, ctx);
 	if (m)
+	{
+		m->pinned = true;
 		models[filename] = m;
+	}
 
 	return m;
 }
@@ -79,8 +105,10 @@ VertexBufferModel* ModelResources::getCoreModel(const std::string& filename)
 
 void ModelResources::addLoadedModel(const std::string& name, VertexBufferModel* m, const std::string& group)
 {
-	auto& models = getGroupLibrary({ group });
-	auto& model = models[name];
+	auto& g = getGroup({ group });
+	g.reloadable = false;
+
+	auto& model = g.models[name];
 
 	if (model)
 		Logger::logError("Duplicate mesh " + name);
@@ -90,8 +118,10 @@ void ModelResources::addLoadedModel(const std::string& name, VertexBufferModel*
 
 VertexBufferModel* ModelResources::addLoadedModel(const std::string& name, const std::string& group)
 {
-	auto& models = getGroupLibrary({ group });
-	auto& model = models[name];
+	auto& g = getGroup({ group });
+	g.reloadable = false;
+
+	auto& model = g.models[name];
 
 	if (model)
 		return nullptr;
@@ -99,7 +129,7 @@ VertexBufferModel* ModelResources::addLoadedModel(const std::string& name, const
 	return model = new VertexBufferModel();
 }
 
-UINT ModelResources::preloadFolder(ResourceUploadBatch& batch, const ModelLoadContext& ctx)
+UINT ModelResources::preloadFolder(const ModelLoadContext& ctx)
 {
 	UINT c{};
 	std::error_code ec;
@@ -108,7 +138,7 @@ UINT ModelResources::preloadFolder(ResourceUploadBatch& batch, const ModelLoadCo
 	{
 		if (entry.is_regular_file())
 		{
-			getModel(entry.path().filename().generic_string(), batch, ctx);
+			loadModelAsync(entry.path().filename().generic_string(), ctx);
 			c++;
 		}
 	}
@@ -118,6 +148,9 @@ UINT ModelResources::preloadFolder(ResourceUploadBatch& batch, const ModelLoadCo
 
 void ModelResources::clear()
 {
+	// requests may target cleared groups
+	flushStreaming();
+
 	for (auto it = groups.begin(); it != groups.end();)
 	{
 		if (it->persistent)
@@ -132,7 +165,7 @@ void ModelResources::clear()
 	}
 }
 
-VertexBufferModel* ModelResources::loadModel(const std::string& filename, ResourceUploadBatch& batch, const ModelLoadContext& ctx)
+VertexBufferModel* ModelResources::loadModel(const std::string& filename, ResourceUploadBatch* batch, const ModelLoadContext& ctx)
 {
 	VertexBufferModel* model{};
 
@@ -145,7 +178,7 @@ VertexBufferModel* ModelResources::loadModel(const std::string& filename, Resour
 	if (filename.ends_with("mesh"))
 	{
 		ModelParseOptions o;
-		o.batch = &batch;
+		o.batch = batch;
 		o.device = &device;
 
 		struct stat attrib;
@@ -172,12 +205,310 @@ VertexBufferModel* ModelResources::loadModel(const std::string& filename, Resour
 }
 
 ModelResources::ModelLibrary& ModelResources::getGroupLibrary(const ModelLoadContext& ctx)
+{
+	return getGroup(ctx).models;
+}
+
+ModelResources::ModelLibraryGroup& ModelResources::getGroup(const ModelLoadContext& ctx)
 {
 	for (auto& g : groups)
 	{
 		if (g.name == ctx.folder)
-			return g.models;
+			return g;
 	}
 
-	return groups.emplace_back(ctx.folder, ctx.persistent).models;
+	return groups.emplace_back(ctx.folder, ctx.persistent);
+}
+
+ModelHandle ModelResources::loadModelAsync(const std::string& filename, const ModelLoadContext& ctx, std::function<void(VertexBufferModel*)> onReady)
+{
+	auto& models = getGroupLibrary(ctx);
+	{
+		auto it = models.find(filename);
+
+		if (it != models.end())
+		{
+			if (onReady)
+				onReady(it->second);
+
+			std::promise<VertexBufferModel*> loaded;
+			loaded.set_value(it->second);
+
+			ModelHandle handle;
+			handle.future = loaded.get_future().share();
+			handle.reference = std::make_shared<ModelHandle::Reference>();
+
+			if (it->second)
+			{
+				handle.reference->model = it->second;
+				it->second->addReference();
+			}
+
+			return handle;
+		}
+	}
+
+	auto& request = streamingRequests[ctx.folder + '/' + filename];
+	if (!request)
+	{
+		request = std::make_shared<StreamRequest>();
+		request->name = filename;
+		request->ctx = ctx;
+		request->future = request->promise.get_future().share();
+		request->job = JobSystem::GetIo().submit([this, request]() { parseRequest(request); });
+	}
+
+	if (onReady)
+		request->callbacks.push_back(std::move(onReady));
+
+	ModelHandle handle;
+	handle.future = request->future;
+	handle.reference = request->reference.lock();
+
+	if (!handle.reference)
+	{
+		handle.reference = std::make_shared<ModelHandle::Reference>();
+		request->reference = handle.reference;
+	}
+
+	return handle;
+}
+
+void ModelResources::updateStreaming(float uploadBudgetMs)
+{
+	CpuProfiler::Zone zone("ModelResources::updateStreaming");
+
+	if (uploadFinished.valid())
+	{
+		if (uploadFinished.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return;
+
+		uploadFinished.get();
+
+		for (auto& request : uploadingRequests)
+			finishRequest(*request);
+
+		uploadingRequests.clear();
+	}
+
+	{
+		std::lock_guard lock(streamingMutex);
+		pendingUploads.insert(pendingUploads.end(), parsedQueue.begin(), parsedQueue.end());
+		parsedQueue.clear();
+	}
+
+	// failed files have nothing to upload
+	std::erase_if(pendingUploads, [this](const StreamRequestPtr& request)
+		{
+			if (request->model)
+				return false;
+
+			finishRequest(*request);
+			return true;
+		});
+
+	if (pendingUploads.empty())
+		return;
+
+	// single batch in flight, started models are finished when its fence completes
+	const auto start = std::chrono::steady_clock::now();
+	uploadBatch->Begin();
+
+	while (!pendingUploads.empty())
+	{
+		auto request = pendingUploads.front();
+		pendingUploads.pop_front();
+
+		request->model->finishUpload(&device, *uploadBatch);
+		uploadingRequests.push_back(request);
+
+		if (std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() >= uploadBudgetMs)
+			break;
+	}
+
+	uploadFinished = uploadBatch->End(commandQueue);
+}
+
+void ModelResources::flushStreaming()
+{
+	while (!streamingRequests.empty())
+	{
+		if (uploadFinished.valid())
+			uploadFinished.wait();
+		else if (pendingUploads.empty())
+		{
+			std::unique_lock lock(streamingMutex);
+			parsedCondition.wait(lock, [this] { return !parsedQueue.empty(); });
+		}
+
+		updateStreaming(std::numeric_limits<float>::max());
+	}
+}
+
+bool ModelResources::isStreaming() const
+{
+	return !streamingRequests.empty();
+}
+
+void ModelResources::parseRequest(const StreamRequestPtr& request)
+{
+	// no upload batch, buffers are created on main thread
+	request->model = loadModel(request->name, nullptr, request->ctx);
+
+	// notified under lock, owner can be destroyed right after request is taken
+	std::lock_guard lock(streamingMutex);
+	parsedQueue.push_back(request);
+	parsedCondition.notify_one();
+}
+
+void ModelResources::finishRequest(StreamRequest& request)
+{
+	auto model = request.model;
+	request.model = nullptr;
+
+	if (model)
+	{
+		auto& stored = getGroupLibrary(request.ctx)[request.name];
+
+		// loaded synchronously in meantime
+		if (stored)
+		{
+			delete model;
+			model = stored;
+		}
+		else
+			stored = model;
+	}
+
+	// outstanding handles keep model from eviction
+	if (auto reference = request.reference.lock(); reference && model)
+	{
+		reference->model = model;
+		model->addReference();
+	}
+
+	// callbacks can request same model again
+	auto callbacks = std::move(request.callbacks);
+	streamingRequests.erase(request.ctx.folder + '/' + request.name);
+
+	request.promise.set_value(model);
+
+	for (auto& callback : callbacks)
+		callback(model);
+}
+
+void ModelResources::setMemoryBudget(size_t bytes)
+{
+	memoryBudget = bytes;
+}
+
+size_t ModelResources::getMemoryBudget() const
+{
+	return memoryBudget;
+}
+
+void ModelResources::updateResidency()
+{
+	if (!memoryBudget)
+		return;
+
+	size_t residentBytes = getResidentBytes();
+	if (residentBytes <= memoryBudget)
+		return;
+
+	struct Candidate
+	{
+		ModelLibrary* library;
+		ModelLibrary::iterator it;
+	};
+	std::vector<Candidate> candidates;
+
+	for (auto& g : groups)
+	{
+		if (g.persistent || !g.reloadable)
+			continue;
+
+		for (auto it = g.models.begin(); it != g.models.end(); it++)
+		{
+			if (it->second && !it->second->pinned && it->second->references == 0)
+				candidates.push_back({ &g.models, it });
+		}
+	}
+
+	// least recently released first
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.it->second->lastReleased < b.it->second->lastReleased; });
+
+	UINT evicted = 0;
+	const size_t startBytes = residentBytes;
+
+	for (auto& c : candidates)
+	{
+		if (residentBytes <= memoryBudget)
+			break;
+
+		// buffers are released after frames in flight by garbage collector
+		residentBytes -= c.it->second->getGpuSize();
+		delete c.it->second;
+		c.library->erase(c.it);
+		evicted++;
+	}
+
+	if (evicted)
+		Logger::log(std::format("Evicted {} unused models, {} MB -> {} MB", evicted, startBytes / (1024 * 1024), residentBytes / (1024 * 1024)));
+}
+
+std::vector<ModelResources::GroupResidency> ModelResources::getResidency() const
+{
+	std::vector<GroupResidency> residency;
+
+	for (auto& g : groups)
+	{
+		auto& info = residency.emplace_back();
+		info.name = g.name;
+
+		for (auto& [name, model] : g.models)
+		{
+			if (!model)
+				continue;
+
+			info.models++;
+			info.referenced += model->references > 0 || model->pinned;
+			info.residentBytes += model->getGpuSize();
+		}
+	}
+
+	return residency;
+}
+
+size_t ModelResources::getResidentBytes() const
+{
+	size_t bytes = 0;
+
+	for (auto& g : groups)
+		for (auto& [name, model] : g.models)
+			if (model)
+				bytes += model->getGpuSize();
+
+	return bytes;
+}
+
+VertexBufferModel* ModelHandle::get() const
+{
+	return future.get();
+}
+
+bool ModelHandle::valid() const
+{
+	return future.valid();
+}
+
+bool ModelHandle::isReady() const
+{
+	return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+ModelHandle::Reference::~Reference()
+{
+	if (model)
+		model->releaseReference();
 }
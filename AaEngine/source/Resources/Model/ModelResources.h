@@ -4,6 +4,12 @@
 #include "RenderCore/RenderSystem.h"
 #include "Resources/Model/VertexBufferModel.h"
 #include "ResourceUploadBatch.h"
+#include "Utils/JobSystem.h"
+#include <future>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 
 struct ModelLoadContext
 {
@@ -11,6 +17,32 @@ struct ModelLoadContext
 	bool persistent = false;
 };
 
+// resolves to loaded model, or nullptr when loading failed
+// model counts as referenced while any copy of handle is alive so it is not evicted, release handles on main thread
+class ModelHandle
+{
+public:
+
+	ModelHandle() = default;
+
+	VertexBufferModel* get() const;
+	bool valid() const;
+	bool isReady() const;
+
+private:
+
+	friend class ModelResources;
+
+	struct Reference
+	{
+		VertexBufferModel* model{};
+		~Reference();
+	};
+
+	std::shared_future<VertexBufferModel*> future;
+	std::shared_ptr<Reference> reference;
+};
+
 class ModelResources
 {
 public:
@@ -18,6 +50,9 @@ public:
 	ModelResources(RenderSystem& rs);
 	~ModelResources();
 
+	static ModelResources& Get();
+
+	// returned models are never evicted, use loadModelAsync and keep its handle or entity reference for evictable ones
 	VertexBufferModel* getModel(const std::string& name, ResourceUploadBatch& batch, const ModelLoadContext& ctx);
 	VertexBufferModel* getModel(const std::string& path, ResourceUploadBatch& batch);
 	VertexBufferModel* getCoreModel(const std::string& name);
@@ -25,15 +60,42 @@ public:
 	VertexBufferModel* addLoadedModel(const std::string& name, const std::string& group);
 	void addLoadedModel(const std::string& name, VertexBufferModel*, const std::string& group);
 
+	// file is parsed on worker thread, GPU upload and onReady happen later in updateStreaming
+	// onReady model stays resident only while handle or entity holds reference to it
+	ModelHandle loadModelAsync(const std::string& name, const ModelLoadContext& ctx, std::function<void(VertexBufferModel*)> onReady = {});
+	// uploads parsed models until time budget is spent, call once per frame
+	void updateStreaming(float uploadBudgetMs = 2.0f);
+	// blocks until all requested models are loaded
+	void flushStreaming();
+	bool isStreaming() const;
+
+	// unreferenced models of non persistent groups are evicted when over budget, 0 disables eviction
+	// only models loaded through loadModelAsync and never returned by getModel are candidates
+	void setMemoryBudget(size_t bytes);
+	// call after render world update, so new entities already hold their references
+	void updateResidency();
+
+	struct GroupResidency
+	{
+		std::string name;
+		UINT models{};
+		UINT referenced{};
+		size_t residentBytes{};
+	};
+	std::vector<GroupResidency> getResidency() const;
+	size_t getResidentBytes() const;
+	size_t getMemoryBudget() const;
+
 	void clear();
 
 private:
 
 	ID3D12Device& device;
+	ID3D12CommandQueue* commandQueue;
 
-	UINT preloadFolder(ResourceUploadBatch& batch, const ModelLoadContext& ctx);
+	UINT preloadFolder(const ModelLoadContext& ctx);
 
-	VertexBufferModel* loadModel(const std::string& name, ResourceUploadBatch& batch, const ModelLoadContext& ctx);
+	VertexBufferModel* loadModel(const std::string& name, ResourceUploadBatch* batch, const ModelLoadContext& ctx);
 
 	using ModelLibrary = std::map<std::string, VertexBufferModel*>;
 	struct ModelLibraryGroup
@@ -41,8 +103,45 @@ private:
 		std::string name;
 		bool persistent{};
 		ModelLibrary models;
+		// models added from outside can't be loaded again by name
+		bool reloadable = true;
 	};
 	std::vector<ModelLibraryGroup> groups;
 
 	ModelLibrary& getGroupLibrary(const ModelLoadContext& ctx);
+	ModelLibraryGroup& getGroup(const ModelLoadContext& ctx);
+
+	size_t memoryBudget = 1024ull * 1024 * 1024;
+
+	struct StreamRequest
+	{
+		std::string name;
+		ModelLoadContext ctx;
+		VertexBufferModel* model{};
+
+		std::promise<VertexBufferModel*> promise;
+		std::shared_future<VertexBufferModel*> future;
+		// shared by returned handles, gets model reference when loaded
+		std::weak_ptr<ModelHandle::Reference> reference;
+		std::vector<std::function<void(VertexBufferModel*)>> callbacks;
+
+		// parsing on I/O workers
+		JobSystem::Handle job;
+	};
+	using StreamRequestPtr = std::shared_ptr<StreamRequest>;
+
+	// main thread only, by folder/name
+	std::map<std::string, StreamRequestPtr> streamingRequests;
+	std::deque<StreamRequestPtr> pendingUploads;
+	std::vector<StreamRequestPtr> uploadingRequests;
+	std::unique_ptr<ResourceUploadBatch> uploadBatch;
+	std::future<void> uploadFinished;
+
+	// shared with I/O jobs
+	std::mutex streamingMutex;
+	std::condition_variable parsedCondition;
+	std::deque<StreamRequestPtr> parsedQueue;
+
+	void parseRequest(const StreamRequestPtr& request);
+	void finishRequest(StreamRequest& request);
 };
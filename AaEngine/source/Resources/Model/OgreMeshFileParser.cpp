@@ -1,6 +1,8 @@
 #include "Resources/Model/OgreMeshFileParser.h"
+#include "Resources/Model/MeshletBuilder.h"
 #include "Utils/Logger.h"
 #include <map>
+#include <algorithm>
 
 using namespace OgreMeshFileParser;
 
@@ -527,6 +529,30 @@ void readGeometry(std::ifstream& stream, VertexBufferModel& info, ModelParseOpti
 	}
 }
 
+// vertex data comes later in the stream, only index order is optimized
+template<typename T>
+MeshOptimizer::Report optimizeIndices(std::vector<T>& data)
+{
+	MeshOptimizer::Report report;
+	if (data.empty())
+		return report;
+
+	std::vector<uint32_t> indices(data.size());
+	for (size_t i = 0; i < data.size(); i++)
+		indices[i] = data[i];
+
+	report.vertexCount = *std::max_element(indices.begin(), indices.end()) + 1;
+	report.before = MeshOptimizer::analyzeVertexCache(indices, report.vertexCount);
+
+	MeshOptimizer::optimizeVertexCache(indices, report.vertexCount);
+	report.after = MeshOptimizer::analyzeVertexCache(indices, report.vertexCount);
+
+	for (size_t i = 0; i < data.size(); i++)
+		data[i] = (T)indices[i];
+
+	return report;
+}
+
 void readSubMesh(std::ifstream& stream, MeshInfo& info, ModelParseOptions o)
 {
 	SubmeshInfo submesh{};
@@ -549,6 +575,7 @@ void readSubMesh(std::ifstream& stream, MeshInfo& info, ModelParseOptions o)
 			std::vector<uint32_t> data;
 			data.resize(submesh.model->indexCount);
 			readData(stream, data.data(), submesh.model->indexCount);
+			submesh.optimization = optimizeIndices(data);
 			submesh.model->CreateIndexBuffer(o.device, o.batch, data.data(), submesh.model->indexCount);
 		}
 		else // 16-bit
@@ -556,6 +583,7 @@ void readSubMesh(std::ifstream& stream, MeshInfo& info, ModelParseOptions o)
 			std::vector<uint16_t> data;
 			data.resize(submesh.model->indexCount);
 			readData(stream, data.data(), submesh.model->indexCount);
+			submesh.optimization = optimizeIndices(data);
 			submesh.model->CreateIndexBuffer(o.device, o.batch, data.data(), data.size());
 		}
 	}
@@ -608,6 +636,8 @@ void readSubMesh(std::ifstream& stream, MeshInfo& info, ModelParseOptions o)
 		}
 	}
 
+	submesh.model->meshlets = MeshletBuilder::build(*submesh.model);
+
 	info.submeshes.emplace_back(std::move(submesh));
 }
 
@@ -725,5 +755,17 @@ MeshInfo OgreMeshFileParser::load(std::string filename, ModelParseOptions o)
 		return {};
 	}
 
+	float acmrBefore{}, acmrAfter{};
+	size_t triangles{};
+	for (auto& submesh : out.submeshes)
+	{
+		const auto submeshTriangles = submesh.model->indexCount / 3;
+		acmrBefore += submesh.optimization.before.acmr * submeshTriangles;
+		acmrAfter += submesh.optimization.after.acmr * submeshTriangles;
+		triangles += submeshTriangles;
+	}
+	if (triangles)
+		Logger::log(std::format("Mesh optimization {}: {} triangles, ACMR {:.3f} -> {:.3f}", filename, triangles, acmrBefore / triangles, acmrAfter / triangles));
+
 	return out;
 }
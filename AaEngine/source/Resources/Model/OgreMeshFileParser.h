@@ -7,6 +7,7 @@
 #include <SimpleMath.h>
 #include "Resources/Model/VertexBufferModel.h"
 #include "Resources/Model/ModelParseOptions.h"
+#include "Resources/Model/MeshOptimizer.h"
 
 using namespace DirectX::SimpleMath;
 
@@ -18,6 +19,8 @@ namespace OgreMeshFileParser
 
 		std::string name;
 		std::string materialName;
+
+		MeshOptimizer::Report optimization;
 	};
 	struct MeshInfo
 	{
@@ -2,8 +2,11 @@
 #include "Resources/Model/VertexBufferModelGarbageCollector.h"
 #include "RenderCore/RenderSystem.h"
 #include <functional>
+#include <cstring>
 #include <BufferHelpers.h>
+#include <DirectXPackedVector.h>
 #include "Utils/MathUtils.h"
+#include "Utils/RenderStats.h"
 
 VertexBufferModel::VertexBufferModel()
 {
@@ -18,6 +21,34 @@ VertexBufferModel::~VertexBufferModel()
 		VertexBufferModelGarbageCollector::Get().enqueue(indexBuffer);
 }
 
+// entities and handles can be released on worker threads
+static std::atomic<uint64_t> ReleaseCounter = 0;
+
+void VertexBufferModel::addReference()
+{
+	references++;
+}
+
+void VertexBufferModel::releaseReference()
+{
+	references--;
+	lastReleased = ++ReleaseCounter;
+}
+
+size_t VertexBufferModel::getGpuSize() const
+{
+	if (!owner)
+		return 0;
+
+	size_t size = 0;
+	if (vertexBuffer)
+		size += vertexBufferView.SizeInBytes;
+	if (indexBuffer)
+		size += indexBufferView.SizeInBytes;
+
+	return size;
+}
+
 void VertexBufferModel::addLayoutElement(unsigned short slot, UINT offset, DXGI_FORMAT format, const char* semantic, unsigned short index)
 {
 	D3D12_INPUT_ELEMENT_DESC desc{};
@@ -161,17 +192,16 @@ void VertexBufferModel::CreateVertexBuffer(ID3D12Device* device, ResourceUploadB
 {
 	vertexCount = vc;
 
-	auto hr = CreateStaticBuffer(device, *memory,
-		vertices,
-		vertexCount,
-		vertexSize,
-		D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, &vertexBuffer);
+	if (memory)
+		createVertexResource(device, *memory, vertices, vertexSize);
+	else
+	{
+		if (!pendingUpload)
+			pendingUpload = std::make_unique<PendingUpload>();
 
-	// Create the vertex buffer view
-	vertexBufferView.BufferLocation = vertexBuffer->GetGPUVirtualAddress();
-	vertexBufferView.SizeInBytes = vertexCount * vertexSize;
-	vertexBufferView.StrideInBytes = vertexSize;
-	vertexBuffer->SetName(L"VB");
+		pendingUpload->vertexData.assign((const uint8_t*)vertices, (const uint8_t*)vertices + size_t(vc) * vertexSize);
+		pendingUpload->vertexSize = vertexSize;
+	}
 
 	if (!noPositions)
 	{
@@ -198,6 +228,11 @@ void VertexBufferModel::CreateVertexBuffer(ID3D12Device* device, ResourceUploadB
 				{
 					positions[i] = { 0, positionsPtr[0], 0 };
 				}
+				else if (desc->Format == DXGI_FORMAT_R16G16B16A16_FLOAT)
+				{
+					auto halfPtr = (const PackedVector::HALF*)positionsPtr;
+					positions[i] = { PackedVector::XMConvertHalfToFloat(halfPtr[0]), PackedVector::XMConvertHalfToFloat(halfPtr[1]), PackedVector::XMConvertHalfToFloat(halfPtr[2]) };
+				}
 			}
 		}
 	}
@@ -222,15 +257,16 @@ void VertexBufferModel::CreateIndexBuffer(ID3D12Device* device, ResourceUploadBa
 {
 	indexCount = (uint32_t)dataCount;
 
-	auto hr = CreateStaticBuffer(device, *memory,
-		data, dataCount,
-		D3D12_RESOURCE_STATE_INDEX_BUFFER, &indexBuffer);
+	if (memory)
+		createIndexResource(device, *memory, data, DXGI_FORMAT_R16_UINT);
+	else
+	{
+		if (!pendingUpload)
+			pendingUpload = std::make_unique<PendingUpload>();
 
-	// Create the index buffer view
-	indexBufferView.BufferLocation = indexBuffer->GetGPUVirtualAddress();
-	indexBufferView.SizeInBytes = static_cast<UINT>(dataCount) * sizeof(uint16_t);
-	indexBufferView.Format = DXGI_FORMAT_R16_UINT;
-	indexBuffer->SetName(L"IB");
+		pendingUpload->indexData.assign((const uint8_t*)data, (const uint8_t*)(data + dataCount));
+		pendingUpload->indexFormat = DXGI_FORMAT_R16_UINT;
+	}
 
 	indices.resize(dataCount);
 	for (size_t i = 0; i < dataCount; i++)
@@ -243,15 +279,16 @@ void VertexBufferModel::CreateIndexBuffer(ID3D12Device* device, ResourceUploadBa
 {
 	indexCount = (uint32_t)dataCount;
 
-	auto hr = CreateStaticBuffer(device, *memory,
-		data, dataCount,
-		D3D12_RESOURCE_STATE_INDEX_BUFFER, &indexBuffer);
+	if (memory)
+		createIndexResource(device, *memory, data, DXGI_FORMAT_R32_UINT);
+	else
+	{
+		if (!pendingUpload)
+			pendingUpload = std::make_unique<PendingUpload>();
 
-	// Create the index buffer view
-	indexBufferView.BufferLocation = indexBuffer->GetGPUVirtualAddress();
-	indexBufferView.SizeInBytes = static_cast<UINT>(dataCount) * sizeof(uint32_t);
-	indexBufferView.Format = DXGI_FORMAT_R32_UINT;
-	indexBuffer->SetName(L"IB");
+		pendingUpload->indexData.assign((const uint8_t*)data, (const uint8_t*)(data + dataCount));
+		pendingUpload->indexFormat = DXGI_FORMAT_R32_UINT;
+	}
 
 	indices.resize(dataCount);
 	for (size_t i = 0; i < dataCount; i++)
@@ -260,6 +297,57 @@ void VertexBufferModel::CreateIndexBuffer(ID3D12Device* device, ResourceUploadBa
 	}
 }
 
+void VertexBufferModel::createVertexResource(ID3D12Device* device, ResourceUploadBatch& memory, const void* vertices, UINT vertexSize)
+{
+	auto hr = CreateStaticBuffer(device, memory,
+		vertices,
+		vertexCount,
+		vertexSize,
+		D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, &vertexBuffer);
+
+	// Create the vertex buffer view
+	vertexBufferView.BufferLocation = vertexBuffer->GetGPUVirtualAddress();
+	vertexBufferView.SizeInBytes = vertexCount * vertexSize;
+	vertexBufferView.StrideInBytes = vertexSize;
+	vertexBuffer->SetName(L"VB");
+}
+
+void VertexBufferModel::createIndexResource(ID3D12Device* device, ResourceUploadBatch& memory, const void* data, DXGI_FORMAT format)
+{
+	const UINT indexSize = format == DXGI_FORMAT_R16_UINT ? sizeof(uint16_t) : sizeof(uint32_t);
+
+	auto hr = CreateStaticBuffer(device, memory,
+		data, indexCount, indexSize,
+		D3D12_RESOURCE_STATE_INDEX_BUFFER, &indexBuffer);
+
+	// Create the index buffer view
+	indexBufferView.BufferLocation = indexBuffer->GetGPUVirtualAddress();
+	indexBufferView.SizeInBytes = indexCount * indexSize;
+	indexBufferView.Format = format;
+	indexBuffer->SetName(L"IB");
+}
+
+bool VertexBufferModel::hasPendingUpload() const
+{
+	return pendingUpload != nullptr;
+}
+
+void VertexBufferModel::finishUpload(ID3D12Device* device, ResourceUploadBatch& memory)
+{
+	if (!pendingUpload)
+		return;
+
+	if (!pendingUpload->vertexData.empty())
+		createVertexResource(device, memory, pendingUpload->vertexData.data(), pendingUpload->vertexSize);
+	if (!pendingUpload->indexData.empty())
+		createIndexResource(device, memory, pendingUpload->indexData.data(), pendingUpload->indexFormat);
+
+	RenderStats::Add(RenderStat::UploadedModels);
+	RenderStats::Add(RenderStat::UploadBytes, pendingUpload->vertexData.size() + pendingUpload->indexData.size());
+
+	pendingUpload.reset();
+}
+
 void VertexBufferModel::SetIndexBuffer(ID3D12Resource* buffer, uint32_t dataCount)
 {
 	owner = false;
@@ -413,6 +501,13 @@ void VertexBufferModel::calculateBounds(const void* vertexData, uint32_t vc, uin
 
 	for (uint32_t i = 0; i < vc; i++)
 	{
+		if (posDesc->Format == DXGI_FORMAT_R16G16B16A16_FLOAT)
+		{
+			auto pos = (const PackedVector::HALF*)(data + i * vertexStride + posDesc->AlignedByteOffset);
+			volume.add({ PackedVector::XMConvertHalfToFloat(pos[0]), PackedVector::XMConvertHalfToFloat(pos[1]), PackedVector::XMConvertHalfToFloat(pos[2]) });
+			continue;
+		}
+
 		auto pos = (const float*)(data + i * vertexStride + posDesc->AlignedByteOffset);
 		volume.add({ pos[0], pos[1], pos[2] });
 	}
@@ -455,3 +550,8 @@ const char* VertexElementSemantic::GetConstName(const std::string& semantic)
 
 	return nullptr;
 }
+
+bool VertexElementSemantic::IsSemantic(const char* name, const char* semantic)
+{
+	return name && strcmp(name, semantic) == 0;
+}
@@ -4,9 +4,12 @@
 #include <cstdint>
 #include <vector>
 #include <string>
+#include <memory>
+#include <atomic>
 #include <DirectXCollision.h>
 #include "ResourceUploadBatch.h"
 #include "Utils/MathUtils.h"
+#include "Resources/Model/BinaryModelSerialization.h"
 
 using namespace DirectX;
 
@@ -23,6 +26,8 @@ namespace VertexElementSemantic
 	constexpr const char* BLEND_INDICES = "BLENDINDICES";
 
 	const char* GetConstName(const std::string&);
+	// compares names, semantic strings can come from different sources
+	bool IsSemantic(const char* name, const char* semantic);
 }
 
 class VertexBufferModel
@@ -61,5 +66,52 @@ public:
 	std::vector<Vector3> positions;
 	std::vector<uint32_t> indices;
 
+	struct Submesh
+	{
+		uint32_t indexStart{};
+		uint32_t indexCount{};
+		std::string material;
+	};
+	std::vector<Submesh> submeshes;
+
+	struct LodRange
+	{
+		uint32_t indexStart{};
+		uint32_t indexCount{};
+		float distance{};
+	};
+	std::vector<LodRange> lods;
+
+	// CPU side clusters built at import, see MeshletBuilder
+	ModelMeshlets meshlets;
+
 	bool owner = true;
+
+	// render entities and model handles using this model, unreferenced ones can be evicted by ModelResources
+	std::atomic<uint32_t> references = 0;
+	// handed out as raw pointer by ModelResources::getModel, holders are unknown so it is never evicted
+	bool pinned = false;
+	// release order, lower was unused for longer
+	uint64_t lastReleased = 0;
+	void addReference();
+	void releaseReference();
+	size_t getGpuSize() const;
+
+	// buffers created without upload batch keep CPU data until finishUpload, used by worker thread loading
+	bool hasPendingUpload() const;
+	void finishUpload(ID3D12Device* device, ResourceUploadBatch& memory);
+
+private:
+
+	void createVertexResource(ID3D12Device* device, ResourceUploadBatch& memory, const void* vertices, UINT vertexSize);
+	void createIndexResource(ID3D12Device* device, ResourceUploadBatch& memory, const void* data, DXGI_FORMAT format);
+
+	struct PendingUpload
+	{
+		std::vector<uint8_t> vertexData;
+		UINT vertexSize{};
+		std::vector<uint8_t> indexData;
+		DXGI_FORMAT indexFormat = DXGI_FORMAT_UNKNOWN;
+	};
+	std::unique_ptr<PendingUpload> pendingUpload;
 };
@@ -0,0 +1,313 @@
+#include "Resources/Model/VertexQuantization.h"
+#include "Resources/Model/VertexBufferModel.h"
+#include "Utils/Logger.h"
+#include <DirectXPackedVector.h>
+#include <algorithm>
+#include <cstring>
+#include <cfloat>
+#include <cmath>
+
+using namespace DirectX::PackedVector;
+using VertexElementSemantic::IsSemantic;
+
+static bool IsOctahedralFormat(DXGI_FORMAT format)
+{
+	return format == DXGI_FORMAT_R8G8_SNORM || format == DXGI_FORMAT_R16G16_SNORM;
+}
+
+static UINT FloatComponents(DXGI_FORMAT format)
+{
+	switch (format)
+	{
+	case DXGI_FORMAT_R32_FLOAT:
+		return 1;
+	case DXGI_FORMAT_R32G32_FLOAT:
+		return 2;
+	case DXGI_FORMAT_R32G32B32_FLOAT:
+		return 3;
+	case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		return 4;
+	default:
+		return 0;
+	}
+}
+
+static UINT PackedSize(DXGI_FORMAT format)
+{
+	switch (format)
+	{
+	case DXGI_FORMAT_R8G8_SNORM:
+		return 2;
+	case DXGI_FORMAT_R16G16_SNORM:
+	case DXGI_FORMAT_R16G16_FLOAT:
+		return 4;
+	case DXGI_FORMAT_R16G16B16A16_FLOAT:
+		return 8;
+	default:
+		return FloatComponents(format) * sizeof(float);
+	}
+}
+
+static void ReadFloats(const VertexQuantization::SourceElement& e, size_t vertex, float* out, UINT count)
+{
+	memcpy(out, e.data + vertex * e.stride, count * sizeof(float));
+}
+
+static float SignNotZero(float v)
+{
+	return v >= 0.0f ? 1.0f : -1.0f;
+}
+
+void VertexQuantization::EncodeOctahedral(const float* n, float& x, float& y)
+{
+	const float l1 = std::abs(n[0]) + std::abs(n[1]) + std::abs(n[2]);
+	if (l1 <= 0.0f)
+	{
+		x = y = 0.0f;
+		return;
+	}
+
+	x = n[0] / l1;
+	y = n[1] / l1;
+
+	if (n[2] < 0.0f)
+	{
+		const float ox = x;
+		x = (1.0f - std::abs(y)) * SignNotZero(ox);
+		y = (1.0f - std::abs(ox)) * SignNotZero(y);
+	}
+}
+
+void VertexQuantization::DecodeOctahedral(float x, float y, float* n)
+{
+	n[0] = x;
+	n[1] = y;
+	n[2] = 1.0f - std::abs(x) - std::abs(y);
+
+	if (n[2] < 0.0f)
+	{
+		const float ox = n[0];
+		n[0] = (1.0f - std::abs(n[1])) * SignNotZero(ox);
+		n[1] = (1.0f - std::abs(ox)) * SignNotZero(n[1]);
+	}
+
+	const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+	for (int i = 0; i < 3; i++)
+		n[i] /= length;
+}
+
+// picks the closest direction from the neighbouring snorm values, plain rounding can be off by a few degrees at 8 bits
+// yParity forces lowest bit of y value, used to store tangent handedness
+template<typename T>
+static void WriteOctahedral(uint8_t* dst, const float* n, int yParity = -1)
+{
+	constexpr float Max = (float)((1 << (sizeof(T) * 8 - 1)) - 1);
+
+	float x, y;
+	VertexQuantization::EncodeOctahedral(n, x, y);
+
+	const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+	T best[2]{};
+	float bestDot = -FLT_MAX;
+
+	// values with wrong parity are skipped, wider range keeps 2 candidates for y
+	const float yRange = yParity < 0 ? 0.0f : 1.0f;
+
+	for (float qx : { std::floor(x * Max), std::ceil(x * Max) })
+	{
+		for (float qy = std::floor(y * Max) - yRange; qy <= std::ceil(y * Max) + yRange; qy++)
+		{
+			if (std::abs(qy) > Max || (yParity >= 0 && (int(qy) & 1) != yParity))
+				continue;
+
+			float decoded[3];
+			VertexQuantization::DecodeOctahedral(qx / Max, qy / Max, decoded);
+
+			const float dot = length > 0.0f ? (decoded[0] * n[0] + decoded[1] * n[1] + decoded[2] * n[2]) / length : 0.0f;
+			if (dot > bestDot)
+			{
+				bestDot = dot;
+				best[0] = (T)qx;
+				best[1] = (T)qy;
+			}
+		}
+	}
+
+	memcpy(dst, best, sizeof(best));
+}
+
+static bool CanPackPositions(const VertexQuantization::SourceElement& e, size_t vertexCount, float tolerance)
+{
+	float minV[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float maxV[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		float p[3];
+		ReadFloats(e, i, p, 3);
+
+		for (int c = 0; c < 3; c++)
+		{
+			minV[c] = std::min(minV[c], p[c]);
+			maxV[c] = std::max(maxV[c], p[c]);
+		}
+	}
+
+	float extent = 0;
+	float largest = 0;
+	for (int c = 0; c < 3; c++)
+	{
+		extent = std::max(extent, maxV[c] - minV[c]);
+		largest = std::max({ largest, std::abs(minV[c]), std::abs(maxV[c]) });
+	}
+
+	if (largest > 65504.0f)
+		return false;
+	if (extent <= 0.0f)
+		return largest == 0.0f;
+
+	// half has 11 significant bits, rounding error is half of the spacing at largest coordinate
+	int exponent;
+	std::frexp(largest, &exponent);
+	const float maxError = std::ldexp(1.0f, exponent - 12);
+
+	return maxError <= extent * tolerance;
+}
+
+static bool CanPackTexcoords(const VertexQuantization::SourceElement& e, size_t vertexCount, float maxValue)
+{
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		float uv[2];
+		ReadFloats(e, i, uv, 2);
+
+		if (std::abs(uv[0]) > maxValue || std::abs(uv[1]) > maxValue)
+			return false;
+	}
+
+	return true;
+}
+
+VertexQuantization::Result VertexQuantization::Quantize(std::span<const SourceElement> elements, size_t vertexCount, const Settings& settings)
+{
+	Result result;
+	result.stats.vertexCount = vertexCount;
+
+	struct Plan
+	{
+		const SourceElement* source;
+		UINT components;
+		DXGI_FORMAT format;
+	};
+	std::vector<Plan> plans;
+	UINT octahedralCount = 0;
+
+	for (auto& e : elements)
+	{
+		auto components = FloatComponents(e.format);
+		if (!components)
+		{
+			Logger::logWarning(std::string("Unsupported vertex element format for quantization ") + e.semantic);
+			continue;
+		}
+
+		result.stats.sourceVertexSize += components * sizeof(float);
+
+		Plan plan{ &e, components, e.format };
+
+		if (IsSemantic(e.semantic, VertexElementSemantic::NORMAL) && components >= 3 && settings.normals)
+			plan.format = DXGI_FORMAT_R8G8_SNORM;
+		else if (IsSemantic(e.semantic, VertexElementSemantic::TANGENT) && components >= 3 && settings.tangents)
+			plan.format = DXGI_FORMAT_R16G16_SNORM;
+		else if (IsSemantic(e.semantic, VertexElementSemantic::TEXCOORD) && components == 2 && settings.texcoords && CanPackTexcoords(e, vertexCount, settings.maxHalfTexcoord))
+			plan.format = DXGI_FORMAT_R16G16_FLOAT;
+		else if (IsSemantic(e.semantic, VertexElementSemantic::POSITION) && components == 3 && settings.positions && CanPackPositions(e, vertexCount, settings.positionTolerance))
+			plan.format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+
+		if (plan.format == DXGI_FORMAT_R8G8_SNORM)
+			octahedralCount++;
+
+		plans.push_back(plan);
+	}
+
+	// 2 byte elements would leave the stride unaligned, single one gets 16 bit components instead
+	if (octahedralCount % 2)
+	{
+		for (auto& p : plans)
+			if (p.format == DXGI_FORMAT_R8G8_SNORM)
+			{
+				p.format = DXGI_FORMAT_R16G16_SNORM;
+				break;
+			}
+	}
+
+	// larger elements first keeps every offset aligned to its element size
+	std::stable_sort(plans.begin(), plans.end(), [](const Plan& a, const Plan& b) { return PackedSize(a.format) > PackedSize(b.format); });
+
+	std::vector<UINT> offsets;
+	for (auto& p : plans)
+	{
+		offsets.push_back(result.vertexSize);
+		result.vertexSize += PackedSize(p.format);
+		result.layout.push_back({ p.source->semantic, p.source->semanticIndex, p.format, offsets.back() });
+
+		if (p.format == DXGI_FORMAT_R16G16B16A16_FLOAT)
+			result.stats.positionsPacked = true;
+	}
+	result.stats.packedVertexSize = result.vertexSize;
+
+	result.vertices.resize(vertexCount * result.vertexSize);
+
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		auto vertex = result.vertices.data() + i * result.vertexSize;
+
+		for (size_t e = 0; e < plans.size(); e++)
+		{
+			auto& p = plans[e];
+			auto dst = vertex + offsets[e];
+
+			float v[4]{};
+			ReadFloats(*p.source, i, v, p.components);
+
+			if (p.format == DXGI_FORMAT_R8G8_SNORM)
+				WriteOctahedral<int8_t>(dst, v);
+			else if (p.format == DXGI_FORMAT_R16G16_SNORM && IsSemantic(p.source->semantic, VertexElementSemantic::TANGENT))
+				WriteOctahedral<int16_t>(dst, v, v[3] < 0.0f ? 1 : 0);
+			else if (p.format == DXGI_FORMAT_R16G16_SNORM)
+				WriteOctahedral<int16_t>(dst, v);
+			else if (p.format == DXGI_FORMAT_R16G16_FLOAT)
+			{
+				HALF h[2] = { XMConvertFloatToHalf(v[0]), XMConvertFloatToHalf(v[1]) };
+				memcpy(dst, h, sizeof(h));
+			}
+			else if (p.format == DXGI_FORMAT_R16G16B16A16_FLOAT)
+			{
+				HALF h[4] = { XMConvertFloatToHalf(v[0]), XMConvertFloatToHalf(v[1]), XMConvertFloatToHalf(v[2]), XMConvertFloatToHalf(1.0f) };
+				memcpy(dst, h, sizeof(h));
+			}
+			else
+				memcpy(dst, v, p.components * sizeof(float));
+		}
+	}
+
+	return result;
+}
+
+std::vector<std::pair<std::string, std::string>> VertexQuantization::GetLayoutDefines(const std::vector<D3D12_INPUT_ELEMENT_DESC>& layout)
+{
+	std::vector<std::pair<std::string, std::string>> defines;
+
+	for (auto& e : layout)
+	{
+		if (!IsOctahedralFormat(e.Format))
+			continue;
+
+		if (IsSemantic(e.SemanticName, VertexElementSemantic::NORMAL))
+			defines.emplace_back("PACKED_NORMAL_OCT", "1");
+		else if (IsSemantic(e.SemanticName, VertexElementSemantic::TANGENT))
+			defines.emplace_back("PACKED_TANGENT_OCT", "1");
+	}
+
+	return defines;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <d3d12.h>
+#include <vector>
+#include <span>
+#include <string>
+#include <cstdint>
+
+// Import time packing of float vertex attributes into smaller formats
+namespace VertexQuantization
+{
+	struct Settings
+	{
+		bool normals = true;	// octahedral R8G8_SNORM
+		bool tangents = true;	// octahedral R16G16_SNORM, handedness in lowest bit of y
+		bool texcoords = true;	// R16G16_FLOAT
+		bool positions = true;	// R16G16B16A16_FLOAT
+
+		// max allowed position error relative to largest AABB extent
+		float positionTolerance = 1.0f / 2048;
+		// larger texcoords lose too much precision as half
+		float maxHalfTexcoord = 2.0f;
+	};
+
+	// float source attribute stream
+	struct SourceElement
+	{
+		const char* semantic;
+		UINT semanticIndex;
+		DXGI_FORMAT format;
+		const uint8_t* data;
+		UINT stride;
+	};
+
+	struct PackedElement
+	{
+		const char* semantic;
+		UINT semanticIndex;
+		DXGI_FORMAT format;
+		UINT offset;
+	};
+
+	struct Stats
+	{
+		size_t vertexCount{};
+		UINT sourceVertexSize{};
+		UINT packedVertexSize{};
+		bool positionsPacked{};
+
+		size_t sourceBytes() const { return vertexCount * sourceVertexSize; }
+		size_t packedBytes() const { return vertexCount * packedVertexSize; }
+	};
+
+	struct Result
+	{
+		std::vector<PackedElement> layout;
+		std::vector<uint8_t> vertices;
+		UINT vertexSize{};
+		Stats stats;
+	};
+
+	Result Quantize(std::span<const SourceElement> elements, size_t vertexCount, const Settings& settings = {});
+
+	// shader defines needed to decode vertices with given layout
+	std::vector<std::pair<std::string, std::string>> GetLayoutDefines(const std::vector<D3D12_INPUT_ELEMENT_DESC>& layout);
+
+	// octahedral mapping in -1..1, matches DecodeVertexOctahedral in hlsl
+	void EncodeOctahedral(const float* n, float& x, float& y);
+	void DecodeOctahedral(float x, float y, float* n);
+}
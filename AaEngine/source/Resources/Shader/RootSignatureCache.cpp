@@ -0,0 +1,112 @@
+#include "Resources/Shader/RootSignatureCache.h"
+#include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
+#include <algorithm>
+#include <format>
+
+RootSignatureCache& RootSignatureCache::Get()
+{
+	static RootSignatureCache instance;
+	return instance;
+}
+
+ID3D12RootSignature* RootSignatureCache::getOrCreate(ID3D12Device& device, ID3DBlob& serialized, const wchar_t* name, const RootSignatureUsage& usage)
+{
+	std::string_view layout((const char*)serialized.GetBufferPointer(), serialized.GetBufferSize());
+	const auto hash = std::hash<std::string_view>{}(layout);
+
+	std::lock_guard lock(mutex);
+	requests++;
+
+	for (auto& e : entries)
+	{
+		if (e.hash == hash && e.layout == layout)
+		{
+			if (auto user = as_string(name); std::find(e.users.begin(), e.users.end(), user) == e.users.end())
+				e.users.push_back(user);
+
+			e.signature->AddRef();
+			return e.signature.Get();
+		}
+	}
+
+	ComPtr<ID3D12RootSignature> signature;
+	auto hr = device.CreateRootSignature(0, serialized.GetBufferPointer(), serialized.GetBufferSize(), IID_PPV_ARGS(&signature));
+	if (FAILED(hr))
+	{
+		Logger::logErrorD3D("Failed CreateRootSignature", hr);
+		return nullptr;
+	}
+	signature->SetName(name);
+
+	if (usage.dwords() > NearLimitDwords)
+		Logger::logWarning(std::format("Root signature {} uses {}/{} DWORDs", as_string(name), usage.dwords(), RootSignatureUsage::MaxDwords));
+
+	auto& e = entries.emplace_back(hash, std::string(layout), signature, usage);
+	e.users.push_back(as_string(name));
+
+	signature->AddRef();
+	return signature.Get();
+}
+
+void RootSignatureCache::releaseUnused()
+{
+	std::lock_guard lock(mutex);
+
+	std::erase_if(entries, [](Entry& e)
+		{
+			e.signature->AddRef();
+			return e.signature->Release() == 1;
+		});
+}
+
+void RootSignatureCache::clear()
+{
+	std::lock_guard lock(mutex);
+	entries.clear();
+}
+
+RootSignatureCache::Stats RootSignatureCache::getStats() const
+{
+	std::lock_guard lock(mutex);
+
+	Stats stats;
+	stats.requests = requests;
+	stats.unique = (UINT)entries.size();
+
+	for (auto& e : entries)
+	{
+		stats.maxDwords = std::max(stats.maxDwords, e.usage.dwords());
+		if (e.usage.dwords() > NearLimitDwords)
+			stats.nearLimit++;
+	}
+
+	return stats;
+}
+
+void RootSignatureCache::logReport() const
+{
+	std::lock_guard lock(mutex);
+
+	std::vector<const Entry*> sorted;
+	for (auto& e : entries)
+		sorted.push_back(&e);
+
+	std::sort(sorted.begin(), sorted.end(), [](const Entry* l, const Entry* r) { return l->usage.dwords() > r->usage.dwords(); });
+
+	std::string report = std::format("Root signatures: {} unique for {} requests\n", entries.size(), requests);
+
+	for (auto e : sorted)
+	{
+		report += std::format("{:2}/{} DWORDs{} | constants {}, root descriptors {}, tables {}, static samplers {} | shared by {}:",
+			e->usage.dwords(), RootSignatureUsage::MaxDwords, e->usage.dwords() > NearLimitDwords ? " (near limit)" : "",
+			e->usage.constantsDwords, e->usage.rootDescriptors, e->usage.descriptorTables, e->usage.staticSamplers, e->users.size());
+
+		for (auto& u : e->users)
+			report += " " + u;
+
+		report += "\n";
+	}
+
+	Logger::log(report);
+}
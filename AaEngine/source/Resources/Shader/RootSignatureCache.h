@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Utils/Directx.h"
+#include <string>
+#include <vector>
+#include <mutex>
+
+struct RootSignatureUsage
+{
+	UINT constantsDwords{};
+	UINT rootDescriptors{};
+	UINT descriptorTables{};
+	UINT staticSamplers{};
+
+	static constexpr UINT MaxDwords = 64;
+	static constexpr UINT RootDescriptorDwords = 2;
+
+	UINT dwords() const { return constantsDwords + rootDescriptors * RootDescriptorDwords + descriptorTables; }
+};
+
+// Root signatures deduplicated by their serialized layout, shared between all materials and compute shaders
+class RootSignatureCache
+{
+public:
+
+	static RootSignatureCache& Get();
+
+	// returns signature with identical layout or creates new one, returned signature has reference added for caller
+	ID3D12RootSignature* getOrCreate(ID3D12Device& device, ID3DBlob& serialized, const wchar_t* name, const RootSignatureUsage& usage);
+
+	// drop signatures not referenced outside of cache anymore
+	void releaseUnused();
+	void clear();
+
+	struct Stats
+	{
+		UINT requests{};
+		UINT unique{};
+		UINT maxDwords{};
+		UINT nearLimit{};
+	};
+	Stats getStats() const;
+
+	// log DWORD usage of every signature, sorted from largest
+	void logReport() const;
+
+	static constexpr UINT NearLimitDwords = 48;
+
+private:
+
+	struct Entry
+	{
+		size_t hash;
+		std::string layout;
+		ComPtr<ID3D12RootSignature> signature;
+		RootSignatureUsage usage;
+		std::vector<std::string> users;
+	};
+	std::vector<Entry> entries;
+	UINT requests{};
+
+	mutable std::mutex mutex;
+};
@@ -14,6 +14,12 @@ ShaderConstantsProvider::ShaderConstantsProvider(const FrameParameters& p, const
 	viewportSize = { targets.width, targets.height };
 }
 
+ShaderConstantsProvider::ShaderConstantsProvider(const FrameParameters& p, const RenderObjectsVisibilityData& i, const Camera& c, XMUINT2 size) : info(i), camera(c), mainCamera(c), params(p)
+{
+	inverseViewportSize = { 1.f / size.x, 1.f / size.y };
+	viewportSize = size;
+}
+
 ShaderConstantsProvider::ShaderConstantsProvider(const FrameParameters& params, const RenderObjectsVisibilityData& info, const Camera& camera, const GpuTexture2D& target) :
 	ShaderConstantsProvider(params, info, camera, camera, target)
 {
@@ -61,7 +67,7 @@ XMMATRIX ShaderConstantsProvider::getInverseProjectionMatrix() const
 
 XMFLOAT3 ShaderConstantsProvider::getWorldPosition() const
 {
-	return entity->getPosition();
+	return entity->getWorldPosition();
 }
 
 XMFLOAT3 ShaderConstantsProvider::getCameraPosition() const
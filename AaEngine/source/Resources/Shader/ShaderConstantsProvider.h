@@ -34,6 +34,8 @@ public:
 	ShaderConstantsProvider(const FrameParameters& params, const RenderObjectsVisibilityData& info, const Camera& camera, const GpuTexture2D& target);
 	ShaderConstantsProvider(const FrameParameters& params, const RenderObjectsVisibilityData& info, const Camera& camera, const Camera& mainCamera, const GpuTexture2D& target);
 	ShaderConstantsProvider(const FrameParameters& params, const RenderObjectsVisibilityData& info, const Camera& camera, const RenderTargetTexturesView& targets);
+	// without target texture, like in headless benchmark
+	ShaderConstantsProvider(const FrameParameters& params, const RenderObjectsVisibilityData& info, const Camera& camera, XMUINT2 viewportSize);
 
 	XMFLOAT2 inverseViewportSize;
 	XMUINT2 viewportSize;
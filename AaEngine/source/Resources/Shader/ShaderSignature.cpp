@@ -179,19 +179,11 @@ void SignatureInfo::setTexturesVolatile()
 
 void SignatureInfo::finish()
 {
-	UINT rootIndex = 0;
-
 	if (!cbuffers.empty())
 	{
-		// +1 for potential move to root constants
-		const auto rootParamsSizeMax = (64 - (!bindlessTextures && !textures.empty()) - cbuffers.size() - structuredBuffers.size() - rwStructuredBuffers.size() + 1) * sizeof(DWORD);
-
 		for (auto& b : cbuffers)
 		{
-			if (b.info.Size <= rootParamsSizeMax && (!rootBuffer || b.info.Name == "$Globals"))
-				rootBuffer = &b;
-			else if (b.info.Name == "$Globals")
-				__debugbreak();
+			b.frequency = getUpdateFrequency(b.info);
 
 			for (auto& p : b.info.Params)
 			{
@@ -205,12 +197,131 @@ void SignatureInfo::finish()
 					bindlessResources = true;
 			}
 		}
+
+		// space left with all cbuffers as root CBV, chosen buffer gives its descriptor back
+		const UINT rootDwordsFree = RootSignatureUsage::MaxDwords - getRootUsage().dwords() + RootSignatureUsage::RootDescriptorDwords;
+
+		// most frequently updated buffer goes to root constants, $Globals holds material params so it always has to
+		for (auto& b : cbuffers)
+		{
+			const bool fits = b.info.Size / sizeof(DWORD) <= rootDwordsFree;
+
+			if (b.info.Name == "$Globals")
+			{
+				if (!fits)
+					__debugbreak();
+
+				rootBuffer = &b;
+				break;
+			}
+
+			if (fits && (!rootBuffer || b.frequency > rootBuffer->frequency))
+				rootBuffer = &b;
+		}
 	}
 
 	if (bindlessTextures || bindlessResources)
 		flags |= D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED | D3D12_ROOT_SIGNATURE_FLAG_SAMPLER_HEAP_DIRECTLY_INDEXED;
 }
 
+RootSignatureUsage SignatureInfo::getRootUsage() const
+{
+	RootSignatureUsage usage;
+
+	for (auto& b : cbuffers)
+	{
+		if (&b == rootBuffer)
+			usage.constantsDwords += b.info.Size / sizeof(DWORD);
+		else
+			usage.rootDescriptors++;
+	}
+
+	usage.rootDescriptors += UINT(structuredBuffers.size() + rwStructuredBuffers.size());
+	usage.descriptorTables = UINT(textures.size() + uavs.size());
+	usage.staticSamplers = UINT(samplers.size());
+
+	return usage;
+}
+
+static ResourcesInfo::AutoParam GetObjectAutoParam(const std::string& name)
+{
+	if (name == "WorldMatrix")
+		return ResourcesInfo::AutoParam::WORLD_MATRIX;
+	if (name == "InvWorldMatrix")
+		return ResourcesInfo::AutoParam::INV_WORLD_MATRIX;
+	if (name == "PreviousWorldMatrix")
+		return ResourcesInfo::AutoParam::PREV_WORLD_MATRIX;
+	if (name == "WorldPosition")
+		return ResourcesInfo::AutoParam::WORLD_POSITION;
+
+	return ResourcesInfo::AutoParam::None;
+}
+
+static ResourcesInfo::AutoParam GetFrameAutoParam(const std::string& name)
+{
+	if (name == "ViewProjectionMatrix")
+		return ResourcesInfo::AutoParam::VP_MATRIX;
+	if (name == "ViewMatrix")
+		return ResourcesInfo::AutoParam::VIEW_MATRIX;
+	if (name == "WorldViewProjectionMatrix")
+		return ResourcesInfo::AutoParam::WVP_MATRIX;
+	if (name == "ProjectionMatrix")
+		return ResourcesInfo::AutoParam::PROJ_MATRIX;
+	if (name == "InvViewProjectionMatrix")
+		return ResourcesInfo::AutoParam::INV_VP_MATRIX;
+	if (name == "InvViewMatrix")
+		return ResourcesInfo::AutoParam::INV_VIEW_MATRIX;
+	if (name == "InvProjectionMatrix")
+		return ResourcesInfo::AutoParam::INV_PROJ_MATRIX;
+	if (name == "ShadowMapSize")
+		return ResourcesInfo::AutoParam::SHADOW_MAP_SIZE;
+	if (name == "ShadowMapSizeInv")
+		return ResourcesInfo::AutoParam::SHADOW_MAP_SIZE_INV;
+	if (name == "Time")
+		return ResourcesInfo::AutoParam::TIME;
+	if (name == "DeltaTime")
+		return ResourcesInfo::AutoParam::DELTA_TIME;
+	if (name == "FrameIndex")
+		return ResourcesInfo::AutoParam::FRAME_INDEX;
+	if (name == "ViewportSizeInverse")
+		return ResourcesInfo::AutoParam::VIEWPORT_SIZE_INV;
+	if (name == "ViewportSize")
+		return ResourcesInfo::AutoParam::VIEWPORT_SIZE;
+	if (name == "SunDirection")
+		return ResourcesInfo::AutoParam::SUN_DIRECTION;
+	if (name == "SunColor")
+		return ResourcesInfo::AutoParam::SUN_COLOR;
+	if (name == "CameraPosition")
+		return ResourcesInfo::AutoParam::CAMERA_POSITION;
+	if (name == "CameraDirection")
+		return ResourcesInfo::AutoParam::CAMERA_DIRECTION;
+	if (name == "ViewCameraPosition")
+		return ResourcesInfo::AutoParam::VIEW_CAMERA_POSITION;
+	if (name == "ViewCameraDirection")
+		return ResourcesInfo::AutoParam::VIEW_CAMERA_DIRECTION;
+	if (name == "ZMagic")
+		return ResourcesInfo::AutoParam::Z_MAGIC;
+
+	return ResourcesInfo::AutoParam::None;
+}
+
+SignatureInfo::UpdateFrequency SignatureInfo::getUpdateFrequency(const ShaderReflection::CBuffer& buffer)
+{
+	auto frequency = UpdateFrequency::PerFrame;
+
+	for (auto& p : buffer.Params)
+	{
+		// WVP is filled from entity transformation
+		if (GetObjectAutoParam(p.Name) != ResourcesInfo::AutoParam::None || p.Name == "WorldViewProjectionMatrix")
+			return UpdateFrequency::PerObject;
+
+		if (GetFrameAutoParam(p.Name) == ResourcesInfo::AutoParam::None)
+			frequency = UpdateFrequency::PerMaterial;
+	}
+
+	return frequency;
+}
+
 ID3D12RootSignature* SignatureInfo::createRootSignature(ID3D12Device& device, const wchar_t* name, const std::vector<SamplerInfo>& staticSamplers)
 {
 	std::vector<CD3DX12_ROOT_PARAMETER1> params;
@@ -377,11 +488,7 @@ ID3D12RootSignature* SignatureInfo::createRootSignature(ID3D12Device& device, co
 		return nullptr;
 	}
 
-	ID3D12RootSignature* rootSignature{};
-	device.CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
-	rootSignature->SetName(name);
-
-	return rootSignature;
+	return RootSignatureCache::Get().getOrCreate(device, *signature.Get(), name, getRootUsage());
 }
 
 void SignatureInfo::createResourcesData(ResourcesInfo& resources, GraphicsResources& graphicsResources) const
@@ -412,16 +519,7 @@ void SignatureInfo::createResourcesData(ResourcesInfo& resources, GraphicsResour
 					continue;
 				}
 
-				type = ResourcesInfo::AutoParam::None;
-
-				if (p.Name == "WorldMatrix")
-					type = ResourcesInfo::AutoParam::WORLD_MATRIX;
-				else if (p.Name == "InvWorldMatrix")
-					type = ResourcesInfo::AutoParam::INV_WORLD_MATRIX;
-				else if (p.Name == "PreviousWorldMatrix")
-					type = ResourcesInfo::AutoParam::PREV_WORLD_MATRIX;
-				else if (p.Name == "WorldPosition")
-					type = ResourcesInfo::AutoParam::WORLD_POSITION;
+				type = GetObjectAutoParam(p.Name);
 
 				if (type != ResourcesInfo::AutoParam::None)
 				{
@@ -429,50 +527,7 @@ void SignatureInfo::createResourcesData(ResourcesInfo& resources, GraphicsResour
 					continue;
 				}
 
-				type = ResourcesInfo::AutoParam::None;
-
-				if (p.Name == "ViewProjectionMatrix")
-					type = ResourcesInfo::AutoParam::VP_MATRIX;
-				else if (p.Name == "ViewMatrix")
-					type = ResourcesInfo::AutoParam::VIEW_MATRIX;
-				else if (p.Name == "WorldViewProjectionMatrix")
-					type = ResourcesInfo::AutoParam::WVP_MATRIX;
-				else if (p.Name == "ProjectionMatrix")
-					type = ResourcesInfo::AutoParam::PROJ_MATRIX;
-				else if (p.Name == "InvViewProjectionMatrix")
-					type = ResourcesInfo::AutoParam::INV_VP_MATRIX;
-				else if (p.Name == "InvViewMatrix")
-					type = ResourcesInfo::AutoParam::INV_VIEW_MATRIX;
-				else if (p.Name == "InvProjectionMatrix")
-					type = ResourcesInfo::AutoParam::INV_PROJ_MATRIX;
-				else if (p.Name == "ShadowMapSize")
-					type = ResourcesInfo::AutoParam::SHADOW_MAP_SIZE;
-				else if (p.Name == "ShadowMapSizeInv")
-					type = ResourcesInfo::AutoParam::SHADOW_MAP_SIZE_INV;
-				else if (p.Name == "Time")
-					type = ResourcesInfo::AutoParam::TIME;
-				else if (p.Name == "DeltaTime")
-					type = ResourcesInfo::AutoParam::DELTA_TIME;
-				else if (p.Name == "FrameIndex")
-					type = ResourcesInfo::AutoParam::FRAME_INDEX;
-				else if (p.Name == "ViewportSizeInverse")
-					type = ResourcesInfo::AutoParam::VIEWPORT_SIZE_INV;
-				else if (p.Name == "ViewportSize")
-					type = ResourcesInfo::AutoParam::VIEWPORT_SIZE;
-				else if (p.Name == "SunDirection")
-					type = ResourcesInfo::AutoParam::SUN_DIRECTION;
-				else if (p.Name == "SunColor")
-					type = ResourcesInfo::AutoParam::SUN_COLOR;
-				else if (p.Name == "CameraPosition")
-					type = ResourcesInfo::AutoParam::CAMERA_POSITION;
-				else if (p.Name == "CameraDirection")
-					type = ResourcesInfo::AutoParam::CAMERA_DIRECTION;
-				else if (p.Name == "ViewCameraPosition")
-					type = ResourcesInfo::AutoParam::VIEW_CAMERA_POSITION;
-				else if (p.Name == "ViewCameraDirection")
-					type = ResourcesInfo::AutoParam::VIEW_CAMERA_DIRECTION;
-				else if (p.Name == "ZMagic")
-					type = ResourcesInfo::AutoParam::Z_MAGIC;
+				type = GetFrameAutoParam(p.Name);
 
 				if (type != ResourcesInfo::AutoParam::None)
 					resources.frameAutoParams.emplace_back(type, (UINT)(p.StartOffset / sizeof(float)));
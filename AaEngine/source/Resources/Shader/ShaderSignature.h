@@ -2,16 +2,26 @@
 
 #include "Resources/Shader/ShaderCompiler.h"
 #include "Resources/Shader/ShaderResources.h"
+#include "Resources/Shader/RootSignatureCache.h"
 
 struct LoadedShader;
 struct GraphicsResources;
 
 struct SignatureInfo
 {
+	// how often cbuffer contents change, decides between root constants and root CBV
+	enum class UpdateFrequency
+	{
+		PerFrame,
+		PerMaterial,
+		PerObject,
+	};
+
 	struct CBuffer
 	{
 		const ShaderReflection::CBuffer& info;
 		D3D12_SHADER_VISIBILITY visibility = D3D12_SHADER_VISIBILITY(-1);
+		UpdateFrequency frequency = UpdateFrequency::PerFrame;
 	};
 	std::vector<CBuffer> cbuffers;
 
@@ -64,11 +74,16 @@ struct SignatureInfo
 	void setTexturesVolatile();
 	void finish();
 
+	// returns shared signature from RootSignatureCache, caller owns one reference
 	ID3D12RootSignature* createRootSignature(ID3D12Device& device, const wchar_t* name, const std::vector<SamplerInfo>& staticSamplers = {});
 	void createResourcesData(ResourcesInfo& resources, GraphicsResources& graphicsResources) const;
 
+	RootSignatureUsage getRootUsage() const;
+
 private:
 
+	static UpdateFrequency getUpdateFrequency(const ShaderReflection::CBuffer& buffer);
+
 	D3D12_SHADER_VISIBILITY getVisibility(ShaderType t);
 	void addVisibility(D3D12_SHADER_VISIBILITY& v, ShaderType t);
 };
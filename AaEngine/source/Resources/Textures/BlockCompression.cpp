@@ -0,0 +1,471 @@
+#include "Resources/Textures/BlockCompression.h"
+#include "Utils/ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cfloat>
+#include <climits>
+
+namespace
+{
+	struct Block
+	{
+		uint8_t pixels[16][4];
+	};
+
+	void ReadBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, Block& block)
+	{
+		for (uint32_t y = 0; y < 4; y++)
+		{
+			const uint32_t py = std::min(by * 4 + y, height - 1);
+
+			for (uint32_t x = 0; x < 4; x++)
+			{
+				const uint32_t px = std::min(bx * 4 + x, width - 1);
+				memcpy(block.pixels[y * 4 + x], rgba + (size_t(py) * width + px) * 4, 4);
+			}
+		}
+	}
+
+	// endpoints are extremes of block pixels projected on their principal axis
+	void FindEndpoints(const Block& block, int channels, float e0[4], float e1[4])
+	{
+		float mean[4]{};
+		for (auto& p : block.pixels)
+			for (int c = 0; c < channels; c++)
+				mean[c] += p[c] / 16.f;
+
+		float covariance[4][4]{};
+		for (auto& p : block.pixels)
+		{
+			for (int i = 0; i < channels; i++)
+				for (int j = 0; j < channels; j++)
+					covariance[i][j] += (p[i] - mean[i]) * (p[j] - mean[j]);
+		}
+
+		// power iteration, starting from channel with largest variance
+		int start = 0;
+		for (int c = 1; c < channels; c++)
+			if (covariance[c][c] > covariance[start][start])
+				start = c;
+
+		float axis[4]{};
+		for (int c = 0; c < channels; c++)
+			axis[c] = covariance[start][c];
+
+		for (int iteration = 0; iteration < 8; iteration++)
+		{
+			float next[4]{};
+			float maxValue = 0;
+			for (int i = 0; i < channels; i++)
+			{
+				for (int j = 0; j < channels; j++)
+					next[i] += covariance[i][j] * axis[j];
+
+				maxValue = std::max(maxValue, std::abs(next[i]));
+			}
+
+			if (maxValue == 0)
+				break;
+
+			for (int c = 0; c < channels; c++)
+				axis[c] = next[c] / maxValue;
+		}
+
+		float length = 0;
+		for (int c = 0; c < channels; c++)
+			length += axis[c] * axis[c];
+		length = std::sqrt(length);
+
+		float tMin = 0, tMax = 0;
+		if (length > 0)
+		{
+			for (int c = 0; c < channels; c++)
+				axis[c] /= length;
+
+			tMin = FLT_MAX;
+			tMax = -FLT_MAX;
+			for (auto& p : block.pixels)
+			{
+				float t = 0;
+				for (int c = 0; c < channels; c++)
+					t += (p[c] - mean[c]) * axis[c];
+
+				tMin = std::min(tMin, t);
+				tMax = std::max(tMax, t);
+			}
+		}
+
+		for (int c = 0; c < channels; c++)
+		{
+			e0[c] = std::clamp(mean[c] + axis[c] * tMin, 0.f, 255.f);
+			e1[c] = std::clamp(mean[c] + axis[c] * tMax, 0.f, 255.f);
+		}
+	}
+
+	uint16_t To565(const float c[3])
+	{
+		const auto r = uint16_t(c[0] * 31 / 255 + 0.5f);
+		const auto g = uint16_t(c[1] * 63 / 255 + 0.5f);
+		const auto b = uint16_t(c[2] * 31 / 255 + 0.5f);
+
+		return uint16_t((r << 11) | (g << 5) | b);
+	}
+
+	void From565(uint16_t v, int out[3])
+	{
+		const int r = (v >> 11) & 31;
+		const int g = (v >> 5) & 63;
+		const int b = v & 31;
+
+		out[0] = (r << 3) | (r >> 2);
+		out[1] = (g << 2) | (g >> 4);
+		out[2] = (b << 3) | (b >> 2);
+	}
+
+	void EncodeBC1(const Block& block, uint8_t* out)
+	{
+		float e0[4], e1[4];
+		FindEndpoints(block, 3, e0, e1);
+
+		// 4 color mode needs first endpoint larger
+		uint16_t c0 = To565(e1);
+		uint16_t c1 = To565(e0);
+		if (c0 < c1)
+			std::swap(c0, c1);
+
+		uint32_t indices = 0;
+		if (c0 != c1)
+		{
+			int palette[4][3];
+			From565(c0, palette[0]);
+			From565(c1, palette[1]);
+			for (int c = 0; c < 3; c++)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				uint32_t best = 0;
+				int bestError = INT_MAX;
+				for (uint32_t p = 0; p < 4; p++)
+				{
+					int error = 0;
+					for (int c = 0; c < 3; c++)
+						error += (palette[p][c] - block.pixels[i][c]) * (palette[p][c] - block.pixels[i][c]);
+
+					if (error < bestError)
+					{
+						bestError = error;
+						best = p;
+					}
+				}
+
+				indices |= best << (i * 2);
+			}
+		}
+
+		memcpy(out, &c0, 2);
+		memcpy(out + 2, &c1, 2);
+		memcpy(out + 4, &indices, 4);
+	}
+
+	void EncodeBC4(const Block& block, int channel, uint8_t* out)
+	{
+		uint8_t low = 255, high = 0;
+		for (auto& p : block.pixels)
+		{
+			low = std::min(low, p[channel]);
+			high = std::max(high, p[channel]);
+		}
+
+		// 8 value mode, endpoints first and 6 interpolated
+		int palette[8] = { high, low };
+		for (int i = 1; i < 7; i++)
+			palette[i + 1] = ((7 - i) * high + i * low + 3) / 7;
+
+		uint64_t indices = 0;
+		if (high != low)
+		{
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				uint64_t best = 0;
+				int bestError = INT_MAX;
+				for (uint32_t p = 0; p < 8; p++)
+				{
+					const int error = std::abs(palette[p] - block.pixels[i][channel]);
+					if (error < bestError)
+					{
+						bestError = error;
+						best = p;
+					}
+				}
+
+				indices |= best << (i * 3);
+			}
+		}
+
+		out[0] = high;
+		out[1] = low;
+		memcpy(out + 2, &indices, 6);
+	}
+
+	struct BitWriter
+	{
+		uint8_t* out;
+		uint32_t position = 0;
+
+		void write(uint32_t value, uint32_t bits)
+		{
+			for (uint32_t b = 0; b < bits; b++, position++)
+			{
+				if ((value >> b) & 1)
+					out[position / 8] |= uint8_t(1 << (position % 8));
+			}
+		}
+	};
+
+	const int Bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// 7 bit channels with shared lowest bit
+	void QuantizeEndpoint(const float e[4], uint8_t q[4], uint8_t& pbit)
+	{
+		float bestError = FLT_MAX;
+
+		for (uint8_t p = 0; p < 2; p++)
+		{
+			uint8_t candidate[4];
+			float error = 0;
+			for (int c = 0; c < 4; c++)
+			{
+				candidate[c] = (uint8_t)std::clamp(int((e[c] - p) / 2 + 0.5f), 0, 127);
+				const float d = float((candidate[c] << 1) | p) - e[c];
+				error += d * d;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				pbit = p;
+				memcpy(q, candidate, 4);
+			}
+		}
+	}
+
+	void SelectBC7Indices(const Block& block, const uint8_t q[2][4], const uint8_t p[2], uint8_t indices[16])
+	{
+		int endpoints[2][4];
+		for (int c = 0; c < 4; c++)
+		{
+			endpoints[0][c] = (q[0][c] << 1) | p[0];
+			endpoints[1][c] = (q[1][c] << 1) | p[1];
+		}
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			uint8_t best = 0;
+			int bestError = INT_MAX;
+			for (uint8_t w = 0; w < 16; w++)
+			{
+				int error = 0;
+				for (int c = 0; c < 4; c++)
+				{
+					const int value = ((64 - Bc7Weights4[w]) * endpoints[0][c] + Bc7Weights4[w] * endpoints[1][c] + 32) >> 6;
+					error += (value - block.pixels[i][c]) * (value - block.pixels[i][c]);
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					best = w;
+				}
+			}
+
+			indices[i] = best;
+		}
+	}
+
+	// least squares endpoints for selected indices, false when indices do not span a line
+	bool RefineEndpoints(const Block& block, const uint8_t indices[16], float e0[4], float e1[4])
+	{
+		float aa = 0, ab = 0, bb = 0;
+		float ax[4]{}, bx[4]{};
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			const float w = Bc7Weights4[indices[i]] / 64.f;
+			aa += (1 - w) * (1 - w);
+			ab += (1 - w) * w;
+			bb += w * w;
+
+			for (int c = 0; c < 4; c++)
+			{
+				ax[c] += (1 - w) * block.pixels[i][c];
+				bx[c] += w * block.pixels[i][c];
+			}
+		}
+
+		const float determinant = aa * bb - ab * ab;
+		if (std::abs(determinant) < 1e-6f)
+			return false;
+
+		for (int c = 0; c < 4; c++)
+		{
+			e0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.f, 255.f);
+			e1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.f, 255.f);
+		}
+
+		return true;
+	}
+
+	// mode 6, single subset with RGBA endpoints and 4 bit indices
+	void EncodeBC7(const Block& block, uint8_t* out)
+	{
+		float e0[4], e1[4];
+		FindEndpoints(block, 4, e0, e1);
+
+		uint8_t q[2][4];
+		uint8_t p[2];
+		QuantizeEndpoint(e0, q[0], p[0]);
+		QuantizeEndpoint(e1, q[1], p[1]);
+
+		uint8_t indices[16];
+		SelectBC7Indices(block, q, p, indices);
+
+		if (RefineEndpoints(block, indices, e0, e1))
+		{
+			QuantizeEndpoint(e0, q[0], p[0]);
+			QuantizeEndpoint(e1, q[1], p[1]);
+			SelectBC7Indices(block, q, p, indices);
+		}
+
+		// highest bit of first index is implicit zero
+		if (indices[0] & 8)
+		{
+			std::swap(q[0], q[1]);
+			std::swap(p[0], p[1]);
+			for (auto& i : indices)
+				i = 15 - i;
+		}
+
+		memset(out, 0, 16);
+		BitWriter writer{ out };
+		writer.write(1 << 6, 7);
+
+		for (int c = 0; c < 4; c++)
+		{
+			writer.write(q[0][c], 7);
+			writer.write(q[1][c], 7);
+		}
+
+		writer.write(p[0], 1);
+		writer.write(p[1], 1);
+
+		writer.write(indices[0], 3);
+		for (uint32_t i = 1; i < 16; i++)
+			writer.write(indices[i], 4);
+	}
+}
+
+BlockCompression::Format BlockCompression::ParseFormat(const std::string& name)
+{
+	if (name == "compress")
+		return Format::Auto;
+	if (name == "bc1")
+		return Format::BC1;
+	if (name == "bc4")
+		return Format::BC4;
+	if (name == "bc5")
+		return Format::BC5;
+	if (name == "bc7")
+		return Format::BC7;
+
+	return Format::None;
+}
+
+const char* BlockCompression::GetFormatName(Format format)
+{
+	switch (format)
+	{
+	case Format::BC1: return "BC1";
+	case Format::BC4: return "BC4";
+	case Format::BC5: return "BC5";
+	case Format::BC7: return "BC7";
+	case Format::Auto: return "Auto";
+	}
+
+	return "None";
+}
+
+DXGI_FORMAT BlockCompression::GetDxgiFormat(Format format)
+{
+	switch (format)
+	{
+	case Format::BC1: return DXGI_FORMAT_BC1_UNORM;
+	case Format::BC4: return DXGI_FORMAT_BC4_UNORM;
+	case Format::BC5: return DXGI_FORMAT_BC5_UNORM;
+	case Format::BC7: return DXGI_FORMAT_BC7_UNORM;
+	}
+
+	return DXGI_FORMAT_UNKNOWN;
+}
+
+BlockCompression::Format BlockCompression::SelectFormat(const uint8_t* rgba, uint32_t width, uint32_t height)
+{
+	bool alpha = false;
+	bool grayscale = true;
+
+	for (size_t i = 0; i < size_t(width) * height; i++, rgba += 4)
+	{
+		alpha |= rgba[3] != 255;
+		grayscale &= rgba[0] == rgba[1] && rgba[0] == rgba[2];
+	}
+
+	if (alpha)
+		return Format::BC7;
+
+	return grayscale ? Format::BC4 : Format::BC1;
+}
+
+std::vector<uint8_t> BlockCompression::Compress(const uint8_t* rgba, uint32_t width, uint32_t height, Format format)
+{
+	const uint32_t blocksX = (width + 3) / 4;
+	const uint32_t blocksY = (height + 3) / 4;
+	const size_t blockSize = (format == Format::BC1 || format == Format::BC4) ? 8 : 16;
+
+	std::vector<uint8_t> output(size_t(blocksX) * blocksY * blockSize);
+
+	ParallelFor(blocksY, [&](size_t by)
+		{
+			Block block;
+			uint8_t* out = output.data() + by * blocksX * blockSize;
+
+			for (uint32_t bx = 0; bx < blocksX; bx++, out += blockSize)
+			{
+				ReadBlock(rgba, width, height, bx, (uint32_t)by, block);
+
+				switch (format)
+				{
+				case Format::BC1:
+					EncodeBC1(block, out);
+					break;
+				case Format::BC4:
+					EncodeBC4(block, 0, out);
+					break;
+				case Format::BC5:
+					EncodeBC4(block, 0, out);
+					EncodeBC4(block, 1, out + 8);
+					break;
+				case Format::BC7:
+					EncodeBC7(block, out);
+					break;
+				default:
+					break;
+				}
+			}
+		});
+
+	return output;
+}
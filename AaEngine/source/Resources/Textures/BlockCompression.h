@@ -0,0 +1,30 @@
+#pragma once
+
+#include <d3d12.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// CPU encoders of BC formats, blocks are compressed in parallel
+namespace BlockCompression
+{
+	enum class Format
+	{
+		None,
+		Auto,	// BC4 for grayscale, BC7 with alpha, BC1 otherwise
+		BC1,
+		BC4,
+		BC5,
+		BC7,
+	};
+
+	Format ParseFormat(const std::string& name);
+	const char* GetFormatName(Format format);
+	DXGI_FORMAT GetDxgiFormat(Format format);
+
+	// picks format for Auto based on image content
+	Format SelectFormat(const uint8_t* rgba, uint32_t width, uint32_t height);
+
+	// rgba8 pixels to blocks, edges are clamped when size is not multiple of 4
+	std::vector<uint8_t> Compress(const uint8_t* rgba, uint32_t width, uint32_t height, Format format);
+}
@@ -0,0 +1,303 @@
+#include "Resources/Textures/DdsFile.h"
+#include <fstream>
+#include <algorithm>
+#include <bit>
+
+namespace
+{
+	constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+	{
+		return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) | (uint32_t(uint8_t(c)) << 16) | (uint32_t(uint8_t(d)) << 24);
+	}
+
+	constexpr uint32_t DdsMagic = MakeFourCC('D', 'D', 'S', ' ');
+
+	constexpr uint32_t DDSD_CAPS = 0x1;
+	constexpr uint32_t DDSD_HEIGHT = 0x2;
+	constexpr uint32_t DDSD_WIDTH = 0x4;
+	constexpr uint32_t DDSD_PIXELFORMAT = 0x1000;
+	constexpr uint32_t DDSD_LINEARSIZE = 0x80000;
+	constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+	constexpr uint32_t DDSD_DEPTH = 0x800000;
+	constexpr uint32_t DDPF_FOURCC = 0x4;
+	constexpr uint32_t DDPF_RGB = 0x40;
+	constexpr uint32_t DDSCAPS_COMPLEX = 0x8;
+	constexpr uint32_t DDSCAPS_TEXTURE = 0x1000;
+	constexpr uint32_t DDSCAPS_MIPMAP = 0x400000;
+	constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+	constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+	constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+#pragma pack(push, 1)
+	struct DdsPixelFormat
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t fourCC;
+		uint32_t RGBBitCount;
+		uint32_t RBitMask;
+		uint32_t GBitMask;
+		uint32_t BBitMask;
+		uint32_t ABitMask;
+	};
+
+	struct DdsHeader
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t height;
+		uint32_t width;
+		uint32_t pitchOrLinearSize;
+		uint32_t depth;
+		uint32_t mipMapCount;
+		uint32_t reserved1[11];
+		DdsPixelFormat ddspf;
+		uint32_t caps;
+		uint32_t caps2;
+		uint32_t caps3;
+		uint32_t caps4;
+		uint32_t reserved2;
+	};
+
+	struct DdsHeaderDxt10
+	{
+		uint32_t dxgiFormat;
+		uint32_t resourceDimension;
+		uint32_t miscFlag;
+		uint32_t arraySize;
+		uint32_t miscFlags2;
+	};
+#pragma pack(pop)
+
+	DXGI_FORMAT GetLegacyFormat(const DdsPixelFormat& pf)
+	{
+		if (pf.flags & DDPF_FOURCC)
+		{
+			switch (pf.fourCC)
+			{
+			case MakeFourCC('D', 'X', 'T', '1'): return DXGI_FORMAT_BC1_UNORM;
+			case MakeFourCC('D', 'X', 'T', '2'):
+			case MakeFourCC('D', 'X', 'T', '3'): return DXGI_FORMAT_BC2_UNORM;
+			case MakeFourCC('D', 'X', 'T', '4'):
+			case MakeFourCC('D', 'X', 'T', '5'): return DXGI_FORMAT_BC3_UNORM;
+			case MakeFourCC('A', 'T', 'I', '1'):
+			case MakeFourCC('B', 'C', '4', 'U'): return DXGI_FORMAT_BC4_UNORM;
+			case MakeFourCC('B', 'C', '4', 'S'): return DXGI_FORMAT_BC4_SNORM;
+			case MakeFourCC('A', 'T', 'I', '2'):
+			case MakeFourCC('B', 'C', '5', 'U'): return DXGI_FORMAT_BC5_UNORM;
+			case MakeFourCC('B', 'C', '5', 'S'): return DXGI_FORMAT_BC5_SNORM;
+			}
+		}
+		else if ((pf.flags & DDPF_RGB) && pf.RGBBitCount == 32)
+		{
+			if (pf.RBitMask == 0xff && pf.GBitMask == 0xff00 && pf.BBitMask == 0xff0000 && pf.ABitMask == 0xff000000)
+				return DXGI_FORMAT_R8G8B8A8_UNORM;
+			if (pf.RBitMask == 0xff0000 && pf.GBitMask == 0xff00 && pf.BBitMask == 0xff && pf.ABitMask == 0xff000000)
+				return DXGI_FORMAT_B8G8R8A8_UNORM;
+		}
+
+		return DXGI_FORMAT_UNKNOWN;
+	}
+
+	// bytes per 4x4 block for compressed, per pixel otherwise, 0 when not supported
+	UINT GetFormatBytes(DXGI_FORMAT format, bool& blockCompressed)
+	{
+		blockCompressed = true;
+
+		switch (format)
+		{
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_UNORM:
+		case DXGI_FORMAT_BC4_SNORM:
+			return 8;
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB:
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+		case DXGI_FORMAT_BC5_UNORM:
+		case DXGI_FORMAT_BC5_SNORM:
+		case DXGI_FORMAT_BC6H_UF16:
+		case DXGI_FORMAT_BC6H_SF16:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			return 16;
+		}
+
+		blockCompressed = false;
+
+		switch (format)
+		{
+		case DXGI_FORMAT_R8_UNORM:
+			return 1;
+		case DXGI_FORMAT_R8G8_UNORM:
+		case DXGI_FORMAT_R16_FLOAT:
+		case DXGI_FORMAT_R16_UNORM:
+			return 2;
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+		case DXGI_FORMAT_B8G8R8A8_UNORM:
+		case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+		case DXGI_FORMAT_R32_FLOAT:
+		case DXGI_FORMAT_R16G16_FLOAT:
+			return 4;
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+			return 8;
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+			return 16;
+		}
+
+		return 0;
+	}
+
+	DXGI_FORMAT MakeSrgb(DXGI_FORMAT format)
+	{
+		switch (format)
+		{
+		case DXGI_FORMAT_BC1_UNORM: return DXGI_FORMAT_BC1_UNORM_SRGB;
+		case DXGI_FORMAT_BC2_UNORM: return DXGI_FORMAT_BC2_UNORM_SRGB;
+		case DXGI_FORMAT_BC3_UNORM: return DXGI_FORMAT_BC3_UNORM_SRGB;
+		case DXGI_FORMAT_BC7_UNORM: return DXGI_FORMAT_BC7_UNORM_SRGB;
+		case DXGI_FORMAT_R8G8B8A8_UNORM: return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+		case DXGI_FORMAT_B8G8R8A8_UNORM: return DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+		}
+
+		return format;
+	}
+}
+
+bool DdsFile::open(const std::string& filepath, bool forceSrgb)
+{
+	path = filepath;
+	mips.clear();
+
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+		return false;
+
+	const uint64_t fileSize = file.tellg();
+	file.seekg(0);
+
+	uint32_t magic{};
+	DdsHeader header{};
+	if (!file.read((char*)&magic, sizeof(magic)) || !file.read((char*)&header, sizeof(header)))
+		return false;
+
+	if (magic != DdsMagic || header.size != sizeof(DdsHeader) || header.ddspf.size != sizeof(DdsPixelFormat))
+		return false;
+
+	if ((header.caps2 & DDSCAPS2_CUBEMAP) || ((header.flags & DDSD_DEPTH) && header.depth > 1))
+		return false;
+
+	uint64_t offset = sizeof(magic) + sizeof(header);
+
+	if ((header.ddspf.flags & DDPF_FOURCC) && header.ddspf.fourCC == MakeFourCC('D', 'X', '1', '0'))
+	{
+		DdsHeaderDxt10 dxt10{};
+		if (!file.read((char*)&dxt10, sizeof(dxt10)))
+			return false;
+
+		if (dxt10.resourceDimension != DDS_DIMENSION_TEXTURE2D || dxt10.arraySize != 1 || (dxt10.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE))
+			return false;
+
+		format = (DXGI_FORMAT)dxt10.dxgiFormat;
+		offset += sizeof(dxt10);
+	}
+	else
+		format = GetLegacyFormat(header.ddspf);
+
+	const UINT formatBytes = GetFormatBytes(format, blockCompressed);
+	if (!formatBytes || !header.width || !header.height)
+		return false;
+
+	if (forceSrgb)
+		format = MakeSrgb(format);
+
+	// header count is not trusted, chain ends with 1x1 mip
+	const UINT maxMipCount = std::bit_width(std::max(header.width, header.height));
+	const UINT mipCount = (header.flags & DDSD_MIPMAPCOUNT) ? std::clamp(header.mipMapCount, 1u, maxMipCount) : 1;
+
+	for (UINT i = 0; i < mipCount; i++)
+	{
+		Mip mip;
+		mip.width = std::max(header.width >> i, 1u);
+		mip.height = std::max(header.height >> i, 1u);
+
+		if (blockCompressed)
+		{
+			mip.rowPitch = std::max((mip.width + 3) / 4, 1u) * formatBytes;
+			mip.rows = std::max((mip.height + 3) / 4, 1u);
+		}
+		else
+		{
+			mip.rowPitch = mip.width * formatBytes;
+			mip.rows = mip.height;
+		}
+
+		mip.offset = offset;
+		mip.size = size_t(mip.rowPitch) * mip.rows;
+		offset += mip.size;
+
+		mips.push_back(mip);
+	}
+
+	return offset <= fileSize;
+}
+
+bool DdsFile::readMips(UINT firstMip, std::vector<uint8_t>& data) const
+{
+	if (firstMip >= mips.size())
+		return false;
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+
+	// mips are stored continuously, so the range is one read
+	data.resize(getMipsSize(firstMip));
+	file.seekg(mips[firstMip].offset);
+
+	return bool(file.read((char*)data.data(), data.size()));
+}
+
+size_t DdsFile::getMipsSize(UINT firstMip) const
+{
+	size_t size = 0;
+	for (size_t i = firstMip; i < mips.size(); i++)
+		size += mips[i].size;
+
+	return size;
+}
+
+bool DdsFile::save(const std::string& path, DXGI_FORMAT format, UINT width, UINT height, const std::vector<std::vector<uint8_t>>& mips)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+
+	DdsHeader header{};
+	header.size = sizeof(DdsHeader);
+	header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+	header.height = height;
+	header.width = width;
+	header.pitchOrLinearSize = mips.empty() ? 0 : (uint32_t)mips.front().size();
+	header.mipMapCount = (uint32_t)mips.size();
+	header.ddspf.size = sizeof(DdsPixelFormat);
+	header.ddspf.flags = DDPF_FOURCC;
+	header.ddspf.fourCC = MakeFourCC('D', 'X', '1', '0');
+	header.caps = DDSCAPS_TEXTURE | (mips.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+	DdsHeaderDxt10 dxt10{};
+	dxt10.dxgiFormat = format;
+	dxt10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+	dxt10.arraySize = 1;
+
+	file.write((const char*)&DdsMagic, sizeof(DdsMagic));
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)&dxt10, sizeof(dxt10));
+
+	for (auto& mip : mips)
+		file.write((const char*)mip.data(), mip.size());
+
+	return bool(file);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <d3d12.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// DDS header parsing with direct reads of mip ranges, limited to single 2D textures
+class DdsFile
+{
+public:
+
+	struct Mip
+	{
+		uint64_t offset{};
+		size_t size{};
+		UINT width{};
+		UINT height{};
+		UINT rowPitch{};
+		UINT rows{};
+	};
+
+	// false when file is not a plain 2D texture in supported format
+	bool open(const std::string& path, bool forceSrgb);
+
+	// reads mips from firstMip to last into one buffer, in file order
+	bool readMips(UINT firstMip, std::vector<uint8_t>& data) const;
+	size_t getMipsSize(UINT firstMip) const;
+
+	// writes 2D texture with DX10 header, mips data are tightly packed
+	static bool save(const std::string& path, DXGI_FORMAT format, UINT width, UINT height, const std::vector<std::vector<uint8_t>>& mips);
+
+	std::string path;
+	DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+	bool blockCompressed{};
+	std::vector<Mip> mips;
+};
@@ -0,0 +1,144 @@
+#include "Resources/Textures/TextureImport.h"
+#include "Resources/Textures/DdsFile.h"
+#include "App/Directories.h"
+#include "Utils/MappedFile.h"
+#include "Utils/StringUtils.h"
+#include "Utils/Logger.h"
+#include "Utils/Directx.h"
+#include <wincodec.h>
+#include <filesystem>
+#include <format>
+#include <chrono>
+
+const std::string TEXTURE_CACHE_DIRECTORY = TEXTURE_DIRECTORY + "cache/";
+
+// change when encoder output changes to invalidate cached files
+constexpr uint64_t EncoderVersion = 1;
+
+static uint64_t HashData(std::span<const uint8_t> data, uint64_t hash)
+{
+	// FNV-1a
+	for (auto b : data)
+	{
+		hash ^= b;
+		hash *= 0x100000001b3ull;
+	}
+
+	return hash;
+}
+
+static bool DecodeImage(const std::string& file, std::vector<uint8_t>& rgba, UINT& width, UINT& height)
+{
+	ComPtr<IWICImagingFactory> factory;
+	if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory))))
+		return false;
+
+	ComPtr<IWICBitmapDecoder> decoder;
+	if (FAILED(factory->CreateDecoderFromFilename(as_wstring(file).c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder)))
+		return false;
+
+	ComPtr<IWICBitmapFrameDecode> frame;
+	if (FAILED(decoder->GetFrame(0, &frame)) || FAILED(frame->GetSize(&width, &height)))
+		return false;
+
+	ComPtr<IWICFormatConverter> converter;
+	if (FAILED(factory->CreateFormatConverter(&converter)) ||
+		FAILED(converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0, WICBitmapPaletteTypeCustom)))
+		return false;
+
+	rgba.resize(size_t(width) * height * 4);
+	return SUCCEEDED(converter->CopyPixels(nullptr, width * 4, (UINT)rgba.size(), rgba.data()));
+}
+
+// 2x2 box filter, odd edges are clamped
+static std::vector<uint8_t> Downsample(const std::vector<uint8_t>& rgba, UINT width, UINT height)
+{
+	const UINT mipWidth = std::max(width / 2, 1u);
+	const UINT mipHeight = std::max(height / 2, 1u);
+	std::vector<uint8_t> mip(size_t(mipWidth) * mipHeight * 4);
+
+	for (UINT y = 0; y < mipHeight; y++)
+	{
+		const UINT y0 = std::min(y * 2, height - 1);
+		const UINT y1 = std::min(y * 2 + 1, height - 1);
+
+		for (UINT x = 0; x < mipWidth; x++)
+		{
+			const UINT x0 = std::min(x * 2, width - 1);
+			const UINT x1 = std::min(x * 2 + 1, width - 1);
+
+			for (UINT c = 0; c < 4; c++)
+			{
+				const UINT sum = rgba[(size_t(y0) * width + x0) * 4 + c] + rgba[(size_t(y0) * width + x1) * 4 + c]
+					+ rgba[(size_t(y1) * width + x0) * 4 + c] + rgba[(size_t(y1) * width + x1) * 4 + c];
+
+				mip[(size_t(y) * mipWidth + x) * 4 + c] = uint8_t((sum + 2) / 4);
+			}
+		}
+	}
+
+	return mip;
+}
+
+std::string TextureImport::GetCompressedFile(const std::string& file, BlockCompression::Format format)
+{
+	MappedFile source;
+	if (!source.open(file))
+		return {};
+
+	uint64_t hash = HashData(source.data(), 0xcbf29ce484222325ull);
+	const uint64_t key[] = { (uint64_t)format, EncoderVersion };
+	hash = HashData({ (const uint8_t*)key, sizeof(key) }, hash);
+	source.close();
+
+	const auto cachedFile = std::format("{}{}_{:016x}.dds", TEXTURE_CACHE_DIRECTORY, std::filesystem::path(file).stem().string(), hash);
+	if (std::filesystem::exists(cachedFile))
+		return cachedFile;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	std::vector<uint8_t> rgba;
+	UINT width{}, height{};
+	if (!DecodeImage(file, rgba, width, height))
+	{
+		Logger::logWarning("Failed to decode texture for compression " + file);
+		return {};
+	}
+
+	// top mip has to be made of whole blocks
+	if (width % 4 || height % 4)
+	{
+		Logger::logWarning(std::format("Texture {} size {}x{} is not multiple of 4, skipping compression", file, width, height));
+		return {};
+	}
+
+	if (format == BlockCompression::Format::Auto)
+		format = BlockCompression::SelectFormat(rgba.data(), width, height);
+
+	std::vector<std::vector<uint8_t>> mips;
+	UINT mipWidth = width, mipHeight = height;
+
+	while (true)
+	{
+		mips.push_back(BlockCompression::Compress(rgba.data(), mipWidth, mipHeight, format));
+
+		if (mipWidth == 1 && mipHeight == 1)
+			break;
+
+		rgba = Downsample(rgba, mipWidth, mipHeight);
+		mipWidth = std::max(mipWidth / 2, 1u);
+		mipHeight = std::max(mipHeight / 2, 1u);
+	}
+
+	std::filesystem::create_directories(TEXTURE_CACHE_DIRECTORY);
+	if (!DdsFile::save(cachedFile, BlockCompression::GetDxgiFormat(format), width, height, mips))
+	{
+		Logger::logWarning("Failed to write compressed texture " + cachedFile);
+		return {};
+	}
+
+	const auto duration = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	Logger::log(std::format("Compressed texture {} to {} ({}x{}, {} mips) in {:.1f} ms", file, BlockCompression::GetFormatName(format), width, height, mips.size(), duration));
+
+	return cachedFile;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Resources/Textures/BlockCompression.h"
+#include <string>
+
+// Converts image files to block compressed DDS, results are cached on disk by content hash
+namespace TextureImport
+{
+	// path of cached DDS with full mip chain, empty when image could not be compressed
+	std::string GetCompressedFile(const std::string& file, BlockCompression::Format format);
+}
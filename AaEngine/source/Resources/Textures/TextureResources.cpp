@@ -1,4 +1,6 @@
 #include "Resources/Textures/TextureResources.h"
+#include "Resources/Textures/TextureStreaming.h"
+#include "Resources/Textures/TextureImport.h"
 #include <WICTextureLoader.h>
 #include <DDSTextureLoader.h>
 #include "Utils/Logger.h"
@@ -69,10 +71,28 @@ FileTexture* TextureResources::loadFile(ID3D12Device& device, ResourceUploadBatc
 
 	auto& t = loadedTextures[file];
 
+	std::string loadPath = file;
+	if (!t && options.compression != BlockCompression::Format::None && !file.ends_with("dds"))
+	{
+		auto compressed = TextureImport::GetCompressedFile(file, options.compression);
+		if (!compressed.empty())
+			loadPath = compressed;
+	}
+
+	if (!t && streaming && options.streaming && loadPath.ends_with("dds"))
+	{
+		auto streamed = std::make_unique<FileTexture>();
+		if (streaming->load(*streamed, resourceUpload, loadPath, options.forceSrgb))
+		{
+			t = std::move(streamed);
+			t->SetName(file);
+		}
+	}
+
 	if (!t)
 	{
 		ID3D12Resource* resultTex = nullptr;
-		if (LoadTextureFromFile(resourceUpload, device, file, &resultTex, options) == S_OK && resultTex)
+		if (LoadTextureFromFile(resourceUpload, device, loadPath, &resultTex, options) == S_OK && resultTex)
 		{
 			t = std::make_unique<FileTexture>();
 			t->texture = resultTex;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Resources/ResourcesView.h"
+#include "Resources/Textures/BlockCompression.h"
 #include <string>
 #include <map>
 #include <memory>
@@ -23,8 +24,14 @@ public:
 struct TextureFileLoadOptions
 {
 	bool forceSrgb = false;
+	// DDS with enough mips is loaded with mip tail only and streamed by usage
+	bool streaming = false;
+	// non DDS images are block compressed on first load and cached
+	BlockCompression::Format compression = BlockCompression::Format::None;
 };
 
+class TextureStreaming;
+
 class TextureResources
 {
 public:
@@ -41,6 +48,8 @@ public:
 	void setNamedUAV(std::string name, const ShaderTextureViewUAV& texture);
 	ShaderTextureViewUAV* getNamedUAV(std::string name);
 
+	TextureStreaming* streaming{};
+
 private:
 
 	std::map<std::string, std::unique_ptr<FileTexture>> loadedTextures;
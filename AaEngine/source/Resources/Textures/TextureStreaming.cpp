@@ -0,0 +1,366 @@
+#include "Resources/Textures/TextureStreaming.h"
+#include "Utils/CpuProfiler.h"
+#include "Utils/RenderStats.h"
+#include "Resources/Textures/TextureResources.h"
+#include "Resources/Model/VertexBufferModelGarbageCollector.h"
+#include "Resources/DescriptorManager.h"
+#include "RenderCore/RenderSystem.h"
+#include "Scene/RenderWorld.h"
+#include "Scene/Camera.h"
+#include "Scene/RenderEntity.h"
+#include "Resources/Material/Material.h"
+#include "Utils/StringUtils.h"
+#include "Utils/Logger.h"
+#include "Utils/JobSystem.h"
+#include "ResourceUploadBatch.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cfloat>
+
+using namespace DirectX;
+
+static TextureStreaming* instance = nullptr;
+
+// textures without any feedback after this are likely used outside of render world entities
+constexpr uint64_t FeedbackGraceFrames = 120;
+// recently used textures are not evicted
+constexpr uint64_t EvictAfterFrames = 60;
+// texture coordinates usually repeat over surface, ask for one mip more detail
+constexpr UINT MipBias = 1;
+
+TextureStreaming::TextureStreaming(RenderSystem& rs) : device(*rs.core.device), commandQueue(rs.core.commandQueue)
+{
+	if (instance)
+		throw std::exception("Duplicate TextureStreaming");
+
+	instance = this;
+
+	uploadBatch = std::make_unique<ResourceUploadBatch>(rs.core.device);
+}
+
+TextureStreaming::~TextureStreaming()
+{
+	for (auto& job : readJobs)
+		JobSystem::GetIo().wait(job);
+
+	if (uploadFinished.valid())
+		uploadFinished.wait();
+
+	instance = nullptr;
+}
+
+TextureStreaming& TextureStreaming::Get()
+{
+	return *instance;
+}
+
+bool TextureStreaming::load(FileTexture& texture, ResourceUploadBatch& batch, const std::string& path, bool forceSrgb)
+{
+	auto streamed = std::make_unique<StreamedTexture>();
+	auto& file = streamed->file;
+
+	if (!file.open(path, forceSrgb))
+		return false;
+
+	UINT tail = 0;
+	while (tail + 1 < file.mips.size() && std::max(file.mips[tail].width, file.mips[tail].height) > TailSize)
+		tail++;
+
+	// small enough to be loaded whole
+	if (tail == 0)
+		return false;
+
+	// top mip of block compressed texture has to be made of whole blocks
+	if (file.blockCompressed)
+	{
+		for (UINT i = 0; i <= tail; i++)
+			if (file.mips[i].width % 4 || file.mips[i].height % 4)
+				return false;
+	}
+
+	std::vector<uint8_t> data;
+	if (!file.readMips(tail, data))
+		return false;
+
+	auto resource = createTexture(*streamed, tail, data.data(), batch);
+	if (!resource)
+		return false;
+
+	texture.texture = resource;
+
+	streamed->texture = &texture;
+	streamed->tailMip = streamed->residentMip = streamed->wantedMip = tail;
+	streamed->loadedFrame = frame;
+	textures[&texture] = std::move(streamed);
+
+	return true;
+}
+
+void TextureStreaming::reportUsage(const ShaderTextureView* view, float screenPixels)
+{
+	auto it = textures.find(view);
+	if (it == textures.end())
+		return;
+
+	auto& t = *it->second;
+	t.hasFeedback = true;
+	t.lastUsedFrame = frame;
+
+	auto& top = t.file.mips.front();
+	const float ratio = std::max(top.width, top.height) / std::max(screenPixels, 1.0f);
+
+	UINT mip = ratio > 1 ? UINT(std::log2(ratio)) : 0;
+	mip = mip > MipBias ? mip - MipBias : 0;
+
+	t.wantedMip = std::min(t.wantedMip, mip);
+}
+
+void TextureStreaming::gatherUsage(RenderWorld& world, const Camera& camera, float viewportHeight)
+{
+	CpuProfiler::Zone zone("TextureStreaming::gatherUsage");
+
+	if (textures.empty())
+		return;
+
+	const auto frustum = camera.prepareFrustum();
+	const auto cameraPosition = camera.getPosition();
+	const float tanHalfFov = std::tan(camera.getParams().fov * 0.5f);
+
+	for (auto order : { Order::Normal, Order::Transparent })
+	{
+		world.getRenderables(order)->iterateObjects([&](RenderObject& object)
+			{
+				auto& entity = (RenderEntity&)object;
+				if (!entity.material)
+					return;
+
+				auto& bbox = entity.getWorldBoundingBox();
+				if (bbox.Extents.x != 0 && !frustum.Intersects(bbox))
+					return;
+
+				const float radius = Vector3(bbox.Extents).Length();
+				const float distance = Vector3(Vector3(bbox.Center) - cameraPosition).Length() - radius;
+
+				// projected size of bounds, camera inside means full detail
+				const float screenPixels = distance > 0 ? viewportHeight * radius / (distance * tanHalfFov) : FLT_MAX;
+
+				for (UINT i = 0; i < entity.material->GetTexturesCount(); i++)
+					reportUsage(entity.material->GetTexture(i), screenPixels);
+			});
+	}
+}
+
+void TextureStreaming::update(float uploadBudgetMs)
+{
+	CpuProfiler::Zone zone("TextureStreaming::update");
+
+	frame++;
+
+	if (uploadFinished.valid() && uploadFinished.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+	{
+		uploadFinished.get();
+
+		for (auto& [request, resource] : uploading)
+		{
+			request->texture->loading = false;
+
+			if (resource)
+			{
+				// in flight frames can still use previous resource
+				VertexBufferModelGarbageCollector::Get().enqueue(request->texture->texture->texture.Detach());
+				request->texture->texture->texture = resource;
+				request->texture->residentMip = request->firstMip;
+
+				DescriptorManager::get().updateTextureView(*request->texture->texture);
+			}
+		}
+
+		uploading.clear();
+	}
+
+	std::vector<StreamedTexture*> upgrades;
+	size_t neededBytes = 0;
+
+	for (auto& [view, t] : textures)
+	{
+		if (!t->hasFeedback && frame - t->loadedFrame > FeedbackGraceFrames)
+		{
+			t->wantedMip = 0;
+			t->lastUsedFrame = frame;
+		}
+
+		if (!t->loading && t->wantedMip < t->residentMip)
+		{
+			upgrades.push_back(t.get());
+			neededBytes += t->file.getMipsSize(t->wantedMip) - t->residentBytes();
+		}
+	}
+
+	evictOverBudget(neededBytes);
+
+	size_t residentBytes = getStats().residentBytes;
+	for (auto t : upgrades)
+	{
+		// partial upgrade when whole does not fit
+		UINT mip = t->wantedMip;
+		while (mip < t->residentMip && residentBytes + t->file.getMipsSize(mip) - t->residentBytes() > memoryBudget)
+			mip++;
+
+		if (mip < t->residentMip)
+		{
+			residentBytes += t->file.getMipsSize(mip) - t->residentBytes();
+			request(*t, mip);
+		}
+	}
+
+	for (auto& [view, t] : textures)
+		t->wantedMip = t->tailMip;
+
+	if (uploadFinished.valid())
+		return;
+
+	{
+		std::lock_guard lock(ioMutex);
+		pendingUploads.insert(pendingUploads.end(), readFinished.begin(), readFinished.end());
+		readFinished.clear();
+	}
+
+	if (pendingUploads.empty())
+		return;
+
+	const auto start = std::chrono::steady_clock::now();
+	uploadBatch->Begin();
+
+	while (!pendingUploads.empty())
+	{
+		auto request = pendingUploads.front();
+		pendingUploads.pop_front();
+
+		ComPtr<ID3D12Resource> resource;
+		if (!request->failed)
+			resource = createTexture(*request->texture, request->firstMip, request->data.data(), *uploadBatch);
+
+		if (resource)
+		{
+			RenderStats::Add(RenderStat::UploadedTextures);
+			RenderStats::Add(RenderStat::UploadBytes, request->data.size());
+		}
+
+		request->data = {};
+		uploading.emplace_back(request, resource);
+
+		if (std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() >= uploadBudgetMs)
+			break;
+	}
+
+	uploadFinished = uploadBatch->End(commandQueue);
+}
+
+void TextureStreaming::evictOverBudget(size_t neededBytes)
+{
+	size_t residentBytes = getStats().residentBytes;
+	if (residentBytes + neededBytes <= memoryBudget)
+		return;
+
+	std::vector<StreamedTexture*> candidates;
+	for (auto& [view, t] : textures)
+	{
+		if (!t->loading && t->residentMip < t->tailMip && t->lastUsedFrame + EvictAfterFrames < frame)
+			candidates.push_back(t.get());
+	}
+
+	// least recently used first
+	std::sort(candidates.begin(), candidates.end(), [](StreamedTexture* a, StreamedTexture* b) { return a->lastUsedFrame < b->lastUsedFrame; });
+
+	for (auto t : candidates)
+	{
+		if (residentBytes + neededBytes <= memoryBudget)
+			break;
+
+		residentBytes -= t->residentBytes() - t->file.getMipsSize(t->tailMip);
+		request(*t, t->tailMip);
+	}
+}
+
+void TextureStreaming::request(StreamedTexture& texture, UINT mip)
+{
+	texture.loading = true;
+	texture.loadingMip = mip;
+
+	auto r = std::make_shared<ReadRequest>();
+	r->texture = &texture;
+	r->firstMip = mip;
+
+	std::erase_if(readJobs, [](const JobSystem::Handle& job) { return job.done(); });
+	readJobs.push_back(JobSystem::GetIo().submit([this, r]() { read(r); }));
+}
+
+ComPtr<ID3D12Resource> TextureStreaming::createTexture(const StreamedTexture& texture, UINT firstMip, const uint8_t* data, ResourceUploadBatch& batch)
+{
+	auto& mips = texture.file.mips;
+	auto& top = mips[firstMip];
+
+	D3D12_RESOURCE_DESC desc = {};
+	desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	desc.Width = top.width;
+	desc.Height = top.height;
+	desc.DepthOrArraySize = 1;
+	desc.MipLevels = UINT16(mips.size() - firstMip);
+	desc.Format = texture.file.format;
+	desc.SampleDesc.Count = 1;
+
+	D3D12_HEAP_PROPERTIES defaultHeap = {};
+	defaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+	ComPtr<ID3D12Resource> resource;
+	auto hr = device.CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&resource));
+	if (FAILED(hr))
+	{
+		Logger::logErrorD3D("Failed to create streamed texture " + texture.file.path, hr);
+		return {};
+	}
+
+	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
+	for (size_t i = firstMip; i < mips.size(); i++)
+	{
+		subresources.push_back({ data, LONG_PTR(mips[i].rowPitch), LONG_PTR(mips[i].size) });
+		data += mips[i].size;
+	}
+
+	batch.Upload(resource.Get(), 0, subresources.data(), (UINT)subresources.size());
+	batch.Transition(resource.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+	resource->SetName(as_wstring(texture.file.path).c_str());
+
+	return resource;
+}
+
+void TextureStreaming::setMemoryBudget(size_t bytes)
+{
+	memoryBudget = bytes;
+}
+
+TextureStreaming::Stats TextureStreaming::getStats() const
+{
+	Stats stats;
+	stats.memoryBudget = memoryBudget;
+
+	for (auto& [view, t] : textures)
+	{
+		stats.textures++;
+		stats.loading += t->loading;
+		stats.fullyResident += t->residentMip == 0;
+		stats.residentBytes += t->residentBytes();
+	}
+
+	return stats;
+}
+
+void TextureStreaming::read(const ReadRequestPtr& request)
+{
+	request->failed = !request->texture->file.readMips(request->firstMip, request->data);
+
+	std::lock_guard lock(ioMutex);
+	readFinished.push_back(request);
+}
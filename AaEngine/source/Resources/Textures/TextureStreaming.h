@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Resources/Textures/DdsFile.h"
+#include "Utils/Directx.h"
+#include "Utils/JobSystem.h"
+#include <memory>
+#include <future>
+#include <mutex>
+#include <deque>
+#include <unordered_map>
+
+namespace DirectX
+{
+	class ResourceUploadBatch;
+};
+
+class FileTexture;
+struct ShaderTextureView;
+class RenderSystem;
+class RenderWorld;
+class Camera;
+
+// Loads DDS textures with low mips first, higher mips follow usage feedback within memory budget
+class TextureStreaming
+{
+public:
+
+	TextureStreaming(RenderSystem& rs);
+	~TextureStreaming();
+
+	static TextureStreaming& Get();
+
+	// loads only mip tail of streamable file, false when it has to be loaded whole
+	bool load(FileTexture& texture, DirectX::ResourceUploadBatch& batch, const std::string& file, bool forceSrgb);
+
+	// surface using texture covers screenPixels, used to pick needed mip
+	void reportUsage(const ShaderTextureView* texture, float screenPixels);
+	// CPU feedback from bounds of visible entities and their material textures
+	void gatherUsage(RenderWorld& world, const Camera& camera, float viewportHeight);
+
+	// evicts over budget, requests needed mips and uploads read ones, call once per frame
+	void update(float uploadBudgetMs = 1.0f);
+
+	void setMemoryBudget(size_t bytes);
+
+	struct Stats
+	{
+		UINT textures{};
+		UINT loading{};
+		UINT fullyResident{};
+		size_t residentBytes{};
+		size_t memoryBudget{};
+	};
+	Stats getStats() const;
+
+	// smallest mips are always resident
+	static constexpr UINT TailSize = 128;
+
+private:
+
+	ID3D12Device& device;
+	ID3D12CommandQueue* commandQueue;
+
+	struct StreamedTexture
+	{
+		FileTexture* texture{};
+		DdsFile file;
+
+		UINT tailMip{};
+		UINT residentMip{};
+		UINT wantedMip{};
+		UINT loadingMip{};
+		bool loading{};
+
+		uint64_t loadedFrame{};
+		uint64_t lastUsedFrame{};
+		bool hasFeedback{};
+
+		size_t residentBytes() const { return file.getMipsSize(residentMip); }
+	};
+	std::unordered_map<const ShaderTextureView*, std::unique_ptr<StreamedTexture>> textures;
+
+	struct ReadRequest
+	{
+		StreamedTexture* texture{};
+		UINT firstMip{};
+		std::vector<uint8_t> data;
+		bool failed{};
+	};
+	using ReadRequestPtr = std::shared_ptr<ReadRequest>;
+
+	void request(StreamedTexture& texture, UINT mip);
+	void evictOverBudget(size_t pendingBytes);
+	ComPtr<ID3D12Resource> createTexture(const StreamedTexture& texture, UINT firstMip, const uint8_t* data, DirectX::ResourceUploadBatch& batch);
+
+	uint64_t frame{};
+	size_t memoryBudget = 512ull * 1024 * 1024;
+
+	// main thread only
+	std::deque<ReadRequestPtr> pendingUploads;
+	std::vector<std::pair<ReadRequestPtr, ComPtr<ID3D12Resource>>> uploading;
+	std::unique_ptr<DirectX::ResourceUploadBatch> uploadBatch;
+	std::future<void> uploadFinished;
+
+	// reads running on I/O workers
+	std::vector<JobSystem::Handle> readJobs;
+
+	// shared with I/O jobs
+	std::mutex ioMutex;
+	std::deque<ReadRequestPtr> readFinished;
+
+	void read(const ReadRequestPtr& request);
+};
@@ -1,13 +1,42 @@
 #include "Scene/Collection/SceneCollection.h"
 #include "Resources/GraphicsResources.h"
 #include "Scene/RenderWorld.h"
+#include "Resources/Material/MaterialEvents.h"
+
+// core model shown until streamed model is uploaded
+const std::string PlaceholderModel = "box.mesh";
+
+static void SwapPlaceholderModel(RenderWorld& renderWorld, ObjectId id, VertexBufferModel* placeholder, VertexBufferModel* model)
+{
+	auto entity = renderWorld.getEntity(id);
+
+	// removed or id reused in meantime
+	if (!entity || entity->geometry.getModel() != placeholder)
+		return;
+
+	if (!model)
+	{
+		renderWorld.removeEntity(entity);
+		return;
+	}
+
+	entity->setBoundingBox(model->bbox);
+	entity->setTransformation(entity->getTransformation(), false);
+	entity->geometry.fromModel(*model);
+	// model is referenced by entity from now, placeholder is released
+	entity->updateModelReference();
+
+	MaterialEvents::Get().notifyEntityParamChanged(*entity);
+}
 
 void SceneCollection::loadResource(const ResourceData& data, LoadCtx ctx)
 {
+	auto& models = ctx.resources.models;
+	auto placeholder = models.getCoreModel(PlaceholderModel);
+
 	for (const auto& e : data.entities)
 	{
 		auto material = ctx.resources.materials.getMaterial(e.materialName, ctx.batch);
-		auto model = ctx.resources.models.getModel(e.mesh.name, ctx.batch, { data.path });
 
 		EntityCreateProperties props;
 		props.groupId = 0;
@@ -16,8 +45,22 @@ void SceneCollection::loadResource(const ResourceData& data, LoadCtx ctx)
 		if (material->IsTransparent())
 			props.order = Order::Transparent;
 
-		auto ent = ctx.renderWorld.createEntity(e.tr, *model, props);
+		if (!placeholder)
+		{
+			auto model = models.getModel(e.mesh.name, ctx.batch, { data.path });
+			auto ent = ctx.renderWorld.createEntity(e.tr, *model, props);
+			ent->material = material;
+			continue;
+		}
+
+		auto ent = ctx.renderWorld.createEntity(e.tr, *placeholder, props);
 		ent->material = material;
+
+		// already loaded models are swapped right away
+		models.loadModelAsync(e.mesh.name, { data.path }, [&renderWorld = ctx.renderWorld, id = ent->getGlobalId(), placeholder](VertexBufferModel* model)
+			{
+				SwapPlaceholderModel(renderWorld, id, placeholder, model);
+			});
 	}
 }
 
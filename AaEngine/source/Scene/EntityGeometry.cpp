@@ -27,6 +27,7 @@ void EntityGeometry::fromModel(VertexBufferModel& model)
 	layout = &model.vertexLayout;
 	instanceCount = 1;
 	source = &model;
+	sourceModel = &model;
 	type = Type::Model;
 }
 
@@ -59,9 +60,9 @@ VertexBufferModel* EntityGeometry::getModel() const
 	return nullptr;
 }
 
-void IndirectEntityGeometry::draw(ID3D12GraphicsCommandList* commandList, UINT frameIndex)
+void IndirectEntityGeometry::draw(GraphicsCommands& commands, UINT frameIndex)
 {
-	commandList->ExecuteIndirect(
+	commands.ExecuteIndirect(
 		commandSignature.Get(),
 		maxCommands,
 		commandBuffer.Get(),
@@ -3,6 +3,7 @@
 #include "Utils/Directx.h"
 #include "Resources/Shader/ShaderDataBuffers.h"
 #include "Resources/Shader/ShaderConstantsProvider.h"
+#include "RenderCore/GraphicsCommands.h"
 #include <utility>
 #include <array>
 
@@ -76,6 +77,8 @@ struct EntityGeometry
 	void fromMeshInstancedModel(UINT count, D3D12_GPU_VIRTUAL_ADDRESS instancingBuffer);
 
 	VertexBufferModel* getModel() const;
+	// last model set, also for instanced geometry
+	VertexBufferModel* sourceModel{};
 };
 
 class IndirectEntityGeometry
@@ -88,5 +91,5 @@ public:
 	UINT maxCommands{};
 	UINT commandBufferOffset{};
 
-	void draw(ID3D12GraphicsCommandList* commandList, UINT frameIndex);
+	void draw(GraphicsCommands& commands, UINT frameIndex);
 };
\ No newline at end of file
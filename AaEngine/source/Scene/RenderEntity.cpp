@@ -17,6 +17,22 @@ RenderEntity::RenderEntity(RenderObjectsStorage& r, RenderEntity& source) : Rend
 
 RenderEntity::~RenderEntity()
 {
+	if (referencedModel)
+		referencedModel->releaseReference();
+}
+
+void RenderEntity::updateModelReference()
+{
+	if (referencedModel == geometry.sourceModel)
+		return;
+
+	if (referencedModel)
+		referencedModel->releaseReference();
+
+	referencedModel = geometry.sourceModel;
+
+	if (referencedModel)
+		referencedModel->addReference();
 }
 
 EntityMaterialInterface RenderEntity::Material()
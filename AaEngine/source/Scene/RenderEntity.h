@@ -42,4 +42,11 @@ public:
 	MaterialPropertiesOverrideDescription* materialOverride{};
 
 	EntityGeometry geometry;
+
+	// keeps geometry model resident, called when entity is added or its geometry changed
+	void updateModelReference();
+
+private:
+
+	VertexBufferModel* referencedModel{};
 };
@@ -1,5 +1,8 @@
 #include "Scene/RenderObject.h"
 #include "Scene/Camera.h"
+#include "Utils/CpuProfiler.h"
+#include "Utils/RenderStats.h"
+#include <algorithm>
 
 RenderObjectsStorage::RenderObjectsStorage(Order o) : order(o)
 {
@@ -11,55 +14,85 @@ RenderObjectsStorage::~RenderObjectsStorage()
 
 UINT RenderObjectsStorage::createId(RenderObject* obj)
 {
-	if (!freeIds.empty())
-	{
-		auto id = freeIds.back();
-		freeIds.pop_back();
-
-		objectsData.transformation[id] = {};
-		objectsData.dirtyTransformation[id] = {};
-		objectsData.bbox[id] = {};
-		objectsData.worldBbox[id] = {};
-		objectsData.worldMatrix[id] = {};
-		objectsData.prevWorldMatrix[id] = {};
-		objectsData.objects[id] = obj;
-		objectsData.flags[id] = {};
+	std::lock_guard lock(mutex);
 
-		auto pos = std::lower_bound(ids.begin(), ids.end(), id);
-		ids.insert(pos, id);
+	UINT id;
+	bool recycled = !freeIds.empty();
 
-		return id;
+	if (recycled)
+	{
+		id = freeIds.back();
+		freeIds.pop_back();
+	}
+	else
+	{
+		id = slotsCount.load(std::memory_order_relaxed);
+
+		// chunks are never moved, growing does not disturb threads reading other objects
+		objectsData.transformation.reserve(id + 1);
+		objectsData.dirtyTransformation.reserve(id + 1);
+		objectsData.bbox.reserve(id + 1);
+		objectsData.worldBbox.reserve(id + 1);
+		objectsData.worldMatrix.reserve(id + 1);
+		objectsData.prevWorldMatrix.reserve(id + 1);
+		objectsData.objects.reserve(id + 1);
+		objectsData.flags.reserve(id + 1);
 	}
 
-	auto id = (UINT)ids.size();
+	objectsData.transformation[id] = {};
+	objectsData.dirtyTransformation[id] = !recycled;
+	objectsData.bbox[id] = {};
+	objectsData.worldBbox[id] = {};
+	objectsData.worldMatrix[id] = {};
+	objectsData.prevWorldMatrix[id] = {};
+	objectsData.objects[id] = obj;
+	objectsData.flags[id] = {};
 
-	objectsData.transformation.push_back({});
-	objectsData.dirtyTransformation.emplace_back(true);
-	objectsData.bbox.emplace_back();
-	objectsData.worldBbox.emplace_back();
-	objectsData.worldMatrix.emplace_back();
-	objectsData.prevWorldMatrix.emplace_back();
-	objectsData.objects.push_back(obj);
-	objectsData.flags.emplace_back();
+	if (!recycled)
+		slotsCount.store(id + 1, std::memory_order_release);
 
-	ids.push_back(id);
+	aliveCount++;
 
 	return id;
 }
 
 void RenderObjectsStorage::deleteId(UINT id)
 {
+	std::lock_guard lock(mutex);
+
 	auto pos = std::lower_bound(ids.begin(), ids.end(), id);
-	ids.erase(pos);
+	if (pos != ids.end() && *pos == id)
+		ids.erase(pos);
+	else
+		std::erase(publishedIds, id);
 
 	freeIds.push_back(id);
 
-	if (ids.empty())
+	if (--aliveCount == 0)
 		reset();
 }
 
+void RenderObjectsStorage::publishId(UINT id)
+{
+	std::lock_guard lock(mutex);
+
+	publishedIds.push_back(id);
+}
+
 void RenderObjectsStorage::updateTransformation()
 {
+	{
+		std::lock_guard lock(mutex);
+
+		if (!publishedIds.empty())
+		{
+			auto middle = ids.insert(ids.end(), publishedIds.begin(), publishedIds.end());
+			std::sort(middle, ids.end());
+			std::inplace_merge(ids.begin(), middle, ids.end());
+			publishedIds.clear();
+		}
+	}
+
 	for (auto id : ids)
 	{
 		if (auto& dirty = objectsData.dirtyTransformation[id])
@@ -85,23 +118,37 @@ void RenderObjectsStorage::initializeTransformation(UINT id, ObjectTransformatio
 
 void RenderObjectsStorage::updateVisibility(const BoundingFrustum& frustum, RenderObjectsVisibilityState& visible, const std::vector<UINT>& ids) const
 {
+	uint64_t visibleCount = 0;
+
 	for (auto id : ids)
 	{
 		visible[id] = objectsData.worldBbox[id].Extents.x == 0 || frustum.Intersects(objectsData.worldBbox[id]);
+		visibleCount += visible[id];
 	}
+
+	RenderStats::Add(RenderStat::VisibleObjects, visibleCount);
+	RenderStats::Add(RenderStat::CulledObjects, ids.size() - visibleCount);
 }
 
 void RenderObjectsStorage::updateVisibility(const BoundingOrientedBox& box, RenderObjectsVisibilityState& visible, const std::vector<UINT>& ids) const
 {
+	uint64_t visibleCount = 0;
+
 	for (auto id : ids)
 	{
 		visible[id] = box.Intersects(objectsData.worldBbox[id]);
+		visibleCount += visible[id];
 	}
+
+	RenderStats::Add(RenderStat::VisibleObjects, visibleCount);
+	RenderStats::Add(RenderStat::CulledObjects, ids.size() - visibleCount);
 }
 
 void RenderObjectsStorage::updateVisibility(const Camera& camera, RenderObjectsVisibilityData& info) const
 {
-	info.visibility.resize(ids.size() + freeIds.size());
+	CpuProfiler::Zone zone("Culling");
+
+	info.visibility.resize(getSlotsCount());
 
 	if (camera.isOrthographic())
 		updateVisibility(camera.prepareOrientedBox(), info.visibility, ids);
@@ -111,7 +158,9 @@ void RenderObjectsStorage::updateVisibility(const Camera& camera, RenderObjectsV
 
 void RenderObjectsStorage::updateVisibility(const Camera& camera, const std::vector<UINT>& filtered, RenderObjectsVisibilityData& info) const
 {
-	info.visibility.resize(ids.size() + freeIds.size());
+	CpuProfiler::Zone zone("Culling");
+
+	info.visibility.resize(getSlotsCount());
 
 	if (camera.isOrthographic())
 		updateVisibility(camera.prepareOrientedBox(), info.visibility, filtered);
@@ -132,21 +181,24 @@ void RenderObjectsStorage::createFilteredIds(uint8_t flag, std::vector<UINT>& fi
 
 RenderObject* RenderObjectsStorage::getObject(UINT id) const
 {
-	return objectsData.objects.size() > id ? objectsData.objects[id] : nullptr;
+	return getSlotsCount() > id ? objectsData.objects[id] : nullptr;
 }
 
-void RenderObjectsStorage::iterateObjects(std::function<void(RenderObject&)> func) const
+UINT RenderObjectsStorage::getSlotsCount() const
 {
-	for (auto id : ids)
-	{
-		func(*objectsData.objects[id]);
-	}
+	return slotsCount.load(std::memory_order_acquire);
+}
+
+std::span<const UINT> RenderObjectsStorage::getIds() const
+{
+	return ids;
 }
 
 void RenderObjectsStorage::reset()
 {
+	// chunks stay allocated for next objects
 	freeIds.clear();
-	objectsData = {};
+	slotsCount.store(0, std::memory_order_release);
 }
 
 DirectX::XMMATRIX ObjectTransformation::createWorldMatrix() const
@@ -319,6 +371,13 @@ XMMATRIX RenderObject::getWorldMatrix() const
 	return source.objectsData.worldMatrix[id];
 }
 
+Vector3 RenderObject::getWorldPosition() const
+{
+	Vector3 position;
+	XMStoreFloat3(&position, source.objectsData.worldMatrix[id].r[3]);
+	return position;
+}
+
 XMMATRIX RenderObject::getPreviousWorldMatrix() const
 {
 	return source.objectsData.prevWorldMatrix[id];
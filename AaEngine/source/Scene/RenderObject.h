@@ -2,6 +2,10 @@
 
 #include "Utils/MathUtils.h"
 #include "Scene/ObjectId.h"
+#include "Utils/ChunkedArray.h"
+#include <atomic>
+#include <mutex>
+#include <span>
 
 struct ObjectTransformation
 {
@@ -54,9 +58,14 @@ public:
 	RenderObjectsStorage(Order o = Order::Normal);
 	~RenderObjectsStorage();
 
+	// safe to call from any thread, new ids are not iterated until published
 	UINT createId(RenderObject*);
 	void deleteId(UINT);
 
+	// object is fully set up, its id is iterated after next updateTransformation
+	void publishId(UINT);
+
+	// also merges published ids, called from main thread
 	void updateTransformation();
 	void updateTransformation(UINT id, ObjectTransformation& transformation);
 	void initializeTransformation(UINT id, ObjectTransformation& transformation);
@@ -66,21 +75,49 @@ public:
 
 	void createFilteredIds(uint8_t flag, std::vector<UINT>& ids) const;
 
+	// transformation is written by simulation, world matrices and bounds are render snapshot taken in updateTransformation
 	struct
 	{
-		std::vector<ObjectTransformation> transformation;
-		std::vector<uint8_t> dirtyTransformation;
-		std::vector<XMMATRIX> worldMatrix;
-		std::vector<XMMATRIX> prevWorldMatrix;
-		std::vector<BoundingBox> worldBbox;
-		std::vector<BoundingBox> bbox;
-		std::vector<RenderObject*> objects;
-		std::vector<RenderObjectFlags> flags;
+		ChunkedArray<ObjectTransformation> transformation;
+		ChunkedArray<uint8_t> dirtyTransformation;
+		ChunkedArray<XMMATRIX> worldMatrix;
+		ChunkedArray<XMMATRIX> prevWorldMatrix;
+		ChunkedArray<BoundingBox> worldBbox;
+		ChunkedArray<BoundingBox> bbox;
+		ChunkedArray<RenderObject*> objects;
+		ChunkedArray<RenderObjectFlags> flags;
 	}
 	objectsData;
 
 	RenderObject* getObject(UINT id) const;
-	void iterateObjects(std::function<void(RenderObject&)>) const;
+	// highest id + 1, size for visibility state
+	UINT getSlotsCount() const;
+
+	template<typename Func>
+	void iterateObjects(Func&& func) const
+	{
+		for (auto id : ids)
+			func(*objectsData.objects[id]);
+	}
+
+	// called once per run of consecutive ids within storage chunk with slice of objects
+	template<typename Func>
+	void iterateObjectRanges(Func&& func) const
+	{
+		for (size_t i = 0; i < ids.size();)
+		{
+			const size_t maxCount = objectsData.objects.contiguousCount(ids[i]);
+
+			size_t count = 1;
+			while (count < maxCount && i + count < ids.size() && ids[i + count] == ids[i] + count)
+				count++;
+
+			func(std::span<RenderObject* const>(&objectsData.objects[ids[i]], count));
+			i += count;
+		}
+	}
+
+	std::span<const UINT> getIds() const;
 
 	Order order;
 
@@ -91,8 +128,15 @@ private:
 
 	void reset();
 
+	// sorted ids iterated by render, modified only from main thread
 	std::vector<UINT> ids;
+
+	// guards slots allocation, from any thread
+	std::mutex mutex;
 	std::vector<UINT> freeIds;
+	std::vector<UINT> publishedIds;
+	UINT aliveCount{};
+	std::atomic<UINT> slotsCount{};
 };
 
 class RenderObject
@@ -126,6 +170,8 @@ public:
 	bool isVisible(const BoundingOrientedBox&) const;
 
 	XMMATRIX getWorldMatrix() const;
+	// position from render snapshot, safe to use while simulation runs
+	Vector3 getWorldPosition() const;
 	XMMATRIX getPreviousWorldMatrix() const;
 	void updateWorldMatrix();
 
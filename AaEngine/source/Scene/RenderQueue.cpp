@@ -1,6 +1,8 @@
 #include "Scene/RenderQueue.h"
 #include "Scene/EntityInstancing.h"
 #include "Resources/GraphicsResources.h"
+#include "Utils/CpuProfiler.h"
+#include "Utils/RenderStats.h"
 #include <algorithm>
 
 void RenderQueue::update(const EntityChangeDescritpion& changeInfo, GraphicsResources& resources)
@@ -12,25 +14,11 @@ void RenderQueue::update(const EntityChangeDescritpion& changeInfo, GraphicsReso
 		if (order != targetOrder)
 			return;
 
-		auto matInstance = entity->material;
-		if (technique != MaterialTechnique::Default)
-		{
-			if (technique == MaterialTechnique::DepthShadowmap && entity->hasFlag(RenderObjectFlag::NoShadow))
-				return;
-
-			if (auto techniqueOverride = matInstance->GetTechniqueOverride(technique))
-			{
-				if (techniqueOverride[0] == '\0') //skip
-					return;
-
-				matInstance = resources.materials.getMaterial(techniqueOverride);
-
-				if (!matInstance)
-					__debugbreak();
-			}
-		}
+		auto material = assignMaterial(entity, resources);
+		if (!material)
+			return;
 
-		auto entry = EntityEntry(entity, matInstance->Assign(entity->geometry.layout ? *entity->geometry.layout : std::vector<D3D12_INPUT_ELEMENT_DESC>{}, targetFormats, technique), technique, suborder);
+		auto entry = EntityEntry(entity, material, technique, suborder);
 
 		auto it = std::lower_bound(entities.begin(), entities.end(), entry);
 		entities.insert(it, std::move(entry));
@@ -55,58 +43,123 @@ void RenderQueue::update(const EntityChangeDescritpion& changeInfo, GraphicsReso
 	}
 }
 
+void RenderQueue::addObjects(std::span<RenderObject* const> objects, int suborder, GraphicsResources& resources)
+{
+	addObjects(objects, suborder, [&](RenderEntity* entity) { return assignMaterial(entity, resources); });
+}
+
+AssignedMaterial* RenderQueue::assignMaterial(RenderEntity* entity, GraphicsResources& resources)
+{
+	auto matInstance = entity->material;
+	if (technique != MaterialTechnique::Default)
+	{
+		if (technique == MaterialTechnique::DepthShadowmap && entity->hasFlag(RenderObjectFlag::NoShadow))
+			return nullptr;
+
+		if (auto techniqueOverride = matInstance->GetTechniqueOverride(technique))
+		{
+			if (techniqueOverride[0] == '\0') //skip
+				return nullptr;
+
+			matInstance = resources.materials.getMaterial(techniqueOverride);
+
+			if (!matInstance)
+				__debugbreak();
+		}
+	}
+
+	return matInstance->Assign(entity->geometry.layout ? *entity->geometry.layout : std::vector<D3D12_INPUT_ELEMENT_DESC>{}, targetFormats, technique);
+}
+
 void RenderQueue::reset()
 {
 	entities.clear();
 }
 
-static void RenderObject(ID3D12GraphicsCommandList* commandList, EntityGeometry& geometry, UINT frameIndex)
+struct DrawCounters
+{
+	uint64_t draws{};
+	uint64_t instances{};
+	uint64_t triangles{};
+	uint64_t pipelines{};
+	uint64_t signatures{};
+	uint64_t textures{};
+	uint64_t constants{};
+
+	void submit() const
+	{
+		RenderStats::Add(RenderStat::DrawCalls, draws);
+		RenderStats::Add(RenderStat::Instances, instances);
+		RenderStats::Add(RenderStat::Triangles, triangles);
+		RenderStats::Add(RenderStat::PipelineChanges, pipelines);
+		RenderStats::Add(RenderStat::RootSignatureBinds, signatures);
+		RenderStats::Add(RenderStat::TextureBinds, textures);
+		RenderStats::Add(RenderStat::ConstantBinds, constants);
+	}
+};
+
+static void RenderObject(GraphicsCommands& commands, EntityGeometry& geometry, UINT frameIndex, DrawCounters& counters)
 {
 	if (!geometry.instanceCount && geometry.type != EntityGeometry::Type::Indirect)
 		return;
 
-	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY(geometry.topology));
+	counters.draws++;
+	counters.instances += geometry.instanceCount;
+	// indirect and mesh shader primitive counts are known only on gpu
+	if (geometry.type != EntityGeometry::Type::Indirect && geometry.type != EntityGeometry::Type::Mesh)
+		counters.triangles += uint64_t(geometry.indexCount ? geometry.indexCount : geometry.vertexCount) / 3 * geometry.instanceCount;
+
+	commands.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY(geometry.topology));
 
 	if (geometry.type == EntityGeometry::Type::Indirect)
 	{
 		if (geometry.indexCount)
 		{
-			commandList->IASetIndexBuffer(&geometry.indexBufferView);
+			commands.IASetIndexBuffer(&geometry.indexBufferView);
 		}
 		if (geometry.vertexBufferView.BufferLocation)
 		{
-			commandList->IASetVertexBuffers(0, 1, &geometry.vertexBufferView);
+			commands.IASetVertexBuffers(0, 1, &geometry.vertexBufferView);
 		}
 
-		((IndirectEntityGeometry*)geometry.source)->draw(commandList, frameIndex);
+		((IndirectEntityGeometry*)geometry.source)->draw(commands, frameIndex);
 	}
 	else if (geometry.type == EntityGeometry::Type::Mesh)
 	{
-		((ID3D12GraphicsCommandList6*)commandList)->DispatchMesh(geometry.instanceCount, 1, 1);
+		commands.DispatchMesh(geometry.instanceCount, 1, 1);
 	}
 	else
 	{
 		if (geometry.vertexBufferView.BufferLocation)
 		{
-			commandList->IASetVertexBuffers(0, 1, &geometry.vertexBufferView);
+			commands.IASetVertexBuffers(0, 1, &geometry.vertexBufferView);
 		}
 
 		if (geometry.indexCount)
 		{
-			commandList->IASetIndexBuffer(&geometry.indexBufferView);
-			commandList->DrawIndexedInstanced(geometry.indexCount, geometry.instanceCount, 0, 0, 0);
+			commands.IASetIndexBuffer(&geometry.indexBufferView);
+			commands.DrawIndexedInstanced(geometry.indexCount, geometry.instanceCount, 0, 0, 0);
 		}
 		else
-			commandList->DrawInstanced(geometry.vertexCount, geometry.instanceCount, 0, 0);
+			commands.DrawInstanced(geometry.vertexCount, geometry.instanceCount, 0, 0);
 	}
 }
 
 void RenderQueue::renderObjects(ShaderConstantsProvider& constants, ID3D12GraphicsCommandList* commandList)
 {
-	const MaterialBase* lastMaterialBase{};
+	D3D12GraphicsCommands commands(commandList);
+	renderObjects(constants, commands);
+}
+
+void RenderQueue::renderObjects(ShaderConstantsProvider& constants, GraphicsCommands& commands)
+{
+	CpuProfiler::Zone zone("RenderQueue::renderObjects");
+
+	const ID3D12RootSignature* lastSignature{};
 	AssignedMaterial* lastMaterial{};
 
 	MaterialDataStorage storage;
+	DrawCounters counters;
 
 	for (auto& entry : entities)
 	{
@@ -115,18 +168,24 @@ void RenderQueue::renderObjects(ShaderConstantsProvider& constants, ID3D12Graphi
 
 		constants.entity = entry.entity;
 
-		if (entry.base != lastMaterialBase)
-			entry.base->BindSignature(commandList);
+		// material bases can share same root signature
+		if (entry.base->GetSignature() != lastSignature)
+		{
+			entry.base->BindSignature(commands);
+			counters.signatures++;
+		}
 
 		if (entry.material != lastMaterial)
 		{
-			entry.material->BindPipeline(commandList);
+			entry.material->BindPipeline(commands);
+			counters.pipelines++;
 
 			if (!lastMaterial || entry.material->origin != lastMaterial->origin)
 			{
 				entry.material->LoadMaterialConstants(storage);
 				entry.material->UpdatePerFrame(storage, constants);
-				entry.material->BindTextures(commandList);
+				entry.material->BindTextures(commands);
+				counters.textures++;
 			}
 		}
 
@@ -134,19 +193,22 @@ void RenderQueue::renderObjects(ShaderConstantsProvider& constants, ID3D12Graphi
 			entry.material->ApplyParametersOverride(*entry.materialOverride, storage, constants.viewId);
 
 		entry.material->UpdatePerObject(storage, constants);
-		entry.material->BindConstants(commandList, storage, constants);
+		entry.material->BindConstants(commands, storage, constants);
+		counters.constants++;
 
-		RenderObject(commandList, entry.entity->geometry.getGeometry(constants.viewId), constants.params.frameIndex);
+		RenderObject(commands, entry.entity->geometry.getGeometry(constants.viewId), constants.params.frameIndex, counters);
 
 		if (constants.uavBarrier)
 		{
 			auto uavBarrier = CD3DX12_RESOURCE_BARRIER::UAV(constants.uavBarrier);
-			commandList->ResourceBarrier(1, &uavBarrier);
+			commands.ResourceBarrier(1, &uavBarrier);
 		}
 
-		lastMaterialBase = entry.base;
+		lastSignature = entry.base->GetSignature();
 		lastMaterial = entry.material;
 	}
+
+	counters.submit();
 }
 
 void RenderQueue::rebuildEntries(const std::vector<MaterialBase*>& reloaded)
@@ -180,20 +242,6 @@ void RenderQueue::rebuildEntries(const RenderEntity* reloaded)
 	}
 }
 
-void RenderQueue::iterateMaterials(std::function<void(AssignedMaterial*)> func)
-{
-	AssignedMaterial* m{};
-
-	for (auto& entry : entities)
-	{
-		if (entry.material != m)
-		{
-			m = entry.material;
-			func(m);
-		}
-	}
-}
-
 RenderQueue::EntityEntry::EntityEntry(RenderEntity* e, AssignedMaterial* m, MaterialTechnique technique, int o)
 {
 	entity = e;
@@ -3,7 +3,8 @@
 #include "Scene/RenderEntity.h"
 #include "Scene/Camera.h"
 #include "Scene/RenderObject.h"
-#include <functional>
+#include <span>
+#include <algorithm>
 
 enum class EntityChange
 {
@@ -51,11 +52,50 @@ struct RenderQueue
 	std::vector<EntityEntry> entities;
 
 	void update(const EntityChangeDescritpion&, GraphicsResources& resources);
+	// sorted once for whole batch instead of per entity insert
+	void addObjects(std::span<RenderObject* const> objects, int suborder, GraphicsResources& resources);
+	// assign(RenderEntity*) returns material used by this queue, nullptr skips entity
+	template<typename AssignFunc>
+	void addObjects(std::span<RenderObject* const> objects, int suborder, AssignFunc&& assign)
+	{
+		const auto first = entities.size();
+		entities.reserve(first + objects.size());
+
+		for (auto obj : objects)
+		{
+			auto entity = (RenderEntity*)obj;
+			if (auto material = assign(entity))
+				entities.emplace_back(entity, material, technique, suborder);
+		}
+
+		auto middle = entities.begin() + first;
+		std::stable_sort(middle, entities.end());
+		std::inplace_merge(entities.begin(), middle, entities.end());
+	}
 	void rebuildEntries(const std::vector<MaterialBase*>& reloaded);
 	void rebuildEntries(const RenderEntity* reloaded);
 	void reset();
 
 	void renderObjects(ShaderConstantsProvider& info, ID3D12GraphicsCommandList* commandList);
+	void renderObjects(ShaderConstantsProvider& info, GraphicsCommands& commands);
+
+	template<typename Func>
+	void iterateMaterials(Func&& func)
+	{
+		AssignedMaterial* m{};
+
+		for (auto& entry : entities)
+		{
+			if (entry.material != m)
+			{
+				m = entry.material;
+				func(m);
+			}
+		}
+	}
+
+private:
 
-	void iterateMaterials(std::function<void(AssignedMaterial*)>);
+	// nullptr when entity is skipped by this queue technique
+	AssignedMaterial* assignMaterial(RenderEntity* entity, GraphicsResources& resources);
 };
@@ -1,9 +1,12 @@
 #include "Scene/RenderWorld.h"
 #include "Resources/Material/MaterialEvents.h"
+#include "Utils/CpuProfiler.h"
 
 RenderWorld::RenderWorld(GraphicsResources& r) : resources(r), graph(*this)
 {
-	renderables.reserve(10); //need to be enough! distributed by ptr
+	// created upfront so entities can be created from any thread
+	for (auto order : { Order::Normal, Order::Post, Order::Transparent })
+		renderables.emplace_back(order);
 
 	MaterialEvents::Get().addReloadListener([this](const std::vector<MaterialBase*>& reloaded)
 	{
@@ -13,6 +16,8 @@ RenderWorld::RenderWorld(GraphicsResources& r) : resources(r), graph(*this)
 
 	MaterialEvents::Get().addEntityParamChangeListener([this](RenderEntity& entity)
 	{
+		entity.updateModelReference();
+
 		for (auto& queue : queues)
 			queue->rebuildEntries(&entity);
 	});
@@ -20,6 +25,12 @@ RenderWorld::RenderWorld(GraphicsResources& r) : resources(r), graph(*this)
 
 RenderWorld::~RenderWorld()
 {
+	pendingChanges.consume([this](EntityChangeDescritpion&& c)
+		{
+			if (c.type == EntityChange::Add)
+				entities.insert(c.entity);
+		});
+
 	for (auto entity : entities)
 	{
 		delete entity;
@@ -42,33 +53,44 @@ void RenderWorld::initialize(RenderSystem& renderSystem)
 
 void RenderWorld::update()
 {
+	CpuProfiler::Zone zone("RenderWorld::update");
+
 	updateQueues();
 	updateTransformations();
 }
 
 RenderEntity* RenderWorld::createEntity(EntityCreateProperties props)
 {
-	auto ent = new RenderEntity(*getRenderables(props.order), props.groupId);
-
-	entities.insert(ent);
-	changes.emplace_back(EntityChange::Add, props.order, ent, ent->getGlobalId(), props.suborder);
+	auto ent = prepareEntity(props);
+	commitEntity(ent, props.suborder);
 
 	return ent;
 }
 
 RenderEntity* RenderWorld::createEntity(const ObjectTransformation& transformation, VertexBufferModel& model, EntityCreateProperties props)
 {
-	auto entity = createEntity(props);
+	auto entity = prepareEntity(props);
 	entity->setBoundingBox(model.bbox);
 	entity->setTransformation(transformation, true);
 	entity->geometry.fromModel(model);
+	commitEntity(entity, props.suborder);
 
 	return entity;
 }
 
+RenderEntity* RenderWorld::prepareEntity(EntityCreateProperties props)
+{
+	return new RenderEntity(*getRenderables(props.order), props.groupId);
+}
+
+void RenderWorld::commitEntity(RenderEntity* entity, int suborder)
+{
+	pendingChanges.push({ EntityChange::Add, getOrder(entity), entity, entity->getGlobalId(), suborder });
+}
+
 void RenderWorld::removeEntity(RenderEntity* entity)
 {
-	changes.emplace_back(EntityChange::Delete, getOrder(entity), entity, entity->getGlobalId(), 0);
+	pendingChanges.push({ EntityChange::Delete, getOrder(entity), entity, entity->getGlobalId(), 0 });
 }
 
 void RenderWorld::removeEntity(ObjectId id)
@@ -144,9 +166,9 @@ RenderQueue* RenderWorld::createQueue(const std::vector<DXGI_FORMAT>& targets, M
 	queue->targetOrder = order;
 
 	auto r = getRenderables(order);
-	r->iterateObjects([&](RenderObject& obj)
+	r->iterateObjectRanges([&](std::span<RenderObject* const> objects)
 		{
-			queue->update({ EntityChange::Add, order, (RenderEntity*) &obj}, resources);
+			queue->addObjects(objects, 0, resources);
 		});
 
 	return queues.emplace_back(std::move(queue)).get();
@@ -183,6 +205,12 @@ RenderQueue RenderWorld::createManualQueue(MaterialTechnique technique, Order or
 
 void RenderWorld::updateQueues()
 {
+	changes.clear();
+	pendingChanges.consume([this](EntityChangeDescritpion&& c)
+		{
+			changes.push_back(c);
+		});
+
 	for (auto& queue : queues)
 	{
 		for (auto& c : changes)
@@ -195,13 +223,18 @@ void RenderWorld::updateQueues()
 
 	for (auto& c : changes)
 	{
-		if (c.type == EntityChange::Delete)
+		if (c.type == EntityChange::Add)
+		{
+			entities.insert(c.entity);
+			c.entity->getStorage().publishId(c.entity->getId());
+			c.entity->updateModelReference();
+		}
+		else if (c.type == EntityChange::Delete)
 		{
 			entities.erase(c.entity);
 			delete c.entity;
 		}
 	}
-	changes.clear();
 }
 
 void RenderWorld::updateTransformations()
@@ -232,7 +265,10 @@ RenderObjectsStorage* RenderWorld::getRenderables(Order order)
 
 void RenderWorld::clear()
 {
-	changes.emplace_back(EntityChange::DeleteAll);
+	// apply pending changes first so all created entities are known
+	updateQueues();
+
+	pendingChanges.push({ EntityChange::DeleteAll });
 
 	for (auto entity : entities)
 	{
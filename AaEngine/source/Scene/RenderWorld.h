@@ -8,6 +8,8 @@
 #include "RenderObject/Vegetation/Vegetation.h"
 #include "RenderObject/Grass/Grass.h"
 #include "Scene/SceneGraph.h"
+#include "Utils/MpscQueue.h"
+#include <deque>
 #include <unordered_map>
 
 struct SceneObject
@@ -47,9 +49,14 @@ public:
 	void update();
 	void clear();
 
+	// create and remove can be called from any thread, changes are applied in next update
 	RenderEntity* createEntity(EntityCreateProperties props = {});
 	RenderEntity* createEntity(const ObjectTransformation&, VertexBufferModel&, EntityCreateProperties = {});
 
+	// entity is not added until commit, worker threads finish its setup before committing
+	RenderEntity* prepareEntity(EntityCreateProperties props = {});
+	void commitEntity(RenderEntity* entity, int suborder = 0);
+
 	void removeEntity(RenderEntity* entity);
 	void removeEntity(ObjectId id);
 
@@ -81,9 +88,11 @@ private:
 	void updateQueues();
 	void updateTransformations();
 
-	std::vector<RenderObjectsStorage> renderables;
+	std::deque<RenderObjectsStorage> renderables;
 	Order getOrder(RenderEntity* entity);
 
+	MpscQueue<EntityChangeDescritpion> pendingChanges;
+	// batch taken from pendingChanges in updateQueues
 	std::vector<EntityChangeDescritpion> changes;
 
 	std::set<RenderEntity*> entities;
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts global operator new calls, used to verify steady state frames do not touch the heap
+namespace AllocationTracker
+{
+	uint64_t getAllocationsCount();
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Array growing by chunks of doubling size, elements are never moved so other threads can keep accessing them while it grows
+template<typename T>
+class ChunkedArray
+{
+public:
+
+	// size of first chunk, every next one is twice as big
+	static constexpr size_t BaseSize = 64;
+
+	T& operator[](size_t i)
+	{
+		auto [chunk, offset] = locate(i);
+		return chunks[chunk][offset];
+	}
+	const T& operator[](size_t i) const
+	{
+		auto [chunk, offset] = locate(i);
+		return chunks[chunk][offset];
+	}
+
+	// allocates chunks to fit count elements, callers synchronize growing
+	void reserve(size_t count)
+	{
+		while (capacity() < count)
+		{
+			chunks[allocatedChunks] = std::make_unique<T[]>(BaseSize << allocatedChunks);
+			allocatedChunks++;
+		}
+	}
+
+	size_t capacity() const
+	{
+		return BaseSize * ((size_t(1) << allocatedChunks) - 1);
+	}
+
+	// elements from i until end of its chunk are contiguous in memory
+	size_t contiguousCount(size_t i) const
+	{
+		auto [chunk, offset] = locate(i);
+		return (BaseSize << chunk) - offset;
+	}
+
+private:
+
+	static std::pair<size_t, size_t> locate(size_t i)
+	{
+		size_t chunk = std::bit_width(i / BaseSize + 1) - 1;
+		return { chunk, i - BaseSize * ((size_t(1) << chunk) - 1) };
+	}
+
+	std::array<std::unique_ptr<T[]>, 32> chunks;
+	size_t allocatedChunks{};
+};
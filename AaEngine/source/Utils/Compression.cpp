@@ -0,0 +1,168 @@
+#include "Utils/Compression.h"
+#include <cstring>
+
+constexpr size_t MinMatch = 4;
+constexpr size_t LastLiterals = 5;
+constexpr size_t MatchFindLimit = 12;
+constexpr size_t MaxOffset = 65535;
+constexpr uint32_t HashBits = 12;
+constexpr uint32_t NoPosition = UINT32_MAX;
+
+static uint32_t Read32(const uint8_t* p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static uint32_t HashSequence(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+static void WriteLength(std::vector<uint8_t>& out, size_t length)
+{
+	while (length >= 255)
+	{
+		out.push_back(255);
+		length -= 255;
+	}
+	out.push_back((uint8_t)length);
+}
+
+static void WriteSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalsCount, size_t offset, size_t matchLength)
+{
+	const size_t matchCode = matchLength ? matchLength - MinMatch : 0;
+
+	out.push_back(uint8_t((literalsCount >= 15 ? 15 : literalsCount) << 4 | (matchCode >= 15 ? 15 : matchCode)));
+
+	if (literalsCount >= 15)
+		WriteLength(out, literalsCount - 15);
+
+	out.insert(out.end(), literals, literals + literalsCount);
+
+	if (!matchLength)
+		return;
+
+	out.push_back(uint8_t(offset));
+	out.push_back(uint8_t(offset >> 8));
+
+	if (matchCode >= 15)
+		WriteLength(out, matchCode - 15);
+}
+
+std::vector<uint8_t> Compression::compressLz4(std::span<const uint8_t> input)
+{
+	const auto data = input.data();
+	const size_t size = input.size();
+
+	std::vector<uint8_t> out;
+	out.reserve(size + size / 255 + 16);
+
+	size_t anchor = 0;
+
+	if (size > MatchFindLimit)
+	{
+		std::vector<uint32_t> table(size_t(1) << HashBits, NoPosition);
+		const size_t matchLimit = size - LastLiterals;
+		const size_t searchLimit = size - MatchFindLimit;
+
+		size_t pos = 0;
+		while (pos < searchLimit)
+		{
+			const uint32_t sequence = Read32(data + pos);
+			auto& entry = table[HashSequence(sequence)];
+			const uint32_t candidate = entry;
+			entry = (uint32_t)pos;
+
+			if (candidate == NoPosition || pos - candidate > MaxOffset || Read32(data + candidate) != sequence)
+			{
+				pos++;
+				continue;
+			}
+
+			size_t length = MinMatch;
+			while (pos + length < matchLimit && data[candidate + length] == data[pos + length])
+				length++;
+
+			WriteSequence(out, data + anchor, pos - anchor, pos - candidate, length);
+
+			pos += length;
+			anchor = pos;
+		}
+	}
+
+	WriteSequence(out, data + anchor, size - anchor, 0, 0);
+
+	return out;
+}
+
+static bool ReadLength(const uint8_t*& in, const uint8_t* inEnd, size_t& length)
+{
+	uint8_t value;
+	do
+	{
+		if (in >= inEnd)
+			return false;
+
+		value = *in++;
+		length += value;
+	}
+	while (value == 255);
+
+	return true;
+}
+
+bool Compression::decompressLz4(std::span<const uint8_t> input, std::span<uint8_t> output)
+{
+	const uint8_t* in = input.data();
+	const uint8_t* inEnd = in + input.size();
+	uint8_t* out = output.data();
+	uint8_t* outEnd = out + output.size();
+
+	while (in < inEnd)
+	{
+		const uint8_t token = *in++;
+
+		size_t literals = token >> 4;
+		if (literals == 15 && !ReadLength(in, inEnd, literals))
+			return false;
+
+		if (literals > size_t(inEnd - in) || literals > size_t(outEnd - out))
+			return false;
+
+		if (literals)
+			memcpy(out, in, literals);
+		in += literals;
+		out += literals;
+
+		// last sequence has only literals
+		if (in == inEnd)
+			break;
+
+		if (inEnd - in < 2)
+			return false;
+
+		const size_t offset = in[0] | (in[1] << 8);
+		in += 2;
+
+		if (!offset || offset > size_t(out - output.data()))
+			return false;
+
+		size_t length = token & 15;
+		if (length == 15 && !ReadLength(in, inEnd, length))
+			return false;
+		length += MinMatch;
+
+		if (length > size_t(outEnd - out))
+			return false;
+
+		// overlapping copy when offset is smaller than length
+		const uint8_t* match = out - offset;
+		for (size_t i = 0; i < length; i++)
+			out[i] = match[i];
+		out += length;
+	}
+
+	return out == outEnd;
+}
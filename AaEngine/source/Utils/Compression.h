@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+// LZ4 block format (no frame header), fast to decompress at load time
+namespace Compression
+{
+	std::vector<uint8_t> compressLz4(std::span<const uint8_t> input);
+
+	// output has to be sized to exact uncompressed size
+	bool decompressLz4(std::span<const uint8_t> input, std::span<uint8_t> output);
+}
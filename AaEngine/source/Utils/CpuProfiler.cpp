@@ -0,0 +1,163 @@
+#include "Utils/CpuProfiler.h"
+#include "Utils/Logger.h"
+#include <chrono>
+#include <format>
+#include <fstream>
+
+CpuProfiler& CpuProfiler::Get()
+{
+	// never destroyed, threads exiting during static destruction still return their buffers
+	static CpuProfiler* instance = new CpuProfiler();
+	return *instance;
+}
+
+CpuProfiler::Zone::Zone(const char* n) : name(n)
+{
+	start = CpuProfiler::Get().isCapturing() ? Now() : 0;
+}
+
+CpuProfiler::Zone::~Zone()
+{
+	if (!start)
+		return;
+
+	auto& profiler = CpuProfiler::Get();
+	if (profiler.isCapturing())
+		profiler.threadBuffer().push({ name, start, Now() });
+}
+
+void CpuProfiler::beginCapture()
+{
+	captureStart = Now();
+	captureEnd = 0;
+	capturing = true;
+}
+
+void CpuProfiler::endCapture()
+{
+	capturing = false;
+	captureEnd = Now();
+}
+
+bool CpuProfiler::isCapturing() const
+{
+	return capturing.load(std::memory_order_relaxed);
+}
+
+const char* CpuProfiler::intern(const std::string& name)
+{
+	std::lock_guard lock(mutex);
+	return names.insert(name).first->c_str();
+}
+
+void CpuProfiler::setThreadName(const std::string& name)
+{
+	auto& buffer = threadBuffer();
+
+	std::lock_guard lock(mutex);
+	buffer.threadName = name;
+}
+
+void CpuProfiler::addTrackEvent(const std::string& track, const char* name, uint64_t start, uint64_t end)
+{
+	if (!isCapturing())
+		return;
+
+	ThreadBuffer* buffer{};
+	{
+		std::lock_guard lock(mutex);
+
+		auto& trackBuffer = tracks[track];
+		if (!trackBuffer)
+		{
+			trackBuffer = &buffers.create();
+			trackBuffer->threadName = track;
+		}
+		buffer = trackBuffer;
+	}
+
+	buffer->push({ name, start, end });
+}
+
+uint64_t CpuProfiler::Now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void CpuProfiler::ThreadBuffer::push(const Event& e)
+{
+	auto idx = written.load(std::memory_order_relaxed);
+	events[idx % Capacity] = e;
+	written.store(idx + 1, std::memory_order_release);
+}
+
+CpuProfiler::ThreadBuffer& CpuProfiler::threadBuffer()
+{
+	return buffers.local([](ThreadBuffer& buffer)
+		{
+			// events of previous thread are dropped with its name
+			buffer.written = 0;
+			buffer.threadName.clear();
+		});
+}
+
+static std::string escapeJson(const char* text)
+{
+	std::string out;
+	for (; *text; text++)
+	{
+		if (*text == '"' || *text == '\\')
+			out += '\\';
+		out += *text;
+	}
+	return out;
+}
+
+bool CpuProfiler::exportChromeTrace(const std::string& file) const
+{
+	std::ofstream out(file);
+	if (!out)
+	{
+		Logger::logError("Failed to write cpu trace " + file);
+		return false;
+	}
+
+	const uint64_t start = captureStart;
+	const uint64_t end = capturing ? Now() : captureEnd.load();
+
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+	size_t eventsCount = 0;
+	auto separator = [&]() { return eventsCount++ ? ",\n" : ""; };
+
+	std::lock_guard lock(mutex);
+
+	buffers.forEach([&](size_t index, const ThreadBuffer& buffer)
+		{
+			const auto threadId = index + 1;
+
+			if (!buffer.threadName.empty())
+				out << separator() << std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}", threadId, escapeJson(buffer.threadName.c_str()));
+
+			const uint64_t written = buffer.written.load(std::memory_order_acquire);
+			// keep distance from slots owner thread may be overwriting
+			const uint64_t margin = 64;
+			const uint64_t first = written + margin > ThreadBuffer::Capacity ? written + margin - ThreadBuffer::Capacity : 0;
+
+			for (uint64_t i = first; i < written; i++)
+			{
+				auto& e = buffer.events[i % ThreadBuffer::Capacity];
+				if (e.start < start || e.end > end)
+					continue;
+
+				out << separator() << std::format("{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+					escapeJson(e.name), threadId, (e.start - start) / 1000.0, (e.end - e.start) / 1000.0);
+			}
+		});
+
+	out << "\n]}\n";
+
+	Logger::log(std::format("Cpu trace {} written, {} events", file, eventsCount));
+
+	return true;
+}
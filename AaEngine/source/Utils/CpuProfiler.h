@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Utils/ThreadLocalPool.h"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+// Scoped CPU timing zones recorded into per thread ring buffers, exported as Chrome trace json
+class CpuProfiler
+{
+public:
+
+	static CpuProfiler& Get();
+
+	// records time between construction and destruction while capture is running
+	class Zone
+	{
+	public:
+
+		// name has to stay valid until export, use intern for dynamic names
+		Zone(const char* name);
+		~Zone();
+
+	private:
+
+		const char* name;
+		uint64_t start;
+	};
+
+	void beginCapture();
+	void endCapture();
+	bool isCapturing() const;
+
+	// stable copy of name usable for zones
+	const char* intern(const std::string& name);
+
+	void setThreadName(const std::string& name);
+
+	// events timed elsewhere like gpu work, shown as named track. Each track is written from single thread
+	void addTrackEvent(const std::string& track, const char* name, uint64_t start, uint64_t end);
+
+	// open in ui.perfetto.dev or chrome://tracing
+	bool exportChromeTrace(const std::string& file) const;
+
+	// nanoseconds
+	static uint64_t Now();
+
+private:
+
+	struct Event
+	{
+		const char* name;
+		uint64_t start;
+		uint64_t end;
+	};
+
+	// written only by owning thread, oldest events are overwritten when full
+	struct ThreadBuffer
+	{
+		static constexpr size_t Capacity = 1 << 16;
+
+		std::unique_ptr<Event[]> events = std::make_unique<Event[]>(Capacity);
+		std::atomic<uint64_t> written = 0;
+
+		std::string threadName;
+
+		void push(const Event&);
+	};
+	ThreadBuffer& threadBuffer();
+
+	CpuProfiler() = default;
+
+	std::atomic<bool> capturing = false;
+	std::atomic<uint64_t> captureStart = 0;
+	std::atomic<uint64_t> captureEnd = 0;
+
+	mutable std::mutex mutex;
+	std::set<std::string> names;
+	std::map<std::string, ThreadBuffer*> tracks;
+
+	// buffer index is trace thread id
+	ThreadLocalPool<ThreadBuffer> buffers;
+};
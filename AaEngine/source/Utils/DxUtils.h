@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Directx.h"
+#include <dxgiformat.h>
 #include <string>
 
 DXGI_FORMAT StringToDxgiFormat(const std::string& str);
@@ -0,0 +1,76 @@
+#include "Utils/FrameArena.h"
+#include <algorithm>
+#include <atomic>
+
+static std::atomic<uint64_t> currentFrame = 0;
+static std::atomic<uint64_t> heapAllocations = 0;
+
+static std::unique_ptr<std::byte[]> AllocateBlock(size_t size)
+{
+	heapAllocations.fetch_add(1, std::memory_order_relaxed);
+	return std::unique_ptr<std::byte[]>(new std::byte[size]);
+}
+
+FrameArena& FrameArena::Get()
+{
+	static thread_local FrameArena arena;
+	return arena;
+}
+
+void FrameArena::NextFrame()
+{
+	currentFrame.fetch_add(1, std::memory_order_relaxed);
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment)
+{
+	// previous frame block is kept, older one is reused
+	if (auto f = currentFrame.load(std::memory_order_relaxed); f != frame)
+	{
+		frame = f;
+		current ^= 1;
+		blocks[current].reset();
+	}
+
+	auto& block = blocks[current];
+	if (!block.memory)
+	{
+		block.size = InitialBlockSize;
+		block.memory = AllocateBlock(block.size);
+	}
+
+	auto base = reinterpret_cast<uintptr_t>(block.memory.get());
+	auto aligned = (base + block.used + alignment - 1) & ~(uintptr_t(alignment) - 1);
+
+	if (aligned + bytes <= base + block.size)
+	{
+		block.used = aligned + bytes - base;
+		return reinterpret_cast<void*>(aligned);
+	}
+
+	auto& overflow = block.overflow.emplace_back(AllocateBlock(bytes + alignment));
+	block.overflowBytes += bytes + alignment;
+
+	base = reinterpret_cast<uintptr_t>(overflow.get());
+	return reinterpret_cast<void*>((base + alignment - 1) & ~(uintptr_t(alignment) - 1));
+}
+
+uint64_t FrameArena::GetHeapAllocationsCount()
+{
+	return heapAllocations.load(std::memory_order_relaxed);
+}
+
+void FrameArena::Block::reset()
+{
+	// grow to fit whole last use of this block
+	if (overflowBytes)
+	{
+		size = std::max(size * 2, used + overflowBytes);
+		memory = AllocateBlock(size);
+
+		overflow.clear();
+		overflowBytes = 0;
+	}
+
+	used = 0;
+}
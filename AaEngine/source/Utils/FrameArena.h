@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Linear per thread memory for transient frame data, two blocks are swapped so allocations stay valid until end of next frame
+class FrameArena
+{
+public:
+
+	// arena of calling thread
+	static FrameArena& Get();
+
+	// called once per frame from main thread, arenas switch blocks on their next allocation
+	static void NextFrame();
+
+	void* allocate(size_t bytes, size_t alignment);
+
+	// heap allocations done by arenas when growing, zero in steady state
+	static uint64_t GetHeapAllocationsCount();
+
+private:
+
+	static constexpr size_t InitialBlockSize = 256 * 1024;
+
+	struct Block
+	{
+		std::unique_ptr<std::byte[]> memory;
+		size_t size{};
+		size_t used{};
+
+		// filled when block is full, merged into bigger block on reset
+		std::vector<std::unique_ptr<std::byte[]>> overflow;
+		size_t overflowBytes{};
+
+		void reset();
+	};
+	Block blocks[2];
+	uint32_t current{};
+	uint64_t frame{};
+};
+
+// STL allocator taking memory from FrameArena of allocating thread, deallocation is no-op
+template<typename T>
+struct FrameAllocator
+{
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using is_always_equal = std::true_type;
+
+	FrameAllocator() = default;
+	template<typename U> FrameAllocator(const FrameAllocator<U>&) {}
+
+	T* allocate(size_t n)
+	{
+		return static_cast<T*>(FrameArena::Get().allocate(n * sizeof(T), alignof(T)));
+	}
+	void deallocate(T*, size_t) {}
+
+	template<typename U> bool operator==(const FrameAllocator<U>&) const { return true; }
+};
+
+// has to be discarded within next frame, assign into new vector instead of reusing old capacity
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
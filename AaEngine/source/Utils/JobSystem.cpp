@@ -0,0 +1,240 @@
+#include "Utils/JobSystem.h"
+#include "Utils/CpuProfiler.h"
+#include <algorithm>
+
+static thread_local const JobSystem* workerSystem{};
+static thread_local int workerIndex = -1;
+
+JobSystem::JobSystem(unsigned int workersCount, const char* name)
+{
+	// main thread helps while waiting
+	if (!workersCount)
+		workersCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+	for (unsigned int i = 0; i <= workersCount; i++)
+		queues.push_back(std::make_unique<WorkQueue>());
+
+	for (unsigned int i = 0; i < workersCount; i++)
+		workers.emplace_back(&JobSystem::workerLoop, this, int(i), name + (" " + std::to_string(i)));
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard lock(sleepMutex);
+		stopWorkers = true;
+	}
+	jobsCondition.notify_all();
+
+	for (auto& w : workers)
+		w.join();
+}
+
+JobSystem& JobSystem::Get()
+{
+	static JobSystem instance;
+	return instance;
+}
+
+JobSystem& JobSystem::GetIo()
+{
+	static JobSystem instance(std::clamp(std::thread::hardware_concurrency() / 4, 1u, 4u), "IO worker");
+	return instance;
+}
+
+JobSystem::Handle JobSystem::submit(std::function<void()> func)
+{
+	return submit(std::move(func), {});
+}
+
+JobSystem::Handle JobSystem::submit(std::function<void()> func, std::span<const Handle> dependencies)
+{
+	Handle handle;
+	handle.job = std::make_shared<Job>();
+	handle.job->func = std::move(func);
+
+	for (auto& dependency : dependencies)
+	{
+		if (!dependency.job)
+			continue;
+
+		std::lock_guard lock(dependency.job->continuationsMutex);
+		if (!dependency.job->finished.load(std::memory_order_relaxed))
+		{
+			handle.job->pendingDependencies++;
+			dependency.job->continuations.push_back(handle.job);
+		}
+	}
+
+	dependencyFinished(handle.job);
+
+	return handle;
+}
+
+void JobSystem::wait(const Handle& job)
+{
+	const Handle* waitJobs[] = { &job };
+	waitAny(waitJobs);
+}
+
+size_t JobSystem::waitAny(std::span<const Handle* const> waitJobs)
+{
+	auto findFinished = [&]()
+		{
+			for (size_t i = 0; i < waitJobs.size(); i++)
+				if (waitJobs[i]->done())
+					return i;
+
+			return waitJobs.size();
+		};
+
+	while (true)
+	{
+		if (auto idx = findFinished(); idx < waitJobs.size())
+			return idx;
+
+		if (runPending())
+			continue;
+
+		std::unique_lock lock(sleepMutex);
+		finishedCondition.wait(lock, [&] { return findFinished() < waitJobs.size() || queuedJobs > 0; });
+	}
+}
+
+unsigned int JobSystem::getWorkersCount() const
+{
+	return (unsigned int)workers.size();
+}
+
+void JobSystem::enqueue(std::shared_ptr<Job> job)
+{
+	auto& queue = *queues[currentWorkerIdx()];
+	{
+		std::lock_guard lock(queue.mutex);
+		queue.jobs.push_back(std::move(job));
+	}
+	queuedJobs++;
+
+	{
+		// lock so sleeping thread cant miss notification between check and wait
+		std::lock_guard lock(sleepMutex);
+	}
+	jobsCondition.notify_one();
+	// waiting threads can pick it up too
+	finishedCondition.notify_all();
+}
+
+void JobSystem::dependencyFinished(std::shared_ptr<Job> job)
+{
+	if (--job->pendingDependencies == 0)
+		enqueue(std::move(job));
+}
+
+std::shared_ptr<JobSystem::Job> JobSystem::findJob(int workerIdx)
+{
+	if (queuedJobs.load(std::memory_order_relaxed) <= 0)
+		return {};
+
+	std::shared_ptr<Job> job;
+	auto pop = [&](WorkQueue& queue, bool own)
+		{
+			std::lock_guard lock(queue.mutex);
+			if (queue.jobs.empty())
+				return false;
+
+			if (own)
+			{
+				job = std::move(queue.jobs.back());
+				queue.jobs.pop_back();
+			}
+			else
+			{
+				job = std::move(queue.jobs.front());
+				queue.jobs.pop_front();
+			}
+			return true;
+		};
+
+	const int queuesCount = int(queues.size());
+	const int sharedIdx = queuesCount - 1;
+
+	bool found = pop(*queues[workerIdx], workerIdx != sharedIdx);
+
+	// then jobs from outside, then steal from neighbours
+	if (!found && workerIdx != sharedIdx)
+		found = pop(*queues[sharedIdx], false);
+
+	for (int i = 1; !found && i < queuesCount; i++)
+	{
+		int idx = (workerIdx + i) % queuesCount;
+		if (idx != sharedIdx)
+			found = pop(*queues[idx], false);
+	}
+
+	if (found)
+		queuedJobs--;
+
+	return job;
+}
+
+bool JobSystem::runPending()
+{
+	auto job = findJob(currentWorkerIdx());
+	if (!job)
+		return false;
+
+	run(job);
+	return true;
+}
+
+void JobSystem::run(const std::shared_ptr<Job>& job)
+{
+	job->func();
+	job->func = nullptr;
+
+	std::vector<std::shared_ptr<Job>> continuations;
+	{
+		std::lock_guard lock(job->continuationsMutex);
+		job->finished.store(true, std::memory_order_release);
+		continuations.swap(job->continuations);
+	}
+
+	for (auto& c : continuations)
+		dependencyFinished(std::move(c));
+
+	{
+		std::lock_guard lock(sleepMutex);
+	}
+	finishedCondition.notify_all();
+}
+
+void JobSystem::workerLoop(int workerIdx, std::string name)
+{
+	workerSystem = this;
+	workerIndex = workerIdx;
+
+	CpuProfiler::Get().setThreadName(name);
+
+	while (true)
+	{
+		if (auto job = findJob(workerIdx))
+		{
+			run(job);
+			continue;
+		}
+
+		std::unique_lock lock(sleepMutex);
+		jobsCondition.wait(lock, [this] { return stopWorkers || queuedJobs > 0; });
+
+		if (stopWorkers)
+			return;
+	}
+}
+
+int JobSystem::currentWorkerIdx() const
+{
+	if (workerSystem == this)
+		return workerIndex;
+
+	return int(queues.size()) - 1;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <span>
+#include <string>
+
+// Shared work stealing worker threads for short jobs, threads waiting for a job help with queued work
+class JobSystem
+{
+	struct Job;
+
+public:
+
+	JobSystem(unsigned int workersCount = 0, const char* name = "Job worker");
+	~JobSystem();
+
+	static JobSystem& Get();
+	// few workers for blocking file reads, so they dont stall frame jobs
+	static JobSystem& GetIo();
+
+	class Handle
+	{
+	public:
+
+		// empty handle counts as finished
+		bool done() const { return !job || job->finished.load(std::memory_order_acquire); }
+
+	private:
+
+		friend class JobSystem;
+		std::shared_ptr<Job> job;
+	};
+
+	Handle submit(std::function<void()> job);
+	// job is queued only after all dependencies finished
+	Handle submit(std::function<void()> job, std::span<const Handle> dependencies);
+
+	void wait(const Handle& job);
+	// returns index of first finished job
+	size_t waitAny(std::span<const Handle* const> jobs);
+
+	unsigned int getWorkersCount() const;
+
+private:
+
+	struct Job
+	{
+		std::function<void()> func;
+
+		// dependencies left + 1 while submitting
+		std::atomic<int> pendingDependencies = 1;
+		std::atomic<bool> finished = false;
+
+		std::mutex continuationsMutex;
+		std::vector<std::shared_ptr<Job>> continuations;
+	};
+
+	// worker pushes and pops own jobs from back, others steal from front
+	struct WorkQueue
+	{
+		std::mutex mutex;
+		std::deque<std::shared_ptr<Job>> jobs;
+	};
+
+	void enqueue(std::shared_ptr<Job> job);
+	void dependencyFinished(std::shared_ptr<Job> job);
+	std::shared_ptr<Job> findJob(int workerIdx);
+	bool runPending();
+	void run(const std::shared_ptr<Job>& job);
+	void workerLoop(int workerIdx, std::string name);
+
+	int currentWorkerIdx() const;
+
+	// last queue is for jobs submitted from outside of workers
+	std::vector<std::unique_ptr<WorkQueue>> queues;
+	std::atomic<int> queuedJobs = 0;
+
+	std::mutex sleepMutex;
+	std::condition_variable jobsCondition;
+	std::condition_variable finishedCondition;
+	bool stopWorkers = false;
+
+	std::vector<std::thread> workers;
+};
@@ -6,6 +6,7 @@
 #include <vector>
 #include <windows.h>
 #include <filesystem>
+#include <mutex>
 
 class Logger
 {
@@ -82,6 +83,8 @@ public:
 			severityInfo += "[WARNING] ";
 
 		auto instance = get();
+		std::lock_guard lock(instance->logMutex);
+
 		instance->myfile << timeString << ": " << severityInfo << text << std::endl;
 
 		auto& history = instance->logHistory;
@@ -90,9 +93,13 @@ public:
 			history.erase(history.begin());
 	}
 
-	static const std::vector<LogEntry>& getHistory()
+	// copy, history is appended from worker threads while drawn
+	static std::vector<LogEntry> getHistory()
 	{
-		return get()->logHistory;
+		auto instance = get();
+		std::lock_guard lock(instance->logMutex);
+
+		return instance->logHistory;
 	}
 
 private:
@@ -126,4 +133,7 @@ private:
 
 	std::ofstream myfile;
 	std::vector<LogEntry> logHistory;
+
+	// resources are loaded also from worker threads
+	std::mutex logMutex;
 };
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <span>
+#include <cstdint>
+
+// Read-only memory mapped file, data stays valid until closed
+class MappedFile
+{
+public:
+
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& path);
+	void close();
+
+	std::span<const uint8_t> data() const;
+
+private:
+
+	void* file{};
+	void* mapping{};
+	const uint8_t* view{};
+	size_t size{};
+};
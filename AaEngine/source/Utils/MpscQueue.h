@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+// Lock-free queue with many producer threads and single consumer taking all pushed items at once
+template<typename T>
+class MpscQueue
+{
+public:
+
+	MpscQueue() = default;
+	MpscQueue(const MpscQueue&) = delete;
+
+	~MpscQueue()
+	{
+		consume([](T&&) {});
+	}
+
+	void push(T value)
+	{
+		auto node = new Node{ std::move(value), head.load(std::memory_order_relaxed) };
+
+		while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	// calls func for every item in push order, only from consumer thread
+	template<typename Func>
+	void consume(Func&& func)
+	{
+		auto node = head.exchange(nullptr, std::memory_order_acquire);
+
+		// pushed as stack, reverse to push order
+		Node* ordered{};
+		while (node)
+		{
+			auto next = node->next;
+			node->next = ordered;
+			ordered = node;
+			node = next;
+		}
+
+		while (ordered)
+		{
+			auto next = ordered->next;
+			func(std::move(ordered->value));
+			delete ordered;
+			ordered = next;
+		}
+	}
+
+	bool empty() const
+	{
+		return head.load(std::memory_order_relaxed) == nullptr;
+	}
+
+private:
+
+	struct Node
+	{
+		T value;
+		Node* next;
+	};
+
+	std::atomic<Node*> head{};
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Utils/JobSystem.h"
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+// Calls func(index) for every index in 0..count on job system workers, returns when all are done
+template<typename Func>
+void ParallelFor(size_t count, Func&& func, size_t maxThreads = JobSystem::Get().getWorkersCount() + 1)
+{
+	const size_t threadsCount = std::min(count, std::max<size_t>(maxThreads, 1));
+
+	if (threadsCount <= 1)
+	{
+		for (size_t i = 0; i < count; i++)
+			func(i);
+
+		return;
+	}
+
+	// items are taken one by one, their cost can differ a lot
+	std::atomic<size_t> next = 0;
+	auto worker = [&]()
+		{
+			for (size_t i = next++; i < count; i = next++)
+				func(i);
+		};
+
+	auto& jobs = JobSystem::Get();
+
+	std::vector<JobSystem::Handle> handles;
+	handles.reserve(threadsCount - 1);
+	for (size_t t = 1; t < threadsCount; t++)
+		handles.push_back(jobs.submit(worker));
+
+	worker();
+
+	// jobs not picked up yet are run here while waiting
+	for (auto& h : handles)
+		jobs.wait(h);
+}
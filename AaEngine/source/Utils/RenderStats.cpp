@@ -0,0 +1,113 @@
+#include "Utils/RenderStats.h"
+#include "Utils/Logger.h"
+#include "Utils/AllocationTracker.h"
+#include "Utils/FrameArena.h"
+
+RenderStats& RenderStats::Get()
+{
+	// never destroyed, threads exiting during static destruction still return their counters
+	static RenderStats* instance = new RenderStats();
+	return *instance;
+}
+
+void RenderStats::Add(RenderStat stat, uint64_t value)
+{
+	auto& v = Get().counters.local().values[size_t(stat)];
+	v.store(v.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void RenderStats::endFrame()
+{
+	std::lock_guard lock(mutex);
+
+	std::array<uint64_t, StatsCount> totals{};
+	counters.forEach([&](size_t, const ThreadCounters& c)
+		{
+			for (size_t i = 0; i < StatsCount; i++)
+				totals[i] += c.values[i].load(std::memory_order_relaxed);
+		});
+
+	totals[size_t(RenderStat::HeapAllocations)] = AllocationTracker::getAllocationsCount();
+	totals[size_t(RenderStat::FrameArenaGrowth)] = FrameArena::GetHeapAllocationsCount();
+
+	for (size_t i = 0; i < StatsCount; i++)
+	{
+		frameValues[i].store(totals[i] - previousTotals[i], std::memory_order_relaxed);
+		previousTotals[i] = totals[i];
+	}
+
+	if (csv.is_open())
+	{
+		csv << csvFrame++;
+		for (auto& v : frameValues)
+			csv << ',' << v.load(std::memory_order_relaxed);
+		csv << '\n';
+	}
+}
+
+uint64_t RenderStats::get(RenderStat stat) const
+{
+	return frameValues[size_t(stat)].load(std::memory_order_relaxed);
+}
+
+const char* RenderStats::GetName(RenderStat stat)
+{
+	switch (stat)
+	{
+	case RenderStat::DrawCalls: return "Draw calls";
+	case RenderStat::Instances: return "Instances";
+	case RenderStat::Triangles: return "Triangles";
+	case RenderStat::PipelineChanges: return "Pipeline changes";
+	case RenderStat::RootSignatureBinds: return "Root signature binds";
+	case RenderStat::TextureBinds: return "Texture binds";
+	case RenderStat::ConstantBinds: return "Constant binds";
+	case RenderStat::VisibleObjects: return "Visible objects";
+	case RenderStat::CulledObjects: return "Culled objects";
+	case RenderStat::CompositorPasses: return "Compositor passes";
+	case RenderStat::Barriers: return "Barriers";
+	case RenderStat::CommandListsExecuted: return "Command lists executed";
+	case RenderStat::DescriptorWrites: return "Descriptor writes";
+	case RenderStat::UploadedTextures: return "Uploaded textures";
+	case RenderStat::UploadedModels: return "Uploaded models";
+	case RenderStat::UploadBytes: return "Upload bytes";
+	case RenderStat::HeapAllocations: return "Heap allocations";
+	case RenderStat::FrameArenaGrowth: return "Frame arena growth";
+	default: return "";
+	}
+}
+
+bool RenderStats::beginCsv(const std::string& file)
+{
+	std::lock_guard lock(mutex);
+
+	csv = std::ofstream(file);
+	if (!csv)
+	{
+		Logger::logError("Failed to write render stats " + file);
+		return false;
+	}
+
+	csvFrame = 0;
+	csv << "Frame";
+	for (size_t i = 0; i < StatsCount; i++)
+		csv << ',' << GetName(RenderStat(i));
+	csv << '\n';
+
+	return true;
+}
+
+void RenderStats::endCsv()
+{
+	std::lock_guard lock(mutex);
+
+	if (csv.is_open())
+	{
+		csv.close();
+		Logger::log("Render stats csv written, " + std::to_string(csvFrame) + " frames");
+	}
+}
+
+bool RenderStats::isWritingCsv() const
+{
+	return csv.is_open();
+}
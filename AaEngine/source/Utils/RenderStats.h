@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Utils/ThreadLocalPool.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class RenderStat
+{
+	DrawCalls,
+	Instances,
+	Triangles,
+	PipelineChanges,
+	RootSignatureBinds,
+	TextureBinds,
+	ConstantBinds,
+	VisibleObjects,
+	CulledObjects,
+	CompositorPasses,
+	Barriers,
+	CommandListsExecuted,
+	DescriptorWrites,
+	UploadedTextures,
+	UploadedModels,
+	UploadBytes,
+	HeapAllocations,
+	FrameArenaGrowth,
+	Count
+};
+
+// Per frame counters, incremented per thread without locking and summed at frame end
+class RenderStats
+{
+public:
+
+	static RenderStats& Get();
+
+	static void Add(RenderStat stat, uint64_t value = 1);
+
+	// collects counts since previous call as last frame results
+	void endFrame();
+
+	// last finished frame
+	uint64_t get(RenderStat stat) const;
+
+	static const char* GetName(RenderStat stat);
+
+	// appends row of every following frame
+	bool beginCsv(const std::string& file);
+	void endCsv();
+	bool isWritingCsv() const;
+
+private:
+
+	static constexpr size_t StatsCount = size_t(RenderStat::Count);
+
+	// running totals written only by owning thread
+	struct ThreadCounters
+	{
+		std::array<std::atomic<uint64_t>, StatsCount> values{};
+	};
+	// counters of exited threads are reused, totals keep accumulating
+	ThreadLocalPool<ThreadCounters> counters;
+
+	RenderStats() = default;
+
+	std::mutex mutex;
+
+	std::array<uint64_t, StatsCount> previousTotals{};
+	std::array<std::atomic<uint64_t>, StatsCount> frameValues{};
+
+	std::ofstream csv;
+	uint64_t csvFrame{};
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Objects owned by threads, returned to pool when owning thread exits and reused by next new thread.
+// Single pool per object type, it has to outlive every thread using it
+template<typename T>
+class ThreadLocalPool
+{
+public:
+
+	ThreadLocalPool() = default;
+	ThreadLocalPool(const ThreadLocalPool&) = delete;
+
+	// object of calling thread, reused object of exited thread is passed to reset under pool lock
+	template<typename Reset>
+	T& local(Reset&& reset)
+	{
+		auto& owner = threadOwner();
+
+		if (!owner.object)
+		{
+			std::lock_guard lock(mutex);
+
+			if (!freeObjects.empty())
+			{
+				owner.object = freeObjects.back();
+				freeObjects.pop_back();
+				reset(*owner.object);
+			}
+			else
+				owner.object = objects.emplace_back(std::make_unique<T>()).get();
+
+			owner.pool = this;
+		}
+
+		return *owner.object;
+	}
+
+	T& local()
+	{
+		return local([](T&) {});
+	}
+
+	// object not owned by any thread, never reused
+	T& create()
+	{
+		std::lock_guard lock(mutex);
+		return *objects.emplace_back(std::make_unique<T>());
+	}
+
+	// calls func(index, object) for all objects in creation order under pool lock, including free ones
+	template<typename Func>
+	void forEach(Func&& func) const
+	{
+		std::lock_guard lock(mutex);
+
+		for (size_t i = 0; i < objects.size(); i++)
+			func(i, *objects[i]);
+	}
+
+private:
+
+	struct Owner
+	{
+		ThreadLocalPool* pool{};
+		T* object{};
+
+		~Owner()
+		{
+			if (!object)
+				return;
+
+			std::lock_guard lock(pool->mutex);
+			pool->freeObjects.push_back(object);
+		}
+	};
+
+	static Owner& threadOwner()
+	{
+		static thread_local Owner owner;
+		return owner;
+	}
+
+	mutable std::mutex mutex;
+	std::vector<std::unique_ptr<T>> objects;
+	std::vector<T*> freeObjects;
+};
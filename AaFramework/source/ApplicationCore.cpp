@@ -1,5 +1,8 @@
 #include "ApplicationCore.h"
 #include "Utils/Logger.h"
+#include "Utils/CpuProfiler.h"
+#include "Utils/RenderStats.h"
+#include "Utils/FrameArena.h"
 #include "App/Directories.h"
 #include "SceneParser.h"
 #include "Resources/Model/ModelResources.h"
@@ -67,6 +70,8 @@ void ApplicationCore::initialize(const TargetWindow& window, const InitParams& a
 	physicsMgr.init();
 	terrainPhysics.init(renderSystem.core.device);
 
+	CpuProfiler::Get().setThreadName("Main");
+
 	Logger::log("ApplicationCore Initialized");
 }
 
@@ -105,6 +110,8 @@ void ApplicationCore::beginRendering(std::function<bool(float)> onUpdate)
 
 void ApplicationCore::renderFrame(Camera& camera)
 {
+	CpuProfiler::Zone zone("Frame");
+
 	params.time += timeSinceLastFrame;
 	params.timeDelta = timeSinceLastFrame;
 	params.frameIndex = renderSystem.core.frameIndex;
@@ -113,20 +120,43 @@ void ApplicationCore::renderFrame(Camera& camera)
 	terrainPhysics.consumeReadbacks(camera.getPosition(), renderWorld.terrain.params, physicsMgr);
 	waterInteraction.update(timeSinceLastFrame, physicsMgr, renderWorld.water);
 
+	resources.models.updateStreaming();
 	renderWorld.update();
+	resources.models.updateResidency();
 	camera.updateMatrix();
+	resources.textureStreaming.gatherUsage(renderWorld, camera, (float)renderSystem.viewport.getHeight());
+	resources.textureStreaming.update();
 	shadowMap->update(renderSystem.core.frameIndex, camera);
 
 	sky.updateSkyParameters(params.sky, renderSystem.core.frameIndex);
 
+	JobSystem::Handle simulation;
+	if (simulate)
+	{
+		// physics debug view reads bodies while recording
+		if (physicsMgr.isRendererEnabled())
+			simulate(timeSinceLastFrame);
+		else
+			simulation = JobSystem::Get().submit([this, dt = timeSinceLastFrame]
+				{
+					CpuProfiler::Zone zone("Simulation");
+					simulate(dt);
+				});
+	}
+
 	RenderContext ctx = { &camera };
 	compositor->render(ctx);
+
+	JobSystem::Get().wait(simulation);
 }
 
 HRESULT ApplicationCore::present()
 {
 	HRESULT r = renderSystem.core.Present();
 	renderSystem.core.EndFrame();
+	resources.descriptors.advanceFrame();
+	RenderStats::Get().endFrame();
+	FrameArena::NextFrame();
 
 	return r;
 }
@@ -10,6 +10,7 @@
 #include "Physics/TerrainPhysics.h"
 #include "Physics/WaterSimInteractionUpdater.h"
 #include "RenderObject/Sky/SkyRendering.h"
+#include "Utils/JobSystem.h"
 
 #include <memory>
 #include <vector>
@@ -46,6 +47,10 @@ public:
 	void renderFrame(Camera& camera);
 	HRESULT present();
 
+	// Next frame simulation, runs on worker while current frame is recorded from render snapshot.
+	// Can only change simulation state like physics and object transformations.
+	std::function<void(float)> simulate;
+
 	void loadScene();
 
 	RenderSystem renderSystem;
@@ -0,0 +1,59 @@
+#include "JoltJobSystem.h"
+
+JoltJobSystem::JoltJobSystem(JobSystem& j, JPH::uint maxJobs, JPH::uint maxBarriers) : JobSystemWithBarrier(maxBarriers), jobs(j)
+{
+	availableJobs.Init(maxJobs, maxJobs);
+}
+
+int JoltJobSystem::GetMaxConcurrency() const
+{
+	// caller of PhysicsSystem::Update runs jobs too while waiting on barrier
+	return int(jobs.getWorkersCount()) + 1;
+}
+
+JPH::JobSystem::JobHandle JoltJobSystem::CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies)
+{
+	JPH::uint32 index;
+	while (true)
+	{
+		index = availableJobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+		if (index != AvailableJobs::cInvalidObjectIndex)
+			break;
+
+		// wait for running jobs to free some space
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+
+	Job* job = &availableJobs.Get(index);
+
+	// keep reference, queued job may finish right away
+	JobHandle handle(job);
+
+	if (inNumDependencies == 0)
+		QueueJob(job);
+
+	return handle;
+}
+
+void JoltJobSystem::QueueJob(Job* inJob)
+{
+	inJob->AddRef();
+
+	jobs.submit([inJob]
+		{
+			// barrier may have executed it already
+			inJob->Execute();
+			inJob->Release();
+		});
+}
+
+void JoltJobSystem::QueueJobs(Job** inJobs, JPH::uint inNumJobs)
+{
+	for (JPH::uint i = 0; i < inNumJobs; i++)
+		QueueJob(inJobs[i]);
+}
+
+void JoltJobSystem::FreeJob(Job* inJob)
+{
+	availableJobs.DestructObject(inJob);
+}
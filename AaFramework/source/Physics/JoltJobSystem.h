@@ -0,0 +1,30 @@
+#pragma once
+
+#include "JoltHeader.h"
+#include <Jolt/Core/JobSystemWithBarrier.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include "Utils/JobSystem.h"
+
+// Runs Jolt physics jobs on engine JobSystem workers
+class JoltJobSystem final : public JPH::JobSystemWithBarrier
+{
+public:
+
+	JoltJobSystem(JobSystem& jobs, JPH::uint maxJobs, JPH::uint maxBarriers);
+
+	int GetMaxConcurrency() const override;
+	JobHandle CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies = 0) override;
+
+protected:
+
+	void QueueJob(Job* inJob) override;
+	void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+	void FreeJob(Job* inJob) override;
+
+private:
+
+	JobSystem& jobs;
+
+	using AvailableJobs = JPH::FixedSizeFreeList<Job>;
+	AvailableJobs availableJobs;
+};
@@ -11,6 +11,7 @@
 #include "Jolt/Core/Color.h"
 #include "Scene/RenderEntity.h"
 #include "Scene/RenderObject.h"
+#include "Utils/CpuProfiler.h"
 #include <thread>
 #include <format>
 
@@ -35,7 +36,7 @@ static Quat toQuat(const Quaternion& q)
 	return { q.x, q.y, q.z, q.w };
 }
 
-PhysicsManager::PhysicsManager() : job_system(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1)
+PhysicsManager::PhysicsManager() : job_system(JobSystem::Get(), JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers)
 {
 }
 
@@ -248,6 +249,8 @@ JPH::BodyID PhysicsManager::createMeshBody(const std::vector<Vector3>& points, c
 
 void PhysicsManager::update(float deltaTime)
 {
+	CpuProfiler::Zone zone("Physics");
+
 	if (!enableUpdating)
 		return;
 
@@ -4,7 +4,7 @@
 #include "JoltHeader.h"
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Core/TempAllocator.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
+#include "JoltJobSystem.h"
 #include "Utils/MathUtils.h"
 #include <format>
 #include "Render/PhysicsRenderer.h"
@@ -64,6 +64,7 @@ public:
 
 	void enableRenderer(RenderSystem&, GraphicsResources&);
 	void disableRenderer(RenderSystem& rs);
+	bool isRendererEnabled() const { return renderer != nullptr; }
 
 	void drawDebugRender(ID3D12GraphicsCommandList* commandList, ShaderConstantsProvider* constants, const std::vector<DXGI_FORMAT>& targets, bool wireframe);
 
@@ -82,10 +83,8 @@ private:
 
 	JPH::TempAllocatorMalloc temp_allocator;
 
-	// We need a job system that will execute physics jobs on multiple threads. Typically
-	// you would implement the JobSystem interface yourself and let Jolt Physics run on top
-	// of your own job scheduler. JobSystemThreadPool is an example implementation.
-	JPH::JobSystemThreadPool job_system;
+	// physics jobs share engine worker threads
+	JoltJobSystem job_system;
 
 	void clear();
 
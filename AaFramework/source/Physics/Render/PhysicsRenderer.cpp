@@ -38,6 +38,7 @@ bool PhysicsRenderer::PrepareForRendering(ID3D12GraphicsCommandList* commandList
 	}
 
 	renderCtx.lastMaterial = nullptr;
+	renderCtx.storage = {};
 	renderCtx.commandList = commandList;
 	renderCtx.targets = targets;
 	renderCtx.constants = constants;
@@ -94,15 +95,16 @@ void PhysicsRenderer::DrawGeometry(RMat44Arg inModelMatrix, const AABox& inWorld
 	auto& model = ((ModelBatch*)inGeometry->mLODs.front().mTriangleBatch.GetPtr())->model;
 
 	auto material = GetMaterial(model, inDrawMode);
+	D3D12GraphicsCommands commands(renderCtx.commandList);
 
 	if (material != renderCtx.lastMaterial)
 	{
 		renderCtx.lastMaterial = material;
 
-		material->GetBase()->BindSignature(renderCtx.commandList);
+		material->GetBase()->BindSignature(commands);
 		material->LoadMaterialConstants(renderCtx.storage);
-		material->BindPipeline(renderCtx.commandList);
-		//material->BindTextures(renderCtx.commandList);
+		material->BindPipeline(commands);
+		//material->BindTextures(commands);
 		material->UpdatePerFrame(renderCtx.storage, *renderCtx.constants);
 	}
 
@@ -112,7 +114,7 @@ void PhysicsRenderer::DrawGeometry(RMat44Arg inModelMatrix, const AABox& inWorld
 	material->SetParameter(ResourcesInfo::AutoParam::WORLD_MATRIX, &matrixW, 16, renderCtx.storage);
 	material->SetParameter(ResourcesInfo::AutoParam::PREV_WORLD_MATRIX, &matrixW, 16, renderCtx.storage);
 
-	material->BindConstants(renderCtx.commandList, renderCtx.storage, *renderCtx.constants);
+	material->BindConstants(commands, renderCtx.storage, *renderCtx.constants);
 
 	RenderObject(renderCtx.commandList, model);
 }
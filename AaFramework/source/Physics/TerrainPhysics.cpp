@@ -2,6 +2,7 @@
 #include "PhysicsManager.h"
 #include "RenderObject/Terrain/ProgressiveTerrain.h"
 #include "directx/d3dx12.h"
+#include "Utils/CpuProfiler.h"
 #include <Jolt/Physics/Collision/Shape/HeightFieldShape.h>
 
 using namespace JPH;
@@ -139,6 +140,8 @@ void TerrainPhysics::requestReadbacks(ID3D12GraphicsCommandList* commandList, Pr
 
 void TerrainPhysics::consumeReadbacks(const Vector3& cameraPos, const TerrainGridParams& params, PhysicsManager& physics)
 {
+	CpuProfiler::Zone zone("TerrainPhysics");
+
 	// Update center with hysteresis (in physics tile coordinates)
 	bool centerChanged = updateCenter(cameraPos, params);
 
@@ -210,8 +213,7 @@ void TerrainPhysics::clear(PhysicsManager& physics)
 	// Wait for any pending async builds before clearing
 	for (auto& build : pendingBuilds)
 	{
-		if (build.future.valid())
-			build.future.wait();
+		JobSystem::Get().wait(build.job);
 	}
 	pendingBuilds.clear();
 	pendingBuildTiles.clear();
@@ -289,7 +291,9 @@ void TerrainPhysics::buildTileFromCache(XMINT2 tileCoord, const TerrainGridParam
 	UINT capturedRowPitch = cache->rowPitch;
 	float tileHeight = params.tileHeight;
 
-	auto future = std::async(std::launch::async, [ownedData, capturedRowPitch, tileSz, tileHeight, offset, tilePixelOffsetX, tilePixelOffsetY]() -> BodyCreationSettings
+	auto result = std::make_shared<BodyCreationSettings>();
+
+	auto job = JobSystem::Get().submit([result, ownedData, capturedRowPitch, tileSz, tileHeight, offset, tilePixelOffsetX, tilePixelOffsetY]()
 	{
 		// Sample TileContentPixels+1 pixels = TileContentPixels intervals
 		constexpr UINT physicsRes = TileContentPixels + 1; // 241
@@ -319,7 +323,7 @@ void TerrainPhysics::buildTileFromCache(XMINT2 tileCoord, const TerrainGridParam
 		auto shapeResult = settings.Create();
 
 		if (shapeResult.HasError())
-			return BodyCreationSettings();
+			return;
 
 		BodyCreationSettings creation_settings(shapeResult.Get(),
 			Vec3(offset.x, offset.y, offset.z), Quat::sIdentity(),
@@ -327,20 +331,20 @@ void TerrainPhysics::buildTileFromCache(XMINT2 tileCoord, const TerrainGridParam
 		creation_settings.mFriction = 0.8f;
 		creation_settings.mRestitution = 0.3f;
 
-		return creation_settings;
+		*result = creation_settings;
 	});
 
 	pendingBuildTiles.insert(packCoord(tileCoord));
-	pendingBuilds.push_back({ tileCoord, offset, std::move(future) });
+	pendingBuilds.push_back({ tileCoord, offset, std::move(job), std::move(result) });
 }
 
 void TerrainPhysics::collectFinishedBuilds(PhysicsManager& physics)
 {
 	for (auto it = pendingBuilds.begin(); it != pendingBuilds.end(); )
 	{
-		if (it->future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		if (it->job.done())
 		{
-			auto settings = it->future.get();
+			auto& settings = *it->result;
 
 			if (settings.GetShape() != nullptr)
 			{
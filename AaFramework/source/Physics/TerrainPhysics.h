@@ -7,7 +7,7 @@
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 #include <unordered_map>
 #include <unordered_set>
-#include <future>
+#include "Utils/JobSystem.h"
 
 class ProgressiveTerrain;
 class PhysicsManager;
@@ -81,7 +81,8 @@ private:
 	{
 		XMINT2 tileCoord;
 		Vector3 offset;
-		std::future<JPH::BodyCreationSettings> future;
+		JobSystem::Handle job;
+		std::shared_ptr<JPH::BodyCreationSettings> result;
 	};
 	std::vector<PendingBuild> pendingBuilds;
 	std::unordered_set<uint64_t> pendingBuildTiles;
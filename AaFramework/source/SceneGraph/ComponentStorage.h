@@ -1,8 +1,10 @@
 #pragma once
 
 #include <vector>
-#include <functional>
 #include <span>
+#include <cstddef>
+#include <new>
+#include <type_traits>
 
 // ============================================================
 // Entity
@@ -21,12 +23,46 @@ struct Entity
 
 static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
 
+// Callable stored inline without allocation, invoked through single function pointer
+template<typename T>
+class ComponentCallback
+{
+public:
+
+	ComponentCallback() = default;
+
+	template<typename F> requires (!std::is_same_v<std::decay_t<F>, ComponentCallback>)
+	ComponentCallback(F func)
+	{
+		static_assert(sizeof(F) <= sizeof(storage) && alignof(F) <= alignof(void*), "Callback captures too much");
+		static_assert(std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>, "Callback captures have to be trivially copyable");
+
+		new (storage) F(func);
+		invoke = [](const void* f, Entity e, T& c) { (*static_cast<const F*>(f))(e, c); };
+	}
+
+	explicit operator bool() const
+	{
+		return invoke != nullptr;
+	}
+
+	void operator()(Entity e, T& c) const
+	{
+		invoke(storage, e, c);
+	}
+
+private:
+
+	alignas(void*) std::byte storage[4 * sizeof(void*)]{};
+	void (*invoke)(const void*, Entity, T&) = nullptr;
+};
+
 template<typename T>
 struct ComponentEventBus
 {
-	std::function<void(Entity, T&)> onAdded;
-	std::function<void(Entity, T&)> onRemoved;
-	std::function<void(Entity, T&)> onChanged;
+	ComponentCallback<T> onAdded;
+	ComponentCallback<T> onRemoved;
+	ComponentCallback<T> onChanged;
 
 	void EmitAdded(Entity e, T& c)
 	{
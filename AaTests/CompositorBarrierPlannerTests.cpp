@@ -0,0 +1,291 @@
+#undef NDEBUG
+#include "FrameCompositor/CompositorBarrierPlanner.h"
+#include "FrameCompositor/CompositorFileParser.h"
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+
+using namespace CompositorBarrierPlanner;
+
+// D3D12_RESOURCE_STATES values
+constexpr States Common = 0;
+constexpr States RenderTarget = 0x4;
+constexpr States UnorderedAccess = 0x8;
+constexpr States DepthWrite = 0x10;
+constexpr States DepthRead = 0x20;
+constexpr States NonPixelShaderResource = 0x40;
+constexpr States PixelShaderResource = 0x80;
+
+static size_t NextUse(const std::vector<Use>& uses, size_t idx)
+{
+	for (size_t i = idx + 1; i < uses.size(); i++)
+		if (uses[i].resource == uses[idx].resource)
+			return i;
+
+	return uses.size();
+}
+
+// invariants every plan has to keep
+static void checkPlan(const Plan& plan, const std::vector<Use>& uses, const std::vector<uint32_t>& passCommandLists)
+{
+	assert(plan.passes.size() == passCommandLists.size());
+
+	uint32_t batches = 0;
+	uint32_t barriers = 0;
+	uint32_t begins = 0;
+	uint32_t ends = 0;
+
+	for (uint32_t passIdx = 0; passIdx < plan.passes.size(); passIdx++)
+	{
+		auto& pass = plan.passes[passIdx];
+		batches += !pass.before.empty() + !pass.after.empty();
+		barriers += uint32_t(pass.before.size() + pass.after.size());
+
+		for (auto& b : pass.before)
+		{
+			assert(b.before != b.after);
+			assert(b.split != Split::Begin);
+			assert(uses[b.use].pass == passIdx);
+			ends += b.split == Split::End;
+
+			// read state covering needed read is not transitioned while next use is planned too
+			auto& use = uses[b.use];
+			auto next = NextUse(uses, b.use);
+			bool redundantRead = IsReadState(b.before) && IsReadState(b.after) && (b.before & b.after) == b.after;
+			assert(!(redundantRead && use.planned && next < uses.size() && uses[next].planned && !use.postState));
+		}
+
+		for (auto& b : pass.after)
+		{
+			assert(b.before != b.after);
+			assert(b.split != Split::End);
+
+			if (b.split != Split::Begin)
+				continue;
+
+			begins++;
+
+			// matching end half in later pass of same command list
+			auto& use = uses[b.use];
+			assert(use.pass > passIdx + 1);
+			assert(passCommandLists[passIdx] != NoCommandList && passCommandLists[passIdx] == passCommandLists[use.pass]);
+
+			uint32_t matches = 0;
+			for (auto& e : plan.passes[use.pass].before)
+				matches += e.use == b.use && e.split == Split::End && e.before == b.before && e.after == b.after;
+			assert(matches == 1);
+		}
+	}
+
+	assert(plan.batches == batches);
+	assert(begins == ends);
+	assert(plan.splitTransitions == begins);
+	assert(plan.transitions == barriers - ends);
+}
+
+static void testDroppedReadToRead()
+{
+	std::vector<Use> uses =
+	{
+		{ 0, 0, PixelShaderResource, RenderTarget, {}, true },
+		{ 0, 1, RenderTarget, PixelShaderResource | NonPixelShaderResource, {}, true },
+		// already readable, dropped
+		{ 0, 2, PixelShaderResource | NonPixelShaderResource, PixelShaderResource, {}, true },
+		{ 0, 3, PixelShaderResource, RenderTarget, {}, true },
+		// last use, next frame starts with planned transition anyway but it is kept
+		{ 0, 4, RenderTarget, PixelShaderResource, {}, true },
+	};
+	std::vector<uint32_t> commandLists(5, NoCommandList);
+
+	auto plan = Build(uses, commandLists);
+	checkPlan(plan, uses, commandLists);
+
+	assert(plan.droppedTransitions == 1);
+	assert(plan.transitions == 4);
+	assert(plan.splitTransitions == 0);
+	assert(plan.batches == 4);
+	assert(plan.passes[2].before.empty());
+	// transition after dropped one starts from still merged read state
+	assert(plan.passes[3].before.size() == 1 && plan.passes[3].before[0].before == (PixelShaderResource | NonPixelShaderResource));
+}
+
+static void testReadKeptBeforeUnplannedUse()
+{
+	// next use is transitioned by pass itself and expects exact state
+	std::vector<Use> uses =
+	{
+		{ 0, 0, RenderTarget, PixelShaderResource | NonPixelShaderResource, {}, true },
+		{ 0, 1, PixelShaderResource | NonPixelShaderResource, PixelShaderResource, {}, true },
+		{ 0, 2, PixelShaderResource, UnorderedAccess, {}, false },
+	};
+	std::vector<uint32_t> commandLists(3, NoCommandList);
+
+	auto plan = Build(uses, commandLists);
+	checkPlan(plan, uses, commandLists);
+
+	assert(plan.droppedTransitions == 0);
+	assert(plan.transitions == 2);
+}
+
+static void testSplitPairing()
+{
+	std::vector<Use> uses =
+	{
+		{ 0, 0, PixelShaderResource, RenderTarget, {}, true },
+		{ 0, 3, RenderTarget, PixelShaderResource, {}, true },
+		{ 1, 1, Common, DepthWrite, {}, true },
+		{ 1, 2, DepthWrite, DepthRead, {}, true },
+	};
+
+	// idle resource between passes of same command list gets split barrier
+	std::vector<uint32_t> commandLists(4, 0);
+	auto plan = Build(uses, commandLists);
+	checkPlan(plan, uses, commandLists);
+
+	assert(plan.splitTransitions == 1);
+	assert(plan.transitions == 4);
+	assert(plan.passes[0].after.size() == 1 && plan.passes[0].after[0].split == Split::Begin);
+	assert(plan.passes[3].before.size() == 1 && plan.passes[3].before[0].split == Split::End);
+	// neighbouring passes have nothing to overlap
+	assert(plan.passes[2].before.size() == 1 && plan.passes[2].before[0].split == Split::None);
+	assert(plan.batches == 5);
+
+	// different command lists cant split
+	commandLists = { 0, 0, 0, 1 };
+	plan = Build(uses, commandLists);
+	checkPlan(plan, uses, commandLists);
+
+	assert(plan.splitTransitions == 0);
+	assert(plan.transitions == 4);
+	assert(plan.batches == 4);
+}
+
+static bool IsUav(const CompositorInfo& info, const std::string& name)
+{
+	auto it = info.textures.find(name);
+	return it != info.textures.end() && it->second.uav;
+}
+
+// same state selection and read states merging as FrameCompositor::initializeTextureStates, without async compute handling
+static void buildUses(const CompositorInfo& info, std::vector<Use>& uses, std::vector<uint32_t>& passCommandLists)
+{
+	std::map<std::string, uint32_t> resourceIds;
+	std::vector<States> lastStates;
+
+	auto addUse = [&](const std::string& name, uint32_t pass, States state, bool planned)
+		{
+			auto resource = resourceIds.emplace(name, uint32_t(resourceIds.size())).first->second;
+			uses.push_back({ resource, pass, Common, state, {}, planned });
+		};
+
+	for (uint32_t passIdx = 0; auto& pass : info.passes)
+	{
+		const bool quadPass = !pass.material.empty();
+
+		for (auto& [name, flags] : pass.inputs)
+		{
+			States state = NonPixelShaderResource;
+			if (flags & Compositor::PixelShader)
+				state = PixelShaderResource;
+			else if (flags & Compositor::ComputeShader && IsUav(info, name) && flags & Compositor::Write)
+				state = (!(flags & Compositor::Read) || flags & Compositor::WriteFirst) ? UnorderedAccess : NonPixelShaderResource;
+
+			addUse(name, passIdx, state, quadPass);
+		}
+
+		for (auto& [name, flags] : pass.targets)
+		{
+			States state = RenderTarget;
+			if (flags & Compositor::ComputeShader)
+				state = UnorderedAccess;
+			else if (name.ends_with(":Depth"))
+				state = flags & Compositor::DepthRead ? DepthRead : DepthWrite;
+
+			addUse(name, passIdx, state, quadPass && !pass.mrt && state == RenderTarget);
+		}
+
+		passCommandLists.push_back(pass.flags & Compositor::Async ? 1 : 0);
+		passIdx++;
+	}
+
+	// following reads share combined read state
+	std::map<uint32_t, std::vector<size_t>> resourceUses;
+	for (size_t i = 0; i < uses.size(); i++)
+		resourceUses[uses[i].resource].push_back(i);
+
+	for (auto& [resource, indices] : resourceUses)
+	{
+		for (size_t first = 0; first < indices.size();)
+		{
+			size_t last = first + 1;
+			States merged = uses[indices[first]].state;
+
+			for (; last < indices.size() && IsReadState(merged) && IsReadState(uses[indices[last]].state); last++)
+				merged |= uses[indices[last]].state;
+
+			for (size_t i = first; i < last; i++)
+				uses[indices[i]].state = merged;
+
+			first = last;
+		}
+	}
+
+	// state left by previous use, first use continues from last one of previous frame
+	for (size_t i = 0; i < uses.size(); i++)
+	{
+		size_t previous = i;
+		for (size_t j = 0; j < uses.size(); j++)
+			if (uses[j].resource == uses[i].resource && (j < i || previous >= i))
+				previous = j;
+
+		uses[i].previousState = uses[previous].state;
+	}
+}
+
+static void testCompositorFiles()
+{
+	uint32_t plannedFiles = 0;
+
+	for (auto& entry : std::filesystem::directory_iterator(AA_FRAME_DIRECTORY))
+	{
+		if (entry.path().extension() != ".compositor")
+			continue;
+
+		const auto filename = entry.path().filename().string();
+		auto info = CompositorFileParser::parseFile(AA_FRAME_DIRECTORY, filename, {});
+
+		// some files only declare shared textures
+		if (info.passes.empty())
+		{
+			assert(filename != "frame.compositor");
+			continue;
+		}
+
+		std::vector<Use> uses;
+		std::vector<uint32_t> passCommandLists;
+		buildUses(info, uses, passCommandLists);
+
+		auto plan = Build(uses, passCommandLists);
+		checkPlan(plan, uses, passCommandLists);
+
+		assert(plan.batches <= 2 * info.passes.size());
+
+		printf("%s: %zu passes, %u transitions in %u batches, %u split, %u dropped\n", filename.c_str(),
+			info.passes.size(), plan.transitions, plan.batches, plan.splitTransitions, plan.droppedTransitions);
+
+		plannedFiles++;
+	}
+
+	assert(plannedFiles > 0);
+}
+
+int main()
+{
+	testDroppedReadToRead();
+	testReadKeptBeforeUnplannedUse();
+	testSplitPairing();
+	testCompositorFiles();
+
+	printf("CompositorBarrierPlanner tests passed\n");
+	return 0;
+}
@@ -0,0 +1,218 @@
+#undef NDEBUG
+#include "FrameCompositor/CompositorGraph.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <set>
+
+using namespace CompositorGraph;
+
+static CompositorPassInfo CreatePass(const std::string& name, std::vector<std::string> inputs, std::vector<std::string> targets)
+{
+	CompositorPassInfo pass;
+	pass.name = name;
+	pass.flags = Compositor::PixelShader;
+
+	for (auto& input : inputs)
+		pass.inputs.push_back({ input, Compositor::UsageFlags(Compositor::PixelShader | Compositor::Read) });
+	for (auto& target : targets)
+		pass.targets.push_back({ target });
+
+	return pass;
+}
+
+static bool HasEdge(const Graph& graph, uint32_t from, uint32_t to, EdgeType type)
+{
+	return std::any_of(graph.edges.begin(), graph.edges.end(), [&](const Edge& e) { return e.from == from && e.to == to && e.type == type; });
+}
+
+static bool Near(float a, float b)
+{
+	return std::abs(a - b) < 1e-4f;
+}
+
+// A -> B -> D and A -> C -> D, B is the long branch
+static std::vector<CompositorPassInfo> CreateDiamond()
+{
+	return {
+		CreatePass("A", {}, { "a" }),
+		CreatePass("B", { "a" }, { "b" }),
+		CreatePass("C", { "a" }, { "c" }),
+		CreatePass("D", { "b", "c" }, { "d" }),
+	};
+}
+
+static void testEdges()
+{
+	std::vector<CompositorPassInfo> passes = {
+		CreatePass("Write", {}, { "t" }),
+		CreatePass("Read", { "t" }, { "x" }),
+		CreatePass("Overwrite", {}, { "t" }),
+		CreatePass("Unrelated", {}, { "y" }),
+	};
+	passes[3].after = "Write";
+	passes[1].sync.push_back({ "done", true });
+	passes[3].sync.push_back({ "done", false });
+
+	auto graph = Build(passes);
+
+	assert(HasEdge(graph, 0, 1, EdgeType::Texture));
+	// write after read waits for reader, not only previous writer
+	assert(HasEdge(graph, 1, 2, EdgeType::Texture));
+	assert(!HasEdge(graph, 0, 2, EdgeType::Texture));
+	assert(HasEdge(graph, 0, 3, EdgeType::After));
+	assert(HasEdge(graph, 1, 3, EdgeType::Sync));
+
+	for (auto& edge : graph.edges)
+		assert(edge.from < edge.to);
+}
+
+static void testCriticalPath()
+{
+	auto passes = CreateDiamond();
+	auto graph = Build(passes);
+
+	// all costs 1 by default, both branches are critical
+	assert(Near(graph.criticalPathCost, 3));
+	assert(graph.nodes[1].critical() && graph.nodes[2].critical());
+
+	graph.nodes[1].cost = 3;
+	UpdateSchedule(graph);
+
+	assert(Near(graph.criticalPathCost, 5));
+	assert((graph.criticalPath == std::vector<uint32_t>{ 0, 1, 3 }));
+	assert(Near(graph.nodes[2].slack(), 2));
+	assert(!graph.nodes[2].critical());
+	assert(Near(graph.nodes[3].earliestStart, 4));
+}
+
+static void testMeasuredCosts()
+{
+	// same pass name used twice, as bloom or godray passes
+	std::vector<CompositorPassInfo> passes = {
+		CreatePass("Blur", {}, { "a" }),
+		CreatePass("Blur", { "a" }, { "b" }),
+		CreatePass("Other", {}, { "c" }),
+		CreatePass("Blur", { "b", "c" }, { "d" }),
+	};
+
+	auto names = GetTimingNames(passes);
+	assert((names == std::vector<std::string>{ "Blur", "Blur #2", "Other", "Blur #3" }));
+
+	auto graph = Build(passes);
+
+	// Other has no sample and keeps default cost
+	std::map<std::string, float> measured = { { "Blur", 0.5f }, { "Blur #2", 2.f }, { "Blur #3", 0.25f } };
+	assert(ApplyCosts(graph, names, measured) == 3);
+
+	assert(Near(graph.nodes[0].cost, 0.5f));
+	assert(Near(graph.nodes[1].cost, 2.f));
+	assert(Near(graph.nodes[2].cost, 1.f));
+	assert(Near(graph.nodes[3].cost, 0.25f));
+	assert(Near(graph.criticalPathCost, 2.75f));
+	assert((graph.criticalPath == std::vector<uint32_t>{ 0, 1, 3 }));
+
+	// no samples leave schedule as it is
+	assert(ApplyCosts(graph, names, {}) == 0);
+	assert(Near(graph.criticalPathCost, 2.75f));
+}
+
+static void testAsyncSync()
+{
+	auto passes = CreateDiamond();
+
+	SetAsync(passes[2]);
+	assert(passes[2].flags & Compositor::Async);
+	assert(passes[2].flags & Compositor::ComputeShader);
+	assert(!(passes[2].flags & Compositor::PixelShader));
+	for (auto& input : passes[2].inputs)
+		assert(input.flags & Compositor::Async);
+
+	// graphics A -> async C -> graphics D, both queue crossings need fence
+	assert(AddMissingSync(passes) == 2);
+	assert(AddMissingSync(passes) == 0);
+
+	auto graph = Build(passes);
+	assert(HasEdge(graph, 0, 2, EdgeType::Texture));
+	assert(HasEdge(graph, 2, 3, EdgeType::Texture));
+
+	size_t signals = 0, waits = 0;
+	for (auto& pass : passes)
+		for (auto& sync : pass.sync)
+		{
+			signals += sync.signal;
+			waits += !sync.signal;
+			assert(sync.compute == bool(pass.flags & Compositor::Async));
+		}
+	assert(signals == 2 && waits == 2);
+}
+
+static void testCompositorFiles()
+{
+	uint32_t files = 0;
+
+	for (auto& entry : std::filesystem::directory_iterator(AA_FRAME_DIRECTORY))
+	{
+		if (entry.path().extension() != ".compositor")
+			continue;
+
+		const auto filename = entry.path().filename().string();
+		auto info = CompositorFileParser::parseFile(AA_FRAME_DIRECTORY, filename, {});
+		if (info.passes.empty())
+			continue;
+
+		auto graph = Build(info.passes);
+		assert(graph.nodes.size() == info.passes.size());
+
+		for (auto& edge : graph.edges)
+			assert(edge.from < edge.to);
+
+		float lastFinish = 0;
+		for (auto& node : graph.nodes)
+		{
+			assert(node.slack() >= -1e-4f);
+			lastFinish = std::max(lastFinish, node.earliestFinish);
+		}
+		assert(Near(graph.criticalPathCost, lastFinish));
+
+		// path is connected chain of critical nodes summing to its cost
+		float pathCost = 0;
+		for (size_t i = 0; i < graph.criticalPath.size(); i++)
+		{
+			auto node = graph.criticalPath[i];
+			assert(graph.nodes[node].critical());
+			pathCost += graph.nodes[node].cost;
+
+			if (i > 0)
+			{
+				auto& deps = graph.nodes[node].dependencies;
+				assert(std::find(deps.begin(), deps.end(), graph.criticalPath[i - 1]) != deps.end());
+			}
+		}
+		assert(!graph.criticalPath.empty() && Near(graph.nodes[graph.criticalPath.front()].earliestStart, 0));
+		assert(Near(pathCost, graph.criticalPathCost));
+
+		auto names = GetTimingNames(info.passes);
+		std::set<std::string> uniqueNames(names.begin(), names.end());
+		assert(uniqueNames.size() == names.size());
+
+		printf("%s: %zu passes, %zu edges, critical path %zu passes\n", filename.c_str(), info.passes.size(), graph.edges.size(), graph.criticalPath.size());
+		files++;
+	}
+
+	assert(files > 0);
+}
+
+int main()
+{
+	testEdges();
+	testCriticalPath();
+	testMeasuredCosts();
+	testAsyncSync();
+	testCompositorFiles();
+
+	printf("CompositorGraph tests passed\n");
+	return 0;
+}
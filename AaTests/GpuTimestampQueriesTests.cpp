@@ -0,0 +1,178 @@
+#undef NDEBUG
+#include "RenderCore/GpuTimestampQueries.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+// ticks of 1 microsecond, gpu time 0 at cpu time 1 second
+static const GpuTimestampQueries::Calibration Queues[] = {
+	{ 1'000'000, 0, 1'000'000'000 },
+	{ 1'000'000, 500, 1'000'000'000 },
+};
+
+static bool Near(float a, float b)
+{
+	return std::abs(a - b) < 1e-4f;
+}
+
+static const GpuTimestampQueries::ScopeStats* FindStats(const std::vector<GpuTimestampQueries::ScopeStats>& stats, const std::string& name)
+{
+	for (auto& s : stats)
+		if (s.name == name)
+			return &s;
+
+	return nullptr;
+}
+
+static void testAllocate()
+{
+	GpuTimestampQueries queries;
+	queries.init(3, 2);
+
+	assert(queries.getQueriesCount() == 12);
+
+	auto a = queries.registerScope("A");
+	auto b = queries.registerScope("B");
+	assert(a != b);
+	assert(queries.registerScope("A") == a);
+	assert(queries.getScopeName(b) == "B");
+
+	// second frame range follows first one, begin and end query per allocation
+	assert(queries.allocate(1, a, 0) == 6);
+	assert(queries.allocate(1, b, 0) == 8);
+	assert(queries.allocate(1, a, 0) == 10);
+	assert(queries.allocate(1, b, 0) == GpuTimestampQueries::NoQuery);
+	assert(queries.allocate(1, b, 0) == GpuTimestampQueries::NoQuery);
+
+	assert(queries.frameQueryOffset(1) == 6);
+	assert(queries.frameQueriesCount(1) == 6);
+	assert(queries.frameQueriesCount(0) == 0);
+
+	// other frame is independent
+	assert(queries.allocate(0, a, 0) == 0);
+	assert(queries.frameQueriesCount(0) == 2);
+}
+
+static void testResolve()
+{
+	GpuTimestampQueries queries;
+	queries.init(8, 2);
+
+	auto outer = queries.registerScope("Outer");
+	auto inner = queries.registerScope("Inner");
+	auto compute = queries.registerScope("Compute");
+	auto unused = queries.registerScope("Unused");
+	(void)unused;
+
+	// nested scopes get their own query pairs, outer one is allocated first
+	queries.allocate(0, outer, 0);
+	queries.allocate(0, inner, 0);
+	queries.allocate(0, compute, 1);
+
+	const uint64_t timestamps[] = { 100, 400, 150, 250, 600, 700 };
+	auto samples = queries.resolve(0, timestamps, Queues);
+
+	assert(samples.size() == 3);
+	assert(samples[0].scope == outer && samples[0].startNs == 1'000'100'000 && samples[0].endNs == 1'000'400'000);
+	assert(samples[1].scope == inner && samples[1].startNs == 1'000'150'000);
+	// compute queue calibrated at different gpu timestamp
+	assert(samples[2].queue == 1 && samples[2].startNs == 1'000'100'000 && samples[2].endNs == 1'000'200'000);
+
+	auto stats = queries.getStats();
+	assert(stats.size() == 3);
+	assert(Near(FindStats(stats, "Outer")->lastMs, 0.3f));
+	assert(Near(FindStats(stats, "Inner")->lastMs, 0.1f));
+	assert(Near(FindStats(stats, "Compute")->lastMs, 0.1f));
+	assert(!FindStats(stats, "Unused"));
+
+	// resolve frees frame queries
+	assert(queries.frameQueriesCount(0) == 0);
+	assert(queries.allocate(0, outer, 0) == 0);
+}
+
+static void testSameScopeSummed()
+{
+	GpuTimestampQueries queries;
+	queries.init(8, 1);
+
+	auto blur = queries.registerScope("Blur");
+
+	queries.allocate(0, blur, 0);
+	queries.allocate(0, blur, 0);
+	queries.allocate(0, blur, 0);
+
+	const uint64_t timestamps[] = { 0, 100, 200, 250, 300, 300 };
+	auto samples = queries.resolve(0, timestamps, Queues);
+	assert(samples.size() == 3);
+
+	// one frame value of all recordings, not 3 history entries
+	auto stats = queries.getStats();
+	assert(stats.size() == 1);
+	assert(Near(stats[0].lastMs, 0.15f));
+	assert(Near(stats[0].averageMs, 0.15f));
+	assert(Near(stats[0].minMs, 0.15f) && Near(stats[0].maxMs, 0.15f));
+}
+
+static void testMissingData()
+{
+	GpuTimestampQueries queries;
+	queries.init(4, 1);
+
+	auto a = queries.registerScope("A");
+	auto b = queries.registerScope("B");
+
+	queries.allocate(0, a, 0);
+	queries.allocate(0, b, 1);
+	queries.allocate(0, a, 0);
+
+	// uncalibrated queue is skipped, end before begin counts as zero and only written timestamps are read
+	const GpuTimestampQueries::Calibration queues[] = { Queues[0], {} };
+	const uint64_t timestamps[] = { 500, 100, 0, 100 };
+	auto samples = queries.resolve(0, timestamps, queues);
+
+	assert(samples.size() == 1);
+	assert(samples[0].startNs == samples[0].endNs);
+
+	auto stats = queries.getStats();
+	assert(stats.size() == 1 && stats[0].name == "A" && stats[0].lastMs == 0.f);
+}
+
+static void testFrameWraparound()
+{
+	GpuTimestampQueries queries;
+	queries.init(2, 3, 4);
+
+	auto scope = queries.registerScope("Pass");
+	const float durations[] = { 1, 2, 3, 4, 5, 6, 7 };
+
+	// frames in flight are reused in ring, statistics keep only last historySize frames
+	for (uint32_t i = 0; i < std::size(durations); i++)
+	{
+		const uint32_t frame = i % 3;
+		assert(queries.allocate(frame, scope, 0) == queries.frameQueryOffset(frame));
+		assert(queries.frameQueriesCount(frame) == 2);
+
+		const uint64_t timestamps[] = { 1000, 1000 + uint64_t(durations[i] * 1000) };
+		queries.resolve(frame, timestamps, Queues);
+
+		auto stats = queries.getStats();
+		assert(stats.size() == 1);
+		assert(Near(stats[0].lastMs, durations[i]));
+	}
+
+	auto stats = queries.getStats()[0];
+	assert(Near(stats.averageMs, (4 + 5 + 6 + 7) / 4.f));
+	assert(Near(stats.minMs, 4) && Near(stats.maxMs, 7));
+}
+
+int main()
+{
+	testAllocate();
+	testResolve();
+	testSameScopeSummed();
+	testMissingData();
+	testFrameWraparound();
+
+	printf("GpuTimestampQueries tests passed\n");
+	return 0;
+}
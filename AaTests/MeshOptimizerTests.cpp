@@ -0,0 +1,154 @@
+#undef NDEBUG
+#include "Resources/Model/MeshOptimizer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <random>
+
+struct Mesh
+{
+	std::vector<float> positions;
+	std::vector<uint32_t> indices;
+
+	size_t vertexCount() const { return positions.size() / 3; }
+};
+
+// row by row quads as produced for spline roads, width in vertices
+static Mesh CreateStripGrid(uint32_t width, uint32_t rows)
+{
+	Mesh mesh;
+
+	for (uint32_t y = 0; y <= rows; y++)
+		for (uint32_t x = 0; x < width; x++)
+			mesh.positions.insert(mesh.positions.end(), { float(x), 0.f, float(y) });
+
+	for (uint32_t y = 0; y < rows; y++)
+		for (uint32_t x = 0; x + 1 < width; x++)
+		{
+			uint32_t a = y * width + x;
+			uint32_t b = a + width;
+			mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+		}
+
+	return mesh;
+}
+
+static std::vector<std::vector<float>> SortedTriangles(const std::vector<uint32_t>& indices, const std::vector<float>& positions)
+{
+	// triangles as position keys, independent of vertex order and rotation
+	std::vector<std::vector<float>> triangles;
+	for (size_t t = 0; t < indices.size(); t += 3)
+	{
+		std::vector<float> triangle;
+		for (int i = 0; i < 3; i++)
+			triangle.insert(triangle.end(), positions.begin() + indices[t + i] * 3, positions.begin() + indices[t + i] * 3 + 3);
+
+		auto minIt = std::min_element(triangle.begin(), triangle.end());
+		std::rotate(triangle.begin(), triangle.begin() + (minIt - triangle.begin()) / 3 * 3, triangle.end());
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+
+	return triangles;
+}
+
+static std::vector<float> PositionsSequence(const Mesh& mesh)
+{
+	std::vector<float> sequence;
+	for (auto i : mesh.indices)
+		sequence.insert(sequence.end(), mesh.positions.begin() + i * 3, mesh.positions.begin() + i * 3 + 3);
+
+	return sequence;
+}
+
+static void testAnalyze()
+{
+	// single triangle misses all its vertices
+	std::vector<uint32_t> triangle = { 0, 1, 2 };
+	auto stats = MeshOptimizer::analyzeVertexCache(triangle, 3);
+	assert(stats.acmr == 3.f);
+	assert(stats.atvr == 1.f);
+
+	// quad shares two vertices
+	std::vector<uint32_t> quad = { 0, 1, 2, 2, 1, 3 };
+	stats = MeshOptimizer::analyzeVertexCache(quad, 4);
+	assert(stats.acmr == 2.f);
+
+	assert(MeshOptimizer::analyzeVertexCache({}, 0).acmr == 0.f);
+}
+
+static void testShuffledGridImproves()
+{
+	auto mesh = CreateStripGrid(32, 32);
+	const auto expected = SortedTriangles(mesh.indices, mesh.positions);
+
+	// shuffled triangles, worst case for the cache
+	std::mt19937 random(3);
+	std::vector<size_t> order(mesh.indices.size() / 3);
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+	std::shuffle(order.begin(), order.end(), random);
+
+	std::vector<uint32_t> shuffled;
+	for (auto t : order)
+		shuffled.insert(shuffled.end(), mesh.indices.begin() + t * 3, mesh.indices.begin() + t * 3 + 3);
+	mesh.indices = shuffled;
+
+	auto report = MeshOptimizer::optimizeMesh(mesh.indices, mesh.positions.data(), mesh.vertexCount(), sizeof(float) * 3, mesh.positions.data(), sizeof(float) * 3);
+
+	assert(report.after.acmr < report.before.acmr * 0.5f);
+	assert(report.vertexCount == mesh.vertexCount());
+	assert(SortedTriangles(mesh.indices, mesh.positions) == expected);
+
+	// vertex fetch order follows first use
+	uint32_t nextVertex = 0;
+	for (auto i : mesh.indices)
+	{
+		assert(i <= nextVertex);
+		if (i == nextVertex)
+			nextVertex++;
+	}
+}
+
+static void testStripGridKeepsOrder()
+{
+	// narrow strip grid is already close to optimal, reordering makes ACMR worse
+	auto mesh = CreateStripGrid(8, 1000);
+	const auto original = PositionsSequence(mesh);
+
+	auto reordered = mesh.indices;
+	MeshOptimizer::optimizeVertexCache(reordered, mesh.vertexCount());
+	const float optimizedAcmr = MeshOptimizer::analyzeVertexCache(reordered, mesh.vertexCount()).acmr;
+
+	auto report = MeshOptimizer::optimizeMesh(mesh.indices, mesh.positions.data(), mesh.vertexCount(), sizeof(float) * 3, mesh.positions.data(), sizeof(float) * 3);
+
+	assert(optimizedAcmr > report.before.acmr);
+	assert(report.after.acmr == report.before.acmr);
+	// same triangles in same order, only vertices renumbered by fetch optimization
+	assert(PositionsSequence(mesh) == original);
+
+	printf("strip grid W8: ACMR %.3f kept, reordered would be %.3f\n", report.before.acmr, optimizedAcmr);
+}
+
+static void testUnusedVerticesDropped()
+{
+	std::vector<float> vertices = { 0, 0, 0, 9, 9, 9, 1, 0, 0, 0, 1, 0 };
+	std::vector<uint32_t> indices = { 3, 2, 0 };
+
+	auto count = MeshOptimizer::optimizeVertexFetch(indices, vertices.data(), 4, sizeof(float) * 3);
+
+	assert(count == 3);
+	assert((indices == std::vector<uint32_t>{ 0, 1, 2 }));
+	assert((std::vector<float>(vertices.begin(), vertices.begin() + 9) == std::vector<float>{ 0, 1, 0, 1, 0, 0, 0, 0, 0 }));
+}
+
+int main()
+{
+	testAnalyze();
+	testShuffledGridImproves();
+	testStripGridKeepsOrder();
+	testUnusedVerticesDropped();
+
+	printf("MeshOptimizer tests passed\n");
+	return 0;
+}
@@ -0,0 +1,166 @@
+#undef NDEBUG
+#ifndef _WIN32
+// DirectX-Headers need windows types before d3d12.h
+#include <wsl/winadapter.h>
+#endif
+#include "RenderCore/RecordingGraphicsCommands.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+using Type = RecordingGraphicsCommands::Type;
+
+template<typename T>
+static T* FakeObject(uintptr_t id)
+{
+	return reinterpret_cast<T*>(id);
+}
+
+static std::vector<Type> GetTypes(const RecordingGraphicsCommands& commands)
+{
+	std::vector<Type> types;
+	for (auto& c : commands.getCommands())
+		types.push_back(c.type);
+
+	return types;
+}
+
+static void testCommandOrder()
+{
+	RecordingGraphicsCommands recording;
+	GraphicsCommands& commands = recording;
+
+	D3D12_VERTEX_BUFFER_VIEW vertexBuffers[2]{};
+	vertexBuffers[0].BufferLocation = 0x1000;
+	D3D12_INDEX_BUFFER_VIEW indexBuffer{};
+	indexBuffer.BufferLocation = 0x2000;
+
+	commands.SetGraphicsRootSignature(FakeObject<ID3D12RootSignature>(0x10));
+	commands.SetPipelineState(FakeObject<ID3D12PipelineState>(0x20));
+	commands.SetGraphicsRootDescriptorTable(3, { 0x30 });
+	commands.SetGraphicsRootConstantBufferView(1, 0x40);
+	commands.SetGraphicsRootShaderResourceView(4, 0x50);
+	commands.SetGraphicsRootUnorderedAccessView(5, 0x60);
+	commands.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	commands.IASetVertexBuffers(1, 2, vertexBuffers);
+	commands.IASetIndexBuffer(&indexBuffer);
+	commands.DrawIndexedInstanced(36, 1, 0, 0, 0);
+	commands.ResourceBarrier(2, nullptr);
+	commands.DispatchMesh(4, 2, 1);
+	commands.ExecuteIndirect(nullptr, 16, FakeObject<ID3D12Resource>(0x70), 256, nullptr, 0);
+
+	const std::vector<Type> expected = {
+		Type::SetRootSignature, Type::SetPipelineState, Type::SetDescriptorTable, Type::SetConstantBufferView,
+		Type::SetShaderResourceView, Type::SetUnorderedAccessView, Type::SetTopology, Type::SetVertexBuffers,
+		Type::SetIndexBuffer, Type::DrawIndexedInstanced, Type::ResourceBarrier, Type::DispatchMesh, Type::ExecuteIndirect };
+	assert(GetTypes(recording) == expected);
+
+	auto& c = recording.getCommands();
+	assert(c[0].object == FakeObject<void>(0x10));
+	assert(c[1].object == FakeObject<void>(0x20));
+	assert(c[2].index == 3 && c[2].value == 0x30);
+	assert(c[3].index == 1 && c[3].value == 0x40);
+	assert(c[4].index == 4 && c[4].value == 0x50);
+	assert(c[5].index == 5 && c[5].value == 0x60);
+	assert(c[6].counts[0] == D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	assert(c[7].index == 1 && c[7].counts[0] == 2 && c[7].value == 0x1000);
+	assert(c[8].value == 0x2000);
+	assert(c[10].counts[0] == 2);
+	assert(c[11].counts[0] == 4 && c[11].counts[1] == 2 && c[11].counts[2] == 1);
+	assert(c[12].object == FakeObject<void>(0x70) && c[12].value == 256 && c[12].counts[0] == 16);
+
+	assert(recording.count(Type::SetDescriptorTable) == 1);
+	assert(recording.count(Type::DrawInstanced) == 0);
+	assert(recording.drawsCount() == 3);
+	assert(recording.stateChangesCount() == 2);
+
+	for (auto type : expected)
+		assert(strcmp(RecordingGraphicsCommands::GetName(type), "") != 0);
+}
+
+static void testRootConstantsCopied()
+{
+	RecordingGraphicsCommands recording;
+
+	uint32_t values[4] = { 1, 2, 3, 4 };
+	recording.SetGraphicsRoot32BitConstants(2, 4, values, 0);
+
+	// caller reuses its buffer for next object
+	values[0] = 10;
+	values[1] = 20;
+	recording.SetGraphicsRoot32BitConstants(2, 2, values, 1);
+	memset(values, 0, sizeof(values));
+
+	auto& c = recording.getCommands();
+	assert(c.size() == 2);
+
+	auto first = recording.getConstants(c[0]);
+	assert(c[0].index == 2 && c[0].counts[0] == 4 && c[0].counts[1] == 0);
+	assert(first.size() == 4 && first[0] == 1 && first[1] == 2 && first[2] == 3 && first[3] == 4);
+
+	auto second = recording.getConstants(c[1]);
+	assert(c[1].counts[1] == 1);
+	assert(second.size() == 2 && second[0] == 10 && second[1] == 20);
+
+	// other commands have no constants
+	recording.DrawInstanced(3, 1, 0, 0);
+	assert(recording.getConstants(recording.getCommands()[2]).empty());
+}
+
+static void testDrawCounts()
+{
+	RecordingGraphicsCommands recording;
+
+	recording.DrawInstanced(3, 100, 6, 7);
+	recording.DrawIndexedInstanced(36, 250, 12, -5, 9);
+
+	auto& draw = recording.getCommands()[0];
+	assert(draw.counts[0] == 3 && draw.counts[1] == 100 && draw.counts[2] == 6 && draw.counts[3] == 7);
+
+	auto& indexed = recording.getCommands()[1];
+	assert(indexed.counts[0] == 36 && indexed.counts[1] == 250 && indexed.counts[2] == 12 && indexed.counts[3] == 9);
+	assert(INT(indexed.value) == -5);
+
+	assert(recording.count(Type::DrawInstanced) == 1);
+	assert(recording.count(Type::DrawIndexedInstanced) == 1);
+	assert(recording.drawsCount() == 2);
+	assert(recording.stateChangesCount() == 0);
+}
+
+static void testClear()
+{
+	RecordingGraphicsCommands recording;
+
+	uint32_t values[2] = { 5, 6 };
+	recording.SetPipelineState(nullptr);
+	recording.SetGraphicsRoot32BitConstants(0, 2, values, 0);
+	recording.DrawInstanced(3, 1, 0, 0);
+
+	recording.clear();
+
+	assert(recording.getCommands().empty());
+	assert(recording.drawsCount() == 0);
+	assert(recording.stateChangesCount() == 0);
+	for (size_t i = 0; i < size_t(Type::Count); i++)
+		assert(recording.count(Type(i)) == 0);
+
+	// constants storage starts again from beginning
+	values[0] = 7;
+	recording.SetGraphicsRoot32BitConstants(0, 1, values, 0);
+
+	auto& c = recording.getCommands();
+	assert(c.size() == 1 && c[0].constantsOffset == 0);
+	assert(recording.getConstants(c[0])[0] == 7);
+	assert(recording.count(Type::SetRootConstants) == 1);
+}
+
+int main()
+{
+	testCommandOrder();
+	testRootConstantsCopied();
+	testDrawCounts();
+	testClear();
+
+	printf("RecordingGraphicsCommands tests passed\n");
+	return 0;
+}
@@ -0,0 +1,116 @@
+#undef NDEBUG
+#include "FrameCompositor/TransientResourceAliasing.h"
+#include <cassert>
+#include <cstdio>
+#include <random>
+
+using namespace TransientResourceAliasing;
+
+static bool MemoryOverlaps(const Placement& placement, const std::vector<Resource>& resources, size_t a, size_t b)
+{
+	return placement.offsets[a] < placement.offsets[b] + resources[b].size && placement.offsets[b] < placement.offsets[a] + resources[a].size;
+}
+
+static void testLifetimes()
+{
+	assert(LifetimesOverlap({ 1, 1, 0, 2 }, { 1, 1, 2, 4 }));
+	assert(LifetimesOverlap({ 1, 1, 0, 5 }, { 1, 1, 2, 3 }));
+	assert(!LifetimesOverlap({ 1, 1, 0, 1 }, { 1, 1, 2, 3 }));
+	assert(!LifetimesOverlap({ 1, 1, 4, 4 }, { 1, 1, 2, 3 }));
+}
+
+static void testOverlapRejected()
+{
+	// all alive at once, nothing can be shared
+	std::vector<Resource> resources = { { 100, 1, 0, 3 }, { 60, 1, 1, 2 }, { 40, 1, 2, 3 } };
+	auto placement = Solve(resources);
+
+	for (size_t a = 0; a < resources.size(); a++)
+		for (size_t b = a + 1; b < resources.size(); b++)
+			assert(!MemoryOverlaps(placement, resources, a, b));
+
+	assert(placement.memorySize == 200);
+	assert(placement.savedBytes() == 0);
+}
+
+static void testRandomPlacements()
+{
+	std::mt19937 random(7);
+	std::uniform_int_distribution<uint64_t> size(1, 1000);
+	std::uniform_int_distribution<int> alignmentShift(0, 8);
+	std::uniform_int_distribution<uint32_t> pass(0, 20);
+
+	for (int iteration = 0; iteration < 200; iteration++)
+	{
+		std::vector<Resource> resources(1 + iteration % 30);
+		for (auto& r : resources)
+		{
+			r.size = size(random);
+			r.alignment = uint64_t(1) << alignmentShift(random);
+			r.firstUse = pass(random);
+			r.lastUse = r.firstUse + pass(random) % 5;
+		}
+
+		auto placement = Solve(resources);
+		assert(placement.offsets.size() == resources.size());
+
+		uint64_t alignedTotal = 0;
+		for (size_t a = 0; a < resources.size(); a++)
+		{
+			assert(placement.offsets[a] % resources[a].alignment == 0);
+			assert(placement.offsets[a] + resources[a].size <= placement.memorySize);
+			alignedTotal += (resources[a].size + resources[a].alignment - 1) / resources[a].alignment * resources[a].alignment;
+
+			for (size_t b = a + 1; b < resources.size(); b++)
+			{
+				if (LifetimesOverlap(resources[a], resources[b]))
+					assert(!MemoryOverlaps(placement, resources, a, b));
+			}
+		}
+
+		assert(placement.totalSize == alignedTotal);
+		assert(placement.memorySize <= placement.totalSize);
+	}
+}
+
+static void testAlignment()
+{
+	// second resource fits after first one only when aligned
+	std::vector<Resource> resources = { { 100, 1, 0, 1 }, { 50, 256, 1, 2 }, { 30, 64, 3, 3 } };
+	auto placement = Solve(resources);
+
+	assert(placement.offsets[0] == 0);
+	assert(placement.offsets[1] == 256);
+	// only alive alone, reuses start of memory
+	assert(placement.offsets[2] == 0);
+	assert(placement.memorySize == 306);
+}
+
+static void testSavedBytes()
+{
+	// sequential passes share one block of the largest size
+	std::vector<Resource> resources = { { 100, 1, 0, 0 }, { 60, 1, 1, 1 }, { 80, 1, 2, 2 } };
+	auto placement = Solve(resources);
+
+	for (auto offset : placement.offsets)
+		assert(offset == 0);
+
+	assert(placement.memorySize == 100);
+	assert(placement.totalSize == 240);
+	assert(placement.savedBytes() == 140);
+
+	assert(Solve({}).memorySize == 0);
+	assert(Solve({}).savedBytes() == 0);
+}
+
+int main()
+{
+	testLifetimes();
+	testOverlapRejected();
+	testRandomPlacements();
+	testAlignment();
+	testSavedBytes();
+
+	printf("TransientResourceAliasing tests passed\n");
+	return 0;
+}
@@ -4,6 +4,7 @@
 #include "hlsl/common/ShaderOutputs.hlsl"
 #include "hlsl/common/Triplanar.hlsl"
 #include "hlsl/common/DebugColors.hlsl"
+#include "hlsl/common/VertexDecoding.hlsl"
 
 #ifdef GRASS_INSTANCED
 #include "hlsl/terrain/grass/grassCommon.hlsl"
@@ -133,6 +134,7 @@ void ComputeBaseBend(float3 basePosOS, inout float3 vertexPosOS, float w)
 PSInput VSMain(VSInput input)
 {
 	PSInput result;
+	input.normal = DecodeVertexNormal(input.normal);
 
 #if defined(INSTANCED) || defined(GRASS_INSTANCED)
 	float bendScale = 1;
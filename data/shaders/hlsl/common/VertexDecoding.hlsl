@@ -0,0 +1,45 @@
+#pragma once
+
+// Vertex attributes packed at import (VertexQuantization), defines are added per input layout
+
+float3 DecodeVertexOctahedral(float2 p)
+{
+	float3 n = float3(p.x, p.y, 1.0f - abs(p.x) - abs(p.y));
+
+	if (n.z < 0.0f)
+	{
+		float2 signs = float2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+		n.xy = (1.0f - abs(n.yx)) * signs;
+	}
+
+	return normalize(n);
+}
+
+float3 DecodeVertexNormal(float3 n)
+{
+#ifdef PACKED_NORMAL_OCT
+	return DecodeVertexOctahedral(n.xy);
+#else
+	return n;
+#endif
+}
+
+float3 DecodeVertexTangent(float3 t)
+{
+#ifdef PACKED_TANGENT_OCT
+	return DecodeVertexOctahedral(t.xy);
+#else
+	return t;
+#endif
+}
+
+// bitangent direction, packed tangent (R16G16_SNORM) has odd y value when mirrored
+float DecodeVertexTangentSign(float3 t)
+{
+#ifdef PACKED_TANGENT_OCT
+	int y = (int)round(t.y * 32767.0f);
+	return (y & 1) ? -1.0f : 1.0f;
+#else
+	return 1.0f;
+#endif
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "hlsl/common/ShaderOutputs.hlsl"
+#include "hlsl/common/VertexDecoding.hlsl"
 
 float4x4 WorldMatrix;
 float4x4 ViewProjectionMatrix;
@@ -43,7 +44,7 @@ VS_OUTPUT VSMain(VS_INPUT Input)
 #endif
 
     Output.position = mul(Output.worldPosition, ViewProjectionMatrix);
-	Output.normal = Input.normal;
+	Output.normal = float4(DecodeVertexNormal(Input.normal.xyz), 0);
 
     return Output;
 }
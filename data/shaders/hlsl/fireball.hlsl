@@ -1,4 +1,5 @@
 #include "hlsl/common/ShaderOutputs.hlsl"
+#include "hlsl/common/VertexDecoding.hlsl"
 
 float4x4 WorldMatrix;
 float4x4 ViewProjectionMatrix;
@@ -87,9 +88,12 @@ VOut VSMain(VIn IN)
     OUT.uv.xy = IN.uv.xy;
     OUT.uv.zw = OUT.p.zw;
 
-    OUT.n = normalize(mul(IN.n, (float3x3)WorldMatrix));
-    OUT.t = IN.t;
-    OUT.b = normalize(cross(IN.t, IN.n));
+    float3 normal  = DecodeVertexNormal(IN.n);
+    float3 tangent = DecodeVertexTangent(IN.t);
+
+    OUT.n = normalize(mul(normal, (float3x3)WorldMatrix));
+    OUT.t = tangent;
+    OUT.b = normalize(cross(tangent, normal)) * DecodeVertexTangentSign(IN.t);
 
     return OUT;
 }
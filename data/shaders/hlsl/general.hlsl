@@ -1,4 +1,5 @@
 #include "hlsl/common/NormalDecoding.hlsl"
+#include "hlsl/common/VertexDecoding.hlsl"
 #include "hlsl/common/ResourceAccess.hlsl"
 #include "hlsl/common/MotionVectors.hlsl"
 #include "hlsl/common/ShaderOutputs.hlsl"
@@ -24,7 +25,7 @@ struct PS_Input
 {
 	float4 pos : SV_POSITION;
 	float3 normal : NORMAL;
-	float3 tangent : TANGENT;
+	float4 tangent : TANGENT;
 	float2 uv : TEXCOORD0;
 	float4 wp : TEXCOORD1;
 	float4 currentPosition : TEXCOORD2;
@@ -38,8 +39,8 @@ PS_Input VSMain(VS_Input vin)
 	vsOut.wp = mul(vin.p, WorldMatrix);
 	vsOut.pos = mul(vsOut.wp, ViewProjectionMatrix);
 	vsOut.uv = vin.uv;
-	vsOut.normal = vin.n;
-	vsOut.tangent = vin.t;
+	vsOut.normal = DecodeVertexNormal(vin.n);
+	vsOut.tangent = float4(DecodeVertexTangent(vin.t), DecodeVertexTangentSign(vin.t));
 	
 	float4 previousWorldPosition = mul(vin.p, PreviousWorldMatrix);
 	vsOut.previousPosition = mul(previousWorldPosition, ViewProjectionMatrix);
@@ -67,8 +68,8 @@ GBufferOutput PSMain(PS_Input pin)
 
 	float3x3 worldMatrix = (float3x3)WorldMatrix;
 	float3 worldNormalT = normalize(mul(pin.normal, worldMatrix));
-	float3 worldTangentT = normalize(mul(pin.tangent, worldMatrix));
-	float3 worldBinormalT = cross(worldNormalT, worldTangentT);
+	float3 worldTangentT = normalize(mul(pin.tangent.xyz, worldMatrix));
+	float3 worldBinormalT = cross(worldNormalT, worldTangentT) * pin.tangent.w;
 	float3x3 tbn = float3x3(worldTangentT, worldBinormalT, worldNormalT);
 	float3 worldNormal = mul(normalTex.xyz, tbn);
 
@@ -1,4 +1,5 @@
 #include "hlsl/common/NormalDecoding.hlsl"
+#include "hlsl/common/VertexDecoding.hlsl"
 #include "hlsl/common/ResourceAccess.hlsl"
 
 float4x4 ViewProjectionMatrix;
@@ -22,7 +23,7 @@ struct VSOutput
 	float2 TexCoords : TEXCOORD0;
 	float4 WorldPos : TEXCOORD1;
 	float3 Normal : TEXCOORD2;
-	float3 Tangent : TEXCOORD3;
+	float4 Tangent : TEXCOORD3;
 };
 
 struct PSInput
@@ -30,7 +31,7 @@ struct PSInput
 	float2 TexCoords : TEXCOORD0;
 	float4 WorldPos : TEXCOORD1;
 	float3 Normal : TEXCOORD2;
-	float3 Tangent : TEXCOORD3;
+	float4 Tangent : TEXCOORD3;
 };
 
 VSOutput VSMain(VSInput IN)
@@ -39,8 +40,8 @@ VSOutput VSMain(VSInput IN)
 	vsOut.WorldPos = mul(IN.position, WorldMatrix);
 	vsOut.position = mul(vsOut.WorldPos, ViewProjectionMatrix);
 	vsOut.TexCoords = IN.texCoord;
-	vsOut.Normal = IN.normal;
-	vsOut.Tangent = IN.tangent;
+	vsOut.Normal = DecodeVertexNormal(IN.normal);
+	vsOut.Tangent = float4(DecodeVertexTangent(IN.tangent), DecodeVertexTangentSign(IN.tangent));
 
 	return vsOut;
 }
@@ -100,9 +101,9 @@ PSOutput PSMain(VSOutput input)
 	float3 cameraView = CameraPosition - input.WorldPos.xyz;
 	float camDistance = length(cameraView);
 
-	float3 T = normalize(mul(input.Tangent, (float3x3) WorldMatrix));
+	float3 T = normalize(mul(input.Tangent.xyz, (float3x3) WorldMatrix));
 	float3 N = normalize(mul(input.Normal, (float3x3) WorldMatrix));
-	float3 B = normalize(cross(N, T));
+	float3 B = normalize(cross(N, T)) * input.Tangent.w;
 	float3x3 TBN_WS = float3x3(T, B, N);
 	float3x3 TBN = transpose(TBN_WS);
 
@@ -1,6 +1,7 @@
 #include "AnisoVoxelConeTracingCommon.hlsl"
 #include "hlsl/sky/SkyParams.hlsl"
 #include "hlsl/common/ResourceAccess.hlsl"
+#include "hlsl/common/VertexDecoding.hlsl"
 
 #ifdef GRID
 #define GRID_PADDING
@@ -89,7 +90,7 @@ GS_Input VSMain(VS_Input vin)
 {
 	GS_Input o;
 	o.wp = mul(vin.p, WorldMatrix).xyz;
-	o.normal  = mul(vin.normal, (float3x3)WorldMatrix);
+	o.normal  = mul(DecodeVertexNormal(vin.normal), (float3x3)WorldMatrix);
 	o.uv = vin.uv;
 
 	return o;